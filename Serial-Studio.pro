@@ -97,6 +97,7 @@ macx* {
 target.path = $$PREFIX/bin
 
 linux:!android {
+    LIBS += -lrt                                         # shm_open() for IO::RingBuffer
     icon.path = $$PREFIX/share/pixmaps                   # icon instalation path
     desktop.path = $$PREFIX/share/applications           # *.desktop instalation path
     icon.files += deploy/linux/serial-studio.png         # Add application icon
@@ -143,14 +144,26 @@ HEADERS += \
     src/AppInfo.h \
     src/CSV/Export.h \
     src/CSV/Player.h \
+    src/IO/Checksum.h \
     src/IO/Console.h \
     src/IO/DataSources/Network.h \
     src/IO/DataSources/Serial.h \
     src/IO/DataSources/File.h \
+    src/IO/Framing.h \
     src/IO/Manager.h \
+    src/IO/Reader.h \
+    src/IO/RingBuffer.h \
+    src/IO/Search.h \
+    src/IO/Source.h \
+    src/IO/SpscQueue.h \
     src/JSON/Dataset.h \
+    src/JSON/DecodingPlan.h \
+    src/JSON/Expression.h \
     src/JSON/Frame.h \
     src/JSON/FrameInfo.h \
+    src/JSON/FrameParser.h \
+    src/JSON/FrameSchema.h \
+    src/JSON/FrameTemplate.h \
     src/JSON/Generator.h \
     src/JSON/Group.h \
     src/Misc/ModuleManager.h \
@@ -159,20 +172,36 @@ HEADERS += \
     src/Misc/Utilities.h \
     src/UI/DataProvider.h \
     src/UI/GraphProvider.h \
+    src/UI/HistoryPyramid.h \
     src/UI/QmlPlainTextEdit.h \
+    src/UI/SampleBuffer.h \
+    src/UI/SampleDecimator.h \
+    src/UI/SeriesUpdater.h \
+    src/UI/SlidingExtrema.h \
     src/UI/WidgetProvider.h
 
 SOURCES += \
     src/CSV/Export.cpp \
     src/CSV/Player.cpp \
+    src/IO/Checksum.cpp \
     src/IO/Console.cpp \
     src/IO/DataSources/Network.cpp \
     src/IO/DataSources/Serial.cpp \
     src/IO/DataSources/File.cpp \
+    src/IO/Framing.cpp \
     src/IO/Manager.cpp \
+    src/IO/Reader.cpp \
+    src/IO/RingBuffer.cpp \
+    src/IO/Search.cpp \
+    src/IO/Source.cpp \
     src/JSON/Dataset.cpp \
+    src/JSON/DecodingPlan.cpp \
+    src/JSON/Expression.cpp \
     src/JSON/Frame.cpp \
     src/JSON/FrameInfo.cpp \
+    src/JSON/FrameParser.cpp \
+    src/JSON/FrameSchema.cpp \
+    src/JSON/FrameTemplate.cpp \
     src/JSON/Generator.cpp \
     src/JSON/Group.cpp \
     src/Misc/ModuleManager.cpp \
@@ -181,6 +210,11 @@ SOURCES += \
     src/Misc/Utilities.cpp \
     src/UI/DataProvider.cpp \
     src/UI/GraphProvider.cpp \
+    src/UI/HistoryPyramid.cpp \
     src/UI/QmlPlainTextEdit.cpp \
+    src/UI/SampleBuffer.cpp \
+    src/UI/SampleDecimator.cpp \
+    src/UI/SeriesUpdater.cpp \
+    src/UI/SlidingExtrema.cpp \
     src/UI/WidgetProvider.cpp \
     src/main.cpp
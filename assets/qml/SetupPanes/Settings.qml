@@ -34,11 +34,92 @@ Control {
     property alias endSequence: _endSequence.text
     property alias language: _langCombo.currentIndex
     property alias startSequence: _startSequence.text
+    property alias overflowPolicy: _overflowCombo.currentIndex
+    property alias frameMode: _frameModeCombo.currentIndex
+    property alias frameHeader: _frameHeader.text
+    property alias lengthFieldSize: _lengthFieldSize.currentIndex
+    property alias lengthFieldBigEndian: _bigEndian.checked
+    property alias idleGap: _idleGap.text
+    property alias ingestMode: _ingestCombo.currentIndex
+    property alias coalescingThreshold: _coalescingThreshold.text
+    property alias latencyBudget: _latencyBudget.text
+    property alias checksumAlgorithm: _checksumCombo.currentIndex
+    property alias checksumPosition: _checksumPosition.currentIndex
+    property alias checksumBigEndian: _checksumBigEndian.checked
+    property alias checksumAsciiHex: _checksumAsciiHex.checked
+    property alias crcWidth: _crcWidth.value
+    property alias crcPolynomial: _crcPolynomial.text
+    property alias crcInit: _crcInit.text
+    property alias crcXorOut: _crcXorOut.text
+    property alias crcReflected: _crcReflected.checked
+    property alias decayingEnvelope: _decayingEnvelope.checked
+
+    //
+    // Additional data sources, stored as a JSON array of source list entries
+    //
+    property string sourceConfig: "[]"
+    onSourceConfigChanged: Cpp_IO_Manager.sourceList = root.configuredSources()
+
+    //
+    // Returns the list of additional data sources as a JavaScript array
+    //
+    function configuredSources() {
+        try {
+            var list = JSON.parse(root.sourceConfig)
+            return Array.isArray(list) ? list : []
+        } catch (e) {
+            return []
+        }
+    }
+
+    //
+    // Adds the data source defined by the "add source" controls to the list
+    //
+    function addSource() {
+        var entry = Cpp_IO_Manager.sourceEntry(_sourceType.currentIndex,
+                                               _sourceAddress.text,
+                                               parseInt(_sourceParameter.text))
+        if (entry.length === 0)
+            return
+
+        var list = root.configuredSources()
+        if (list.indexOf(entry) === -1) {
+            list.push(entry)
+            root.sourceConfig = JSON.stringify(list)
+        }
+
+        _sourceAddress.text = ""
+    }
+
+    //
+    // Removes the data source at the given index of the list
+    //
+    function removeSource(index) {
+        var list = root.configuredSources()
+        list.splice(index, 1)
+        root.sourceConfig = JSON.stringify(list)
+    }
+
+    //
+    // Sends the custom CRC parameters to the manager (only if the custom CRC algorithm
+    // is selected, changing the parameters selects the custom CRC algorithm)
+    //
+    function updateCustomCrc() {
+        if (_checksumCombo.currentIndex !== 8)
+            return
+
+        Cpp_IO_Manager.crcWidth = _crcWidth.value
+        Cpp_IO_Manager.crcPolynomial = _crcPolynomial.text
+        Cpp_IO_Manager.crcInit = _crcInit.text
+        Cpp_IO_Manager.crcXorOut = _crcXorOut.text
+        Cpp_IO_Manager.crcReflected = _crcReflected.checked
+    }
 
     //
     // Layout
     //
     ColumnLayout {
+        id: layout
         anchors.fill: parent
         anchors.margins: app.spacing
 
@@ -46,7 +127,6 @@ Control {
         // Controls
         //
         GridLayout {
-            id: layout
             columns: 2
             Layout.fillWidth: true
             rowSpacing: app.spacing
@@ -64,14 +144,47 @@ Control {
                 onCurrentIndexChanged: Cpp_Misc_Translator.setLanguage(currentIndex)
             }
 
+            //
+            // Graph range mode
+            //
+            Label {
+                text: qsTr("Graph range") + ":"
+            } CheckBox {
+                id: _decayingEnvelope
+                text: qsTr("Shrink range gradually")
+                checked: Cpp_UI_GraphProvider.decayingEnvelope
+                onCheckedChanged: {
+                    if (checked !== Cpp_UI_GraphProvider.decayingEnvelope)
+                        Cpp_UI_GraphProvider.decayingEnvelope = checked
+                }
+            }
+
+            //
+            // Frame detection mode
+            //
+            Label {
+                text: qsTr("Frame mode") + ":"
+            } ComboBox {
+                id: _frameModeCombo
+                Layout.fillWidth: true
+                model: Cpp_IO_Manager.frameModesList()
+                currentIndex: Cpp_IO_Manager.frameMode
+                onCurrentIndexChanged: {
+                    if (currentIndex !== Cpp_IO_Manager.frameMode)
+                        Cpp_IO_Manager.frameMode = currentIndex
+                }
+            }
+
             //
             // Start sequence
             //
             Label {
+                visible: _frameModeCombo.currentIndex === 0
                 text: qsTr("Start sequence") + ": "
             } TextField {
                 id: _startSequence
                 Layout.fillWidth: true
+                visible: _frameModeCombo.currentIndex === 0
                 placeholderText: ""
                 text: "/*"
                 onTextChanged: {
@@ -84,10 +197,12 @@ Control {
             // End sequence
             //
             Label {
+                visible: _frameModeCombo.currentIndex === 0
                 text: qsTr("End sequence") + ": "
             } TextField {
                 id: _endSequence
                 Layout.fillWidth: true
+                visible: _frameModeCombo.currentIndex === 0
                 placeholderText: ""
                 text: "*/"
                 onTextChanged: {
@@ -95,6 +210,425 @@ Control {
                         Cpp_IO_Manager.finishSequence = text
                 }
             }
+
+            //
+            // Length-prefixed frame header
+            //
+            Label {
+                visible: _frameModeCombo.currentIndex === 1
+                text: qsTr("Frame header") + ": "
+            } TextField {
+                id: _frameHeader
+                Layout.fillWidth: true
+                placeholderText: "AA 55"
+                visible: _frameModeCombo.currentIndex === 1
+                onTextChanged: {
+                    if (text !== Cpp_IO_Manager.frameHeader)
+                        Cpp_IO_Manager.frameHeader = text
+                }
+            }
+
+            //
+            // Length field size & byte order
+            //
+            Label {
+                visible: _frameModeCombo.currentIndex === 1
+                text: qsTr("Length field") + ": "
+            } RowLayout {
+                Layout.fillWidth: true
+                spacing: app.spacing
+                visible: _frameModeCombo.currentIndex === 1
+
+                ComboBox {
+                    id: _lengthFieldSize
+                    Layout.fillWidth: true
+                    model: [qsTr("1 byte"), qsTr("2 bytes"), qsTr("3 bytes"), qsTr("4 bytes")]
+                    currentIndex: Cpp_IO_Manager.lengthFieldSize - 1
+                    onCurrentIndexChanged: {
+                        if (currentIndex + 1 !== Cpp_IO_Manager.lengthFieldSize)
+                            Cpp_IO_Manager.lengthFieldSize = currentIndex + 1
+                    }
+                }
+
+                CheckBox {
+                    id: _bigEndian
+                    text: qsTr("Big endian")
+                    checked: Cpp_IO_Manager.lengthFieldBigEndian
+                    onCheckedChanged: {
+                        if (checked !== Cpp_IO_Manager.lengthFieldBigEndian)
+                            Cpp_IO_Manager.lengthFieldBigEndian = checked
+                    }
+                }
+            }
+
+            //
+            // Idle time between frames (0 = calculate from the serial port baud rate)
+            //
+            Label {
+                visible: _frameModeCombo.currentIndex === 4
+                text: qsTr("Idle gap (µs)") + ":"
+            } RowLayout {
+                Layout.fillWidth: true
+                spacing: app.spacing
+                visible: _frameModeCombo.currentIndex === 4
+
+                TextField {
+                    id: _idleGap
+                    text: "0"
+                    Layout.fillWidth: true
+                    placeholderText: qsTr("0 = auto")
+                    validator: IntValidator {
+                        bottom: 0
+                        top: 10000000
+                    }
+
+                    onTextChanged: {
+                        var gap = text.length > 0 ? parseInt(text) : 0
+                        if (gap !== Cpp_IO_Manager.idleGap)
+                            Cpp_IO_Manager.idleGap = gap
+                    }
+                }
+
+                Label {
+                    font.family: app.monoFont
+                    Layout.alignment: Qt.AlignVCenter
+                    text: qsTr("Using %1 µs").arg(Cpp_IO_Manager.effectiveIdleGap)
+                }
+            }
+
+            //
+            // Frame checksum algorithm
+            //
+            Label {
+                text: qsTr("Checksum") + ":"
+            } ComboBox {
+                id: _checksumCombo
+                Layout.fillWidth: true
+                model: Cpp_IO_Manager.checksumAlgorithmsList()
+                currentIndex: Cpp_IO_Manager.checksumAlgorithm
+                onCurrentIndexChanged: {
+                    if (currentIndex !== Cpp_IO_Manager.checksumAlgorithm)
+                        Cpp_IO_Manager.checksumAlgorithm = currentIndex
+
+                    root.updateCustomCrc()
+                }
+            }
+
+            //
+            // Checksum field position & encoding
+            //
+            Label {
+                visible: _checksumCombo.currentIndex !== 0
+                text: qsTr("Checksum field") + ":"
+            } RowLayout {
+                Layout.fillWidth: true
+                spacing: app.spacing
+                visible: _checksumCombo.currentIndex !== 0
+
+                ComboBox {
+                    id: _checksumPosition
+                    Layout.fillWidth: true
+                    model: [qsTr("End of frame"), qsTr("Start of frame")]
+                    currentIndex: Cpp_IO_Manager.checksumPosition
+                    onCurrentIndexChanged: {
+                        if (currentIndex !== Cpp_IO_Manager.checksumPosition)
+                            Cpp_IO_Manager.checksumPosition = currentIndex
+                    }
+                }
+
+                CheckBox {
+                    id: _checksumBigEndian
+                    text: qsTr("Big endian")
+                    checked: Cpp_IO_Manager.checksumBigEndian
+                    onCheckedChanged: {
+                        if (checked !== Cpp_IO_Manager.checksumBigEndian)
+                            Cpp_IO_Manager.checksumBigEndian = checked
+                    }
+                }
+
+                CheckBox {
+                    id: _checksumAsciiHex
+                    text: qsTr("Hex text")
+                    checked: Cpp_IO_Manager.checksumAsciiHex
+                    onCheckedChanged: {
+                        if (checked !== Cpp_IO_Manager.checksumAsciiHex)
+                            Cpp_IO_Manager.checksumAsciiHex = checked
+                    }
+                }
+            }
+
+            //
+            // Custom CRC width & bit order
+            //
+            Label {
+                visible: _checksumCombo.currentIndex === 8
+                text: qsTr("CRC width") + ":"
+            } RowLayout {
+                Layout.fillWidth: true
+                spacing: app.spacing
+                visible: _checksumCombo.currentIndex === 8
+
+                SpinBox {
+                    id: _crcWidth
+                    from: 8
+                    to: 32
+                    value: 16
+                    editable: true
+                    Layout.fillWidth: true
+                    onValueChanged: root.updateCustomCrc()
+                }
+
+                CheckBox {
+                    id: _crcReflected
+                    checked: false
+                    text: qsTr("Reflected")
+                    onCheckedChanged: root.updateCustomCrc()
+                }
+            }
+
+            //
+            // Custom CRC polynomial
+            //
+            Label {
+                visible: _checksumCombo.currentIndex === 8
+                text: qsTr("CRC polynomial") + ":"
+            } TextField {
+                id: _crcPolynomial
+                text: "1021"
+                placeholderText: "1021"
+                Layout.fillWidth: true
+                visible: _checksumCombo.currentIndex === 8
+                onTextChanged: root.updateCustomCrc()
+            }
+
+            //
+            // Custom CRC initial value
+            //
+            Label {
+                visible: _checksumCombo.currentIndex === 8
+                text: qsTr("CRC initial value") + ":"
+            } TextField {
+                id: _crcInit
+                text: "FFFF"
+                placeholderText: "FFFF"
+                Layout.fillWidth: true
+                visible: _checksumCombo.currentIndex === 8
+                onTextChanged: root.updateCustomCrc()
+            }
+
+            //
+            // Custom CRC final XOR value
+            //
+            Label {
+                visible: _checksumCombo.currentIndex === 8
+                text: qsTr("CRC final XOR") + ":"
+            } TextField {
+                id: _crcXorOut
+                text: "0"
+                placeholderText: "0"
+                Layout.fillWidth: true
+                visible: _checksumCombo.currentIndex === 8
+                onTextChanged: root.updateCustomCrc()
+            }
+
+            //
+            // Receive buffer overflow policy
+            //
+            Label {
+                text: qsTr("Buffer overflow") + ":"
+            } ComboBox {
+                id: _overflowCombo
+                Layout.fillWidth: true
+                model: Cpp_IO_Manager.overflowPoliciesList()
+                currentIndex: Cpp_IO_Manager.overflowPolicy
+                onCurrentIndexChanged: {
+                    if (currentIndex !== Cpp_IO_Manager.overflowPolicy)
+                        Cpp_IO_Manager.overflowPolicy = currentIndex
+                }
+            }
+
+            //
+            // Discarded bytes counter
+            //
+            Label {
+                text: qsTr("Discarded bytes") + ":"
+            } Label {
+                Layout.fillWidth: true
+                font.family: app.monoFont
+                text: Cpp_IO_Manager.discardedBytes
+            }
+
+            //
+            // Invalid & dropped frames counters
+            //
+            Label {
+                text: qsTr("Lost frames") + ":"
+            } Label {
+                Layout.fillWidth: true
+                font.family: app.monoFont
+                elide: Label.ElideRight
+                text: qsTr("%1 invalid, %2 dropped").arg(Cpp_IO_Manager.invalidFrames)
+                                                    .arg(Cpp_IO_Manager.droppedFrames)
+            }
+
+            //
+            // Ingest mode (latency/throughput trade-off)
+            //
+            Label {
+                text: qsTr("Ingest mode") + ":"
+            } ComboBox {
+                id: _ingestCombo
+                Layout.fillWidth: true
+                model: Cpp_IO_Manager.ingestModesList()
+                currentIndex: Cpp_IO_Manager.ingestMode
+                onCurrentIndexChanged: {
+                    if (currentIndex !== Cpp_IO_Manager.ingestMode)
+                        Cpp_IO_Manager.ingestMode = currentIndex
+                }
+            }
+
+            //
+            // Coalescing threshold
+            //
+            Label {
+                visible: _ingestCombo.currentIndex === 1
+                text: qsTr("Batch size (bytes)") + ":"
+            } TextField {
+                id: _coalescingThreshold
+                text: "4096"
+                Layout.fillWidth: true
+                visible: _ingestCombo.currentIndex === 1
+                validator: IntValidator {
+                    bottom: 1
+                    top: 16777216
+                }
+
+                onTextChanged: {
+                    if (text.length > 0 && parseInt(text) !== Cpp_IO_Manager.coalescingThreshold)
+                        Cpp_IO_Manager.coalescingThreshold = parseInt(text)
+                }
+            }
+
+            //
+            // Latency budget
+            //
+            Label {
+                visible: _ingestCombo.currentIndex === 1
+                text: qsTr("Latency budget (µs)") + ":"
+            } TextField {
+                id: _latencyBudget
+                text: "2000"
+                Layout.fillWidth: true
+                visible: _ingestCombo.currentIndex === 1
+                validator: IntValidator {
+                    bottom: 1
+                    top: 10000000
+                }
+
+                onTextChanged: {
+                    if (text.length > 0 && parseInt(text) !== Cpp_IO_Manager.latencyBudget)
+                        Cpp_IO_Manager.latencyBudget = parseInt(text)
+                }
+            }
+
+            //
+            // Reader statistics
+            //
+            Label {
+                text: qsTr("Reader load") + ":"
+            } Label {
+                Layout.fillWidth: true
+                font.family: app.monoFont
+                elide: Label.ElideRight
+                text: qsTr("%1 events/s, %2 reads/s, %3 frames/s")
+                        .arg(Cpp_IO_Manager.readEventsPerSecond)
+                        .arg(Cpp_IO_Manager.deviceReadsPerSecond)
+                        .arg(Cpp_IO_Manager.framesPerSecond)
+            }
+        }
+
+        //
+        // Additional data sources
+        //
+        Label {
+            font.bold: true
+            Layout.topMargin: app.spacing
+            text: qsTr("Additional data sources") + ":"
+        }
+
+        Repeater {
+            model: Cpp_IO_Manager.sourceList
+            delegate: RowLayout {
+                Layout.fillWidth: true
+                spacing: app.spacing
+
+                Label {
+                    text: modelData
+                    Layout.fillWidth: true
+                    elide: Label.ElideMiddle
+                    font.family: app.monoFont
+                    Layout.alignment: Qt.AlignVCenter
+                }
+
+                Button {
+                    icon.color: palette.text
+                    Layout.maximumWidth: height
+                    Layout.alignment: Qt.AlignVCenter
+                    icon.source: "qrc:/icons/delete.svg"
+                    onClicked: root.removeSource(index)
+                }
+            }
+        }
+
+        RowLayout {
+            Layout.fillWidth: true
+            spacing: app.spacing / 2
+
+            ComboBox {
+                id: _sourceType
+                Layout.alignment: Qt.AlignVCenter
+                model: Cpp_IO_Manager.sourceTypesList()
+            }
+
+            TextField {
+                id: _sourceAddress
+                Layout.fillWidth: true
+                Layout.alignment: Qt.AlignVCenter
+                onAccepted: root.addSource()
+                placeholderText: {
+                    switch (_sourceType.currentIndex) {
+                    case 0:
+                        return qsTr("Port name")
+                    case 3:
+                        return qsTr("File path")
+                    default:
+                        return qsTr("Host")
+                    }
+                }
+            }
+
+            TextField {
+                id: _sourceParameter
+                Layout.maximumWidth: 80
+                Layout.alignment: Qt.AlignVCenter
+                visible: _sourceType.currentIndex !== 3
+                onAccepted: root.addSource()
+                placeholderText: _sourceType.currentIndex === 0 ? qsTr("Baud rate") :
+                                                                  qsTr("Port")
+                validator: IntValidator {
+                    bottom: 1
+                    top: _sourceType.currentIndex === 0 ? 100000000 : 65535
+                }
+            }
+
+            Button {
+                icon.color: palette.text
+                Layout.maximumWidth: height
+                Layout.alignment: Qt.AlignVCenter
+                icon.source: "qrc:/icons/link.svg"
+                onClicked: root.addSource()
+                enabled: _sourceAddress.text.length > 0
+            }
         }
 
         //
@@ -30,6 +30,11 @@ Window {
 
     property int graphId: -1
 
+    // History view (zoom with mouse wheel, scroll by dragging, double click to go back)
+    property bool historyMode: false
+    property real historyEnd: 0
+    property real historySpan: 0
+
     spacing: -1
     showIcon: false
     visible: opacity > 0
@@ -48,6 +53,12 @@ Window {
             if (!root.enabled)
                 return
 
+            // Draw history of the session
+            if (root.historyMode) {
+                root.drawHistory()
+                return
+            }
+
             // Get min/max values
             var point = Cpp_UI_GraphProvider.graphRange(graphId)
             var min = point.x
@@ -61,9 +72,39 @@ Window {
 
             // Draw graph
             Cpp_UI_GraphProvider.updateGraph(series, graphId)
+
+            // Move time axis to follow the displayed points
+            var range = Cpp_UI_GraphProvider.timeRange(graphId)
+            if (timeAxis.min !== range.x)
+                timeAxis.min = range.x
+            if (timeAxis.max !== range.y)
+                timeAxis.max = range.y
         }
     }
 
+    function enterHistoryMode() {
+        if (!root.historyMode) {
+            root.historyEnd = Cpp_UI_GraphProvider.historyLength(graphId)
+            root.historySpan = Cpp_UI_GraphProvider.displayedPoints
+            root.historyMode = true
+        }
+    }
+
+    function drawHistory() {
+        // Keep the view inside the stored history
+        var length = Cpp_UI_GraphProvider.historyLength(graphId)
+        root.historySpan = Math.max(10, Math.min(root.historySpan, length))
+        root.historyEnd = Math.max(root.historySpan, Math.min(root.historyEnd, length))
+
+        // Draw graph & update axes
+        var from = root.historyEnd - root.historySpan
+        var range = Cpp_UI_GraphProvider.updateHistory(series, graphId, from, root.historyEnd)
+        timeAxis.min = from
+        timeAxis.max = root.historyEnd
+        positionAxis.min = range.x
+        positionAxis.max = range.y
+    }
+
     ChartView {
         antialiasing: true
         anchors.fill: parent
@@ -83,13 +124,13 @@ Window {
         ValueAxis {
             id: timeAxis
             min: 0
+            max: 10
             labelFormat: " "
             lineVisible: false
             labelsVisible: false
             gridLineColor: "#517497"
             tickType: ValueAxis.TicksFixed
             labelsFont.family: app.monoFont
-            max: Cpp_UI_GraphProvider.displayedPoints
         }
 
         ValueAxis {
@@ -103,6 +144,28 @@ Window {
             labelsFont.family: app.monoFont
         }
 
+        MouseArea {
+            property real lastX: 0
+
+            anchors.fill: parent
+
+            onPressed: lastX = mouse.x
+            onDoubleClicked: root.historyMode = false
+
+            onWheel: {
+                root.enterHistoryMode()
+                root.historySpan *= wheel.angleDelta.y > 0 ? 0.8 : 1.25
+                root.drawHistory()
+            }
+
+            onPositionChanged: {
+                root.enterHistoryMode()
+                root.historyEnd -= (mouse.x - lastX) * root.historySpan / Math.max(1, width)
+                lastX = mouse.x
+                root.drawHistory()
+            }
+        }
+
         LineSeries {
             id: series
             width: 2
@@ -323,6 +323,14 @@ Control {
                 Layout.fillWidth: true
             }
 
+            Label {
+                color: "#e41a1c"
+                font.family: app.monoFont
+                Layout.alignment: Qt.AlignVCenter
+                visible: Cpp_IO_Manager.droppedChunks > 0
+                text: qsTr("%1 chunks dropped").arg(Cpp_IO_Manager.droppedChunks)
+            }
+
             ComboBox {
                 id: lineEndingCombo
                 Layout.alignment: Qt.AlignVCenter
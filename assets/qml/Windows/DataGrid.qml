@@ -581,6 +581,21 @@ Control {
             }
 
             Label {
+                font.family: app.monoFont
+                color: palette.brightText
+                visible: !Cpp_CSV_Player.isOpen && Cpp_IO_Manager.checksumAlgorithm !== 0
+                text: qsTr("%1 frames OK, %2 failed").arg(Cpp_IO_Manager.passedFrames)
+                                                      .arg(Cpp_IO_Manager.failedFrames)
+
+                anchors {
+                    right: _rxBytes.left
+                    rightMargin: app.spacing * 2
+                    verticalCenter: parent.verticalCenter
+                }
+            }
+
+            Label {
+                id: _rxBytes
                 font.family: app.monoFont
                 color: palette.brightText
                 visible: !Cpp_CSV_Player.isOpen
@@ -76,6 +76,26 @@ Control {
         property alias language: settings.language
         property alias endSequence: settings.endSequence
         property alias startSequence: settings.startSequence
+        property alias overflowPolicy: settings.overflowPolicy
+        property alias frameMode: settings.frameMode
+        property alias frameHeader: settings.frameHeader
+        property alias lengthFieldSize: settings.lengthFieldSize
+        property alias lengthFieldBigEndian: settings.lengthFieldBigEndian
+        property alias idleGap: settings.idleGap
+        property alias ingestMode: settings.ingestMode
+        property alias coalescingThreshold: settings.coalescingThreshold
+        property alias latencyBudget: settings.latencyBudget
+        property alias checksumAlgorithm: settings.checksumAlgorithm
+        property alias checksumPosition: settings.checksumPosition
+        property alias checksumBigEndian: settings.checksumBigEndian
+        property alias checksumAsciiHex: settings.checksumAsciiHex
+        property alias crcWidth: settings.crcWidth
+        property alias crcPolynomial: settings.crcPolynomial
+        property alias crcInit: settings.crcInit
+        property alias crcXorOut: settings.crcXorOut
+        property alias crcReflected: settings.crcReflected
+        property alias decayingEnvelope: settings.decayingEnvelope
+        property alias sourceList: settings.sourceConfig
     }
 
     //
@@ -309,6 +329,7 @@ Control {
 
             SetupPanes.Settings {
                 id: settings
+                onImplicitHeightChanged: stack.getImplicitHeight()
                 background: TextField {
                     enabled: false
                     palette.base: "#16232a"
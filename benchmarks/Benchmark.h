@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <QtTest>
+#include <QElapsedTimer>
+
+/**
+ * Helper functions shared by the benchmarks of the performance-sensitive modules of
+ * Serial Studio.
+ *
+ * @c QBENCHMARK only reports the time spent in each iteration, the functions of this
+ * namespace report the throughput (e.g. bytes or frames per second) instead, which is
+ * easier to compare against the data rate of a device.
+ */
+namespace Benchmark
+{
+/**
+ * Minimum time (in milliseconds) during which each benchmark is executed
+ */
+static const qint64 MIN_DURATION = 500;
+
+/**
+ * Calls @a function repeatedly for (at least) @c MIN_DURATION milliseconds & reports
+ * the number of @a units that are processed per second by each call (e.g. bytes or
+ * frames) as the result of the current benchmark, using the given @a metric.
+ *
+ * @return The number of units processed per second
+ */
+template<typename Function>
+double throughput(Function function, const double units,
+                  const QTest::QBenchmarkMetric metric)
+{
+    // Warm up caches & lazily initialized data
+    function();
+
+    // Run the function until the minimum duration is reached
+    qint64 iterations = 0;
+    QElapsedTimer timer;
+    timer.start();
+    do
+    {
+        function();
+        ++iterations;
+    } while (timer.elapsed() < MIN_DURATION);
+
+    // Calculate & report the throughput
+    const auto seconds = static_cast<double>(timer.nsecsElapsed()) / 1e9;
+    const auto result = units * static_cast<double>(iterations) / seconds;
+    QTest::setBenchmarkResult(result, metric);
+
+    // Log a human-readable value
+    const auto tag = QTest::currentDataTag() ? QTest::currentDataTag() : "";
+    if (metric == QTest::BytesPerSecond)
+        qInfo("%s: %.1f MB/s", tag, result / (1024 * 1024));
+    else if (metric == QTest::FramesPerSecond)
+        qInfo("%s: %.0f frames/s", tag, result);
+    else
+        qInfo("%s: %.0f per second", tag, result);
+
+    return result;
+}
+}
+
+#endif
@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ChecksumBenchmark.h"
+#include "Benchmark.h"
+
+#include <IO/Checksum.h>
+#include <QRandomGenerator>
+
+/*
+ * Size of the buffer that is split into frames
+ */
+static const int BUFFER_SIZE = 1024 * 1024;
+
+/*
+ * Input used to obtain the check values of the CRC catalogues
+ */
+static const char CHECK_INPUT[] = "123456789";
+
+/**
+ * Reverses the lower @a width bits of the given @a value
+ */
+static quint32 REFLECT(const quint32 value, const int width)
+{
+    quint32 result = 0;
+    for (int i = 0; i < width; ++i)
+    {
+        if (value & (1u << i))
+            result |= 1u << (width - 1 - i);
+    }
+
+    return result;
+}
+
+/**
+ * Calculates the checksum of the given @a data with the algorithm of the given
+ * @a checksum, processing one bit (or one byte) at a time. Used to validate the
+ * optimized implementations.
+ */
+static quint32 REFERENCE(const IO::Checksum &checksum, const char *data, const int length)
+{
+    const auto bytes = reinterpret_cast<const quint8 *>(data);
+
+    // XOR of all bytes
+    if (checksum.algorithm() == IO::Checksum::Algorithm::XOR8)
+    {
+        quint32 value = 0;
+        for (int i = 0; i < length; ++i)
+            value ^= bytes[i];
+
+        return value;
+    }
+
+    // Fletcher-16, modulo after each byte
+    if (checksum.algorithm() == IO::Checksum::Algorithm::Fletcher16)
+    {
+        quint32 sum1 = 0;
+        quint32 sum2 = 0;
+        for (int i = 0; i < length; ++i)
+        {
+            sum1 = (sum1 + bytes[i]) % 255;
+            sum2 = (sum2 + sum1) % 255;
+        }
+
+        return (sum2 << 8) | sum1;
+    }
+
+    // Bitwise CRC (Rocksoft model)
+    const auto p = checksum.crcParameters();
+    const auto top = 1u << (p.width - 1);
+    const auto mask = p.width == 32 ? 0xFFFFFFFFu : (1u << p.width) - 1;
+    auto crc = p.init & mask;
+    for (int i = 0; i < length; ++i)
+    {
+        const auto byte = p.reflected ? REFLECT(bytes[i], 8) : bytes[i];
+        crc ^= byte << (p.width - 8);
+        for (int bit = 0; bit < 8; ++bit)
+            crc = ((crc & top) ? (crc << 1) ^ p.polynomial : crc << 1) & mask;
+    }
+
+    if (p.reflected)
+        crc = REFLECT(crc, p.width);
+
+    return (crc ^ p.xorOut) & mask;
+}
+
+/**
+ * Combines the checksum of a frame with the checksums of the previous frames, so that
+ * the result depends on every frame & on their order
+ */
+static inline quint32 COMBINE(const quint32 result, const quint32 checksum)
+{
+    return ((result << 1) | (result >> 31)) ^ checksum;
+}
+
+/**
+ * Logs the CRC-32C implementation selected for the CPU
+ */
+void ChecksumBenchmark::initTestCase()
+{
+    qInfo("CRC-32C kernel: %s", IO::Checksum::crc32cKernelName());
+}
+
+/**
+ * Registers a row for each algorithm & frame size, along with the CRC of the string
+ * "123456789" given by the CRC catalogues (or calculated by hand for XOR-8 &
+ * Fletcher-16).
+ */
+void ChecksumBenchmark::compute_data()
+{
+    QTest::addColumn<int>("algorithm");
+    QTest::addColumn<int>("frameSize");
+    QTest::addColumn<uint>("check");
+    QTest::addColumn<QByteArray>("buffer");
+
+    // Generate random data
+    QByteArray buffer(BUFFER_SIZE, '\x00');
+    QRandomGenerator generator(BUFFER_SIZE);
+    for (int i = 0; i < buffer.size(); ++i)
+        buffer[i] = static_cast<char>(generator.bounded(256));
+
+    // Algorithms & check values
+    typedef IO::Checksum::Algorithm Algorithm;
+    struct Entry
+    {
+        Algorithm algorithm;
+        const char *name;
+        uint check;
+    };
+    const QList<Entry> entries = {{Algorithm::XOR8, "XOR-8", 0x31},
+                                  {Algorithm::CRC8, "CRC-8", 0xF4},
+                                  {Algorithm::CRC16_MODBUS, "CRC-16/MODBUS", 0x4B37},
+                                  {Algorithm::CRC16_CCITT, "CRC-16/CCITT", 0x29B1},
+                                  {Algorithm::CRC32, "CRC-32", 0xCBF43926},
+                                  {Algorithm::CRC32C, "CRC-32C", 0xE3069283},
+                                  {Algorithm::Fletcher16, "Fletcher-16", 0x1EDE}};
+
+    // Register rows
+    const QList<int> frameSizes = {16, 256, 4096};
+    for (const auto &entry : entries)
+    {
+        for (const auto frameSize : frameSizes)
+        {
+            const auto tag = QString("%1, %2 B frames").arg(entry.name).arg(frameSize);
+            QTest::newRow(tag.toUtf8().constData())
+                << static_cast<int>(entry.algorithm) << frameSize << entry.check
+                << buffer;
+        }
+    }
+}
+
+/**
+ * Measures the throughput of the current algorithm when calculating the checksum of
+ * each frame of the buffer
+ */
+void ChecksumBenchmark::compute()
+{
+    QFETCH(int, algorithm);
+    QFETCH(int, frameSize);
+    QFETCH(uint, check);
+    QFETCH(QByteArray, buffer);
+
+    // Configure the algorithm & validate it with the check value
+    IO::Checksum checksum;
+    checksum.setAlgorithm(static_cast<IO::Checksum::Algorithm>(algorithm));
+    QCOMPARE(checksum.compute(CHECK_INPUT, 9), static_cast<quint32>(check));
+    QCOMPARE(REFERENCE(checksum, CHECK_INPUT, 9), static_cast<quint32>(check));
+
+    // Calculate the checksum of each frame
+    const auto data = buffer.constData();
+    const auto frames = buffer.size() / frameSize;
+    quint32 result = 0;
+    const auto function = [&] {
+        result = 0;
+        for (int i = 0; i < frames; ++i)
+            result = COMBINE(result, checksum.compute(data + i * frameSize, frameSize));
+    };
+
+    // Run the benchmark & compare the result with the reference implementation
+    Benchmark::throughput(function, frames * frameSize, QTest::BytesPerSecond);
+
+    quint32 expected = 0;
+    for (int i = 0; i < frames; ++i)
+    {
+        const auto frame = data + i * frameSize;
+        expected = COMBINE(expected, REFERENCE(checksum, frame, frameSize));
+    }
+
+    QCOMPARE(result, expected);
+}
@@ -0,0 +1,210 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "FrameParserBenchmark.h"
+#include "Benchmark.h"
+
+#include <QJsonDocument>
+#include <JSON/FrameParser.h>
+
+/*
+ * Structure of the generated frames (about 2 KB each)
+ */
+static const int GROUP_COUNT = 4;
+static const int DATASET_COUNT = 8;
+
+/*
+ * Number of frames that are parsed by each iteration of the benchmarks
+ */
+static const int FRAME_COUNT = 200;
+
+/**
+ * Generates an auto mode frame with the same structure for every @a frame number,
+ * the dataset values change with each frame. Values are written as JSON numbers if
+ * @a numeric is set, or as JSON strings otherwise.
+ */
+static QByteArray GENERATE_FRAME(const int frame, const bool numeric)
+{
+    QByteArray json = "{\"t\":\"Benchmark\",\"g\":[";
+    for (int g = 0; g < GROUP_COUNT; ++g)
+    {
+        if (g > 0)
+            json.append(',');
+
+        json.append("{\"t\":\"Group " + QByteArray::number(g + 1));
+        json.append("\",\"w\":\"\",\"d\":[");
+        for (int d = 0; d < DATASET_COUNT; ++d)
+        {
+            if (d > 0)
+                json.append(',');
+
+            const auto n = (frame * 31 + g * 7 + d * 3) % 1000;
+            auto value = QByteArray::number(n * 0.0625 - 20, 'f', 4);
+            if (!numeric)
+                value = "\"" + value + "\"";
+
+            json.append("{\"t\":\"Channel " + QByteArray::number(d + 1));
+            json.append("\",\"v\":" + value);
+            if (d == 0)
+                json.append(",\"x\":" + QByteArray::number(frame));
+
+            json.append(",\"u\":\"mV\",\"g\":true,\"w\":\"\"}");
+        }
+
+        json.append("]}");
+    }
+
+    json.append("]}");
+    return json;
+}
+
+/**
+ * Parses a frame in the same way as the JSON worker did before the frame parser was
+ * introduced, the @a schema of the previous frame is reused if the structure did not
+ * change.
+ */
+static void READ_DOCUMENT(const QByteArray &frame, QVector<JSON::FrameValue> *values,
+                          JSON::FrameSchemaPtr *schema)
+{
+    const auto document = QJsonDocument::fromJson(frame);
+    const auto result = JSON::FrameSchema::read(document.object(), values, *schema);
+    if (result)
+        *schema = result;
+}
+
+/**
+ * Registers the frames used by the @c frameParser() benchmark
+ */
+void FrameParserBenchmark::frameParser_data()
+{
+    addRows();
+}
+
+/**
+ * Measures the number of frames per second parsed with the @c JSON::FrameParser class
+ */
+void FrameParserBenchmark::frameParser()
+{
+    QFETCH(QVector<QByteArray>, frames);
+
+    JSON::FrameParser parser;
+    QVector<JSON::FrameValue> values;
+    const auto function = [&] {
+        for (const auto &frame : frames)
+            parser.read(frame, &values);
+    };
+
+    Benchmark::throughput(function, frames.count(), QTest::FramesPerSecond);
+    QCOMPARE(values.count(), GROUP_COUNT * DATASET_COUNT);
+}
+
+/**
+ * Registers the frames used by the @c jsonDocument() benchmark
+ */
+void FrameParserBenchmark::jsonDocument_data()
+{
+    addRows();
+}
+
+/**
+ * Measures the number of frames per second parsed with @c QJsonDocument::fromJson()
+ * & @c JSON::FrameSchema::read()
+ */
+void FrameParserBenchmark::jsonDocument()
+{
+    QFETCH(QVector<QByteArray>, frames);
+
+    JSON::FrameSchemaPtr schema;
+    QVector<JSON::FrameValue> values;
+    const auto function = [&] {
+        for (const auto &frame : frames)
+            READ_DOCUMENT(frame, &values, &schema);
+    };
+
+    Benchmark::throughput(function, frames.count(), QTest::FramesPerSecond);
+    QCOMPARE(values.count(), GROUP_COUNT * DATASET_COUNT);
+}
+
+/**
+ * Registers the frames used by the @c compare() test
+ */
+void FrameParserBenchmark::compare_data()
+{
+    addRows();
+}
+
+/**
+ * Checks that the frame parser (which only uses its fast path after the first frame)
+ * generates the same schemas & the same values as the JSON document parser
+ */
+void FrameParserBenchmark::compare()
+{
+    QFETCH(QVector<QByteArray>, frames);
+
+    JSON::FrameParser parser;
+    JSON::FrameSchemaPtr schema;
+    JSON::FrameSchemaPtr previous;
+    for (const auto &frame : frames)
+    {
+        // Parse the frame with both implementations
+        QVector<JSON::FrameValue> values;
+        QVector<JSON::FrameValue> expected;
+        const auto result = parser.read(frame, &values);
+        READ_DOCUMENT(frame, &expected, &schema);
+
+        // Compare schemas, the schema must be reused after the first frame
+        QVERIFY(result);
+        QVERIFY(schema);
+        QVERIFY(*result == *schema);
+        QVERIFY(!previous || result == previous);
+        previous = result;
+
+        // Compare values
+        QCOMPARE(values.count(), expected.count());
+        for (int i = 0; i < values.count(); ++i)
+        {
+            QCOMPARE(values.at(i).text, expected.at(i).text);
+            QVERIFY(values.at(i).number == expected.at(i).number);
+            QVERIFY(values.at(i).tick == expected.at(i).tick);
+        }
+    }
+}
+
+/**
+ * Adds a row with @c FRAME_COUNT frames with numeric values & a row with
+ * @c FRAME_COUNT frames with string values
+ */
+void FrameParserBenchmark::addRows()
+{
+    QTest::addColumn<QVector<QByteArray>>("frames");
+
+    QVector<QByteArray> numbers;
+    QVector<QByteArray> strings;
+    for (int i = 0; i < FRAME_COUNT; ++i)
+    {
+        numbers.append(GENERATE_FRAME(i, true));
+        strings.append(GENERATE_FRAME(i, false));
+    }
+
+    QTest::newRow("2 KB frames, numeric values") << numbers;
+    QTest::newRow("2 KB frames, string values") << strings;
+}
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef FRAME_PARSER_BENCHMARK_H
+#define FRAME_PARSER_BENCHMARK_H
+
+#include <QObject>
+
+/**
+ * Compares the number of auto mode frames per second that can be parsed by the
+ * @c JSON::FrameParser class against the former approach (@c QJsonDocument::fromJson()
+ * followed by @c JSON::FrameSchema::read()) using 2 KB frames, and checks that both
+ * approaches generate identical schemas & values.
+ */
+class FrameParserBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void frameParser_data();
+    void frameParser();
+    void jsonDocument_data();
+    void jsonDocument();
+    void compare_data();
+    void compare();
+
+private:
+    void addRows();
+};
+
+#endif
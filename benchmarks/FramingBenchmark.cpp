@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "FramingBenchmark.h"
+#include "Benchmark.h"
+
+#include <cstring>
+#include <IO/Search.h>
+#include <IO/Framing.h>
+#include <QRandomGenerator>
+
+/*
+ * Framing modes that are benchmarked
+ */
+enum FramingMode
+{
+    kLengthPrefixed,
+    kCOBS,
+    kSLIP
+};
+
+/*
+ * Minimum size of the encoded streams
+ */
+static const int STREAM_SIZE = 1024 * 1024;
+
+/*
+ * Header of the length-prefixed frames, followed by a big-endian length field
+ */
+static const char LENGTH_HEADER[] = "\xAA\x55";
+static const int LENGTH_HEADER_SIZE = 2;
+static const int LENGTH_FIELD_SIZE = 2;
+
+/**
+ * Returns the given @a payload with a header & a 16-bit big-endian length field
+ */
+static QByteArray LENGTH_PREFIX_ENCODE(const QByteArray &payload)
+{
+    QByteArray frame(LENGTH_HEADER, LENGTH_HEADER_SIZE);
+    frame.append(static_cast<char>((payload.size() >> 8) & 0xFF));
+    frame.append(static_cast<char>(payload.size() & 0xFF));
+    frame.append(payload);
+    return frame;
+}
+
+/**
+ * Returns the COBS-encoded @a payload, followed by the zero delimiter
+ */
+static QByteArray COBS_ENCODE(const QByteArray &payload)
+{
+    QByteArray frame;
+    int codeIndex = 0;
+    quint8 code = 1;
+
+    frame.append('\x00');
+    for (const auto c : payload)
+    {
+        if (c != IO::Framing::COBS_DELIMITER)
+        {
+            frame.append(c);
+            ++code;
+        }
+
+        if (c == IO::Framing::COBS_DELIMITER || code == 0xFF)
+        {
+            frame[codeIndex] = static_cast<char>(code);
+            codeIndex = frame.size();
+            frame.append('\x00');
+            code = 1;
+        }
+    }
+
+    frame[codeIndex] = static_cast<char>(code);
+    frame.append(IO::Framing::COBS_DELIMITER);
+    return frame;
+}
+
+/**
+ * Returns the SLIP-encoded @a payload, followed by the END delimiter
+ */
+static QByteArray SLIP_ENCODE(const QByteArray &payload)
+{
+    QByteArray frame;
+    for (const auto c : payload)
+    {
+        if (c == IO::Framing::SLIP_END)
+        {
+            frame.append(IO::Framing::SLIP_ESC);
+            frame.append(IO::Framing::SLIP_ESC_END);
+        }
+
+        else if (c == IO::Framing::SLIP_ESC)
+        {
+            frame.append(IO::Framing::SLIP_ESC);
+            frame.append(IO::Framing::SLIP_ESC_ESC);
+        }
+
+        else
+            frame.append(c);
+    }
+
+    frame.append(IO::Framing::SLIP_END);
+    return frame;
+}
+
+/**
+ * Reads every length-prefixed frame of the given @a stream & copies its payload to the
+ * @a output buffer.
+ *
+ * @returns the number of bytes written to @a output
+ */
+static int DECODE_LENGTH_PREFIXED(const QByteArray &stream, char *output)
+{
+    int written = 0;
+    int position = 0;
+    const auto data = stream.constData();
+    const auto size = stream.size();
+
+    forever
+    {
+        // Find the header
+        const auto header = IO::Search::indexOf(data, size, LENGTH_HEADER,
+                                                LENGTH_HEADER_SIZE, position);
+        if (header < 0)
+            break;
+
+        // Read the length field
+        const auto field = header + LENGTH_HEADER_SIZE;
+        if (size - field < LENGTH_FIELD_SIZE)
+            break;
+
+        const auto length = static_cast<int>(
+            IO::Framing::readLength(data + field, LENGTH_FIELD_SIZE, true));
+
+        // Copy the payload
+        const auto payload = field + LENGTH_FIELD_SIZE;
+        if (size - payload < length)
+            break;
+
+        memcpy(output + written, data + payload, static_cast<size_t>(length));
+        written += length;
+        position = payload + length;
+    }
+
+    return written;
+}
+
+/**
+ * Decodes every COBS or SLIP frame of the given @a stream into the @a output buffer.
+ *
+ * @returns the number of bytes written to @a output
+ */
+static int DECODE_ENCODED(const QByteArray &stream, const bool cobs, char *output)
+{
+    int written = 0;
+    int position = 0;
+    const auto data = stream.constData();
+    const auto size = stream.size();
+    const auto delimiter = cobs ? IO::Framing::COBS_DELIMITER : IO::Framing::SLIP_END;
+
+    forever
+    {
+        // Find the end of the frame
+        const auto index = IO::Search::indexOf(data, size, &delimiter, 1, position);
+        if (index < 0)
+            break;
+
+        // Decode the frame
+        const auto length = index - position;
+        if (length > 0)
+        {
+            const auto input = data + position;
+            const auto decoded
+                = cobs ? IO::Framing::cobsDecode(input, length, output + written)
+                       : IO::Framing::slipDecode(input, length, output + written);
+
+            if (decoded > 0)
+                written += decoded;
+        }
+
+        position = index + 1;
+    }
+
+    return written;
+}
+
+/**
+ * Registers a row for each framing mode & payload size. Payloads contain random bytes,
+ * so that they include zeros, SLIP control bytes & false frame headers.
+ */
+void FramingBenchmark::decode_data()
+{
+    QTest::addColumn<int>("mode");
+    QTest::addColumn<QByteArray>("stream");
+    QTest::addColumn<QByteArray>("expected");
+
+    const QList<int> payloadSizes = {32, 256, 1024};
+    const QList<QPair<int, QString>> modes = {{kLengthPrefixed, "Length-prefixed"},
+                                              {kCOBS, "COBS"},
+                                              {kSLIP, "SLIP"}};
+
+    for (const auto &mode : modes)
+    {
+        for (const auto payloadSize : payloadSizes)
+        {
+            // Generate frames until the stream is full
+            QByteArray stream;
+            QByteArray expected;
+            QRandomGenerator generator(static_cast<quint32>(payloadSize));
+            while (stream.size() < STREAM_SIZE)
+            {
+                QByteArray payload(payloadSize, '\x00');
+                for (int i = 0; i < payloadSize; ++i)
+                    payload[i] = static_cast<char>(generator.bounded(256));
+
+                if (mode.first == kLengthPrefixed)
+                    stream.append(LENGTH_PREFIX_ENCODE(payload));
+                else if (mode.first == kCOBS)
+                    stream.append(COBS_ENCODE(payload));
+                else
+                    stream.append(SLIP_ENCODE(payload));
+
+                expected.append(payload);
+            }
+
+            // Register the row
+            const auto tag = QString("%1, %2 B frames").arg(mode.second).arg(payloadSize);
+            QTest::newRow(tag.toUtf8().constData()) << mode.first << stream << expected;
+        }
+    }
+}
+
+/**
+ * Measures the decoding throughput of the current framing mode
+ */
+void FramingBenchmark::decode()
+{
+    QFETCH(int, mode);
+    QFETCH(QByteArray, stream);
+    QFETCH(QByteArray, expected);
+
+    // Decoded data is never larger than the encoded data
+    int written = 0;
+    QByteArray output(stream.size(), '\x00');
+    const auto function = [&] {
+        if (mode == kLengthPrefixed)
+            written = DECODE_LENGTH_PREFIXED(stream, output.data());
+        else
+            written = DECODE_ENCODED(stream, mode == kCOBS, output.data());
+    };
+
+    // Run the benchmark & validate the decoded data
+    Benchmark::throughput(function, stream.size(), QTest::BytesPerSecond);
+    output.truncate(written);
+    QCOMPARE(output, expected);
+}
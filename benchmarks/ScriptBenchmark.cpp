@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "ScriptBenchmark.h"
+#include "Benchmark.h"
+
+#include <QFile>
+#include <QJSEngine>
+#include <QJsonObject>
+#include <QJsonDocument>
+
+/*
+ * Number of lines that are parsed by each iteration of the benchmarks
+ */
+static const int LINE_COUNT = 100;
+
+/**
+ * Calls the parser @a function with the given @a line & returns the generated frame,
+ * in the same way as the @c JSONWorker class.
+ */
+static QJsonDocument PARSE(QJSValue &function, const QString &line)
+{
+    QJSValueList args;
+    args << line;
+    auto result = function.call(args);
+    if (result.isError())
+        return QJsonDocument();
+
+    return QJsonDocument::fromVariant(result.toVariant());
+}
+
+/**
+ * Loads the example parser script & generates the lines that are parsed by the
+ * benchmarks (using every data type handled by the script).
+ */
+void ScriptBenchmark::initTestCase()
+{
+    QFile file(EXAMPLE_PARSER);
+    QVERIFY(file.open(QFile::ReadOnly));
+    m_script = QString::fromUtf8(file.readAll());
+
+    const QStringList samples = {"110 freq 50.01", "111 dcvolt 12.47",
+                                 "112 temp 25.5",  "113 ptx -3.2",
+                                 "114 state IDLE", "115 rxdata 01 72 73"};
+
+    m_lines.clear();
+    for (int i = 0; i < LINE_COUNT; ++i)
+        m_lines.append(QString("[2020-10-18 09:01:50.%1] %2")
+                           .arg(i % 1000, 3, 10, QChar('0'))
+                           .arg(samples.at(i % samples.count())));
+}
+
+/**
+ * Measures the former script path: a new JS engine is created for each frame, the
+ * script is evaluated & the resulting function is called with the frame.
+ */
+void ScriptBenchmark::perFrameEngine()
+{
+    QVector<QJsonDocument> frames(m_lines.count());
+    const auto function = [&] {
+        for (int i = 0; i < m_lines.count(); ++i)
+        {
+            QJSEngine engine;
+            auto parser = engine.evaluate(m_script);
+            frames[i] = PARSE(parser, m_lines.at(i));
+        }
+    };
+
+    Benchmark::throughput(function, m_lines.count(), QTest::FramesPerSecond);
+    QVERIFY(frames.first().object().contains("g"));
+}
+
+/**
+ * Measures the current script path: the script is compiled once into a persistent JS
+ * engine & the resulting function is called for each frame. The generated frames
+ * must be identical to the frames generated with a new engine for each frame.
+ */
+void ScriptBenchmark::persistentEngine()
+{
+    QJSEngine engine;
+    auto parser = engine.evaluate(m_script);
+    QVERIFY(parser.isCallable());
+
+    QVector<QJsonDocument> frames(m_lines.count());
+    const auto function = [&] {
+        for (int i = 0; i < m_lines.count(); ++i)
+            frames[i] = PARSE(parser, m_lines.at(i));
+    };
+
+    Benchmark::throughput(function, m_lines.count(), QTest::FramesPerSecond);
+    for (int i = 0; i < m_lines.count(); ++i)
+    {
+        QJSEngine reference;
+        auto referenceParser = reference.evaluate(m_script);
+        QCOMPARE(frames.at(i), PARSE(referenceParser, m_lines.at(i)));
+    }
+}
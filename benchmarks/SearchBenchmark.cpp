@@ -0,0 +1,182 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "SearchBenchmark.h"
+#include "Benchmark.h"
+
+#include <IO/Search.h>
+
+/*
+ * Size of the buffers that are searched
+ */
+static const int BUFFER_SIZE = 1024 * 1024;
+
+/**
+ * Returns a buffer of @c BUFFER_SIZE bytes filled with comma-separated frames of
+ * (approximately) the given @a frameSize, delimited by the default start & finish
+ * sequences. The end of the buffer is padded with digits, so that it does not contain
+ * partial frames.
+ */
+static QByteArray GENERATE_FRAMES(const int frameSize)
+{
+    QByteArray buffer;
+    buffer.reserve(BUFFER_SIZE);
+
+    int n = 0;
+    forever
+    {
+        // Generate a frame with increasing values
+        QByteArray frame = "/*Serial Studio";
+        while (frame.size() < frameSize - 4)
+        {
+            frame.append(',');
+            frame.append(QByteArray::number(n++ % 1000 * 0.125, 'f', 3));
+        }
+
+        frame.append("*/\n");
+
+        // Stop when the buffer is full
+        if (buffer.size() + frame.size() > BUFFER_SIZE)
+            break;
+
+        buffer.append(frame);
+    }
+
+    buffer.append(QByteArray(BUFFER_SIZE - buffer.size(), '0'));
+    return buffer;
+}
+
+/**
+ * Returns the number of (non-overlapping) occurrences of @a needle in @a buffer using
+ * the vectorized search function.
+ */
+static int COUNT_SEARCH(const QByteArray &buffer, const QByteArray &needle)
+{
+    int count = 0;
+    int index = IO::Search::indexOf(buffer, needle);
+    while (index >= 0)
+    {
+        ++count;
+        index = IO::Search::indexOf(buffer, needle, index + needle.size());
+    }
+
+    return count;
+}
+
+/**
+ * Returns the number of (non-overlapping) occurrences of @a needle in @a buffer using
+ * the search function provided by Qt.
+ */
+static int COUNT_INDEX_OF(const QByteArray &buffer, const QByteArray &needle)
+{
+    int count = 0;
+    int index = buffer.indexOf(needle);
+    while (index >= 0)
+    {
+        ++count;
+        index = buffer.indexOf(needle, index + needle.size());
+    }
+
+    return count;
+}
+
+/**
+ * Logs the search kernel selected for the CPU
+ */
+void SearchBenchmark::initTestCase()
+{
+    qInfo("IO::Search kernel: %s", IO::Search::kernelName());
+}
+
+/**
+ * Registers the buffers & needles used by the @c search() benchmark
+ */
+void SearchBenchmark::search_data()
+{
+    addRows();
+}
+
+/**
+ * Measures the throughput of @c IO::Search::indexOf()
+ */
+void SearchBenchmark::search()
+{
+    QFETCH(QByteArray, buffer);
+    QFETCH(QByteArray, needle);
+    QFETCH(int, expected);
+
+    int count = 0;
+    const auto function = [&] { count = COUNT_SEARCH(buffer, needle); };
+    Benchmark::throughput(function, buffer.size(), QTest::BytesPerSecond);
+    QCOMPARE(count, expected);
+}
+
+/**
+ * Registers the buffers & needles used by the @c indexOf() benchmark
+ */
+void SearchBenchmark::indexOf_data()
+{
+    addRows();
+}
+
+/**
+ * Measures the throughput of @c QByteArray::indexOf()
+ */
+void SearchBenchmark::indexOf()
+{
+    QFETCH(QByteArray, buffer);
+    QFETCH(QByteArray, needle);
+    QFETCH(int, expected);
+
+    int count = 0;
+    const auto function = [&] { count = COUNT_INDEX_OF(buffer, needle); };
+    Benchmark::throughput(function, buffer.size(), QTest::BytesPerSecond);
+    QCOMPARE(count, expected);
+}
+
+/**
+ * Adds a row for each combination of frame size & needle (the finish sequence, the
+ * start sequence & the value separator used in manual mode). The expected number of
+ * occurrences is obtained with @c QByteArray::count(), which uses a different search
+ * algorithm than both benchmarked functions.
+ */
+void SearchBenchmark::addRows()
+{
+    QTest::addColumn<QByteArray>("buffer");
+    QTest::addColumn<QByteArray>("needle");
+    QTest::addColumn<int>("expected");
+
+    const QList<int> frameSizes = {32, 256, 2048};
+    const QList<QByteArray> needles = {"*/", "/*", ","};
+    for (const auto frameSize : frameSizes)
+    {
+        const auto buffer = GENERATE_FRAMES(frameSize);
+        for (const auto &needle : needles)
+        {
+            const auto tag = QString("%1 B frames, \"%2\"")
+                                 .arg(frameSize)
+                                 .arg(QString::fromUtf8(needle));
+            QTest::newRow(tag.toUtf8().constData())
+                << buffer << needle << buffer.count(needle);
+        }
+    }
+}
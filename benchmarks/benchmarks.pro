@@ -0,0 +1,94 @@
+#
+# Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+
+#-----------------------------------------------------------------------------------------
+# Make options
+#-----------------------------------------------------------------------------------------
+
+MOC_DIR = moc
+OBJECTS_DIR = obj
+
+CONFIG += c++11
+CONFIG += console
+CONFIG += release                                        # Debug builds are not measured
+CONFIG -= debug
+CONFIG -= app_bundle
+
+#-----------------------------------------------------------------------------------------
+# Qt configuration
+#-----------------------------------------------------------------------------------------
+
+TEMPLATE = app                                           # Project template
+TARGET = serial-studio-benchmarks                        # Set default target name
+
+QT -= gui
+QT += qml
+QT += core
+QT += testlib
+
+#-----------------------------------------------------------------------------------------
+# Compiler options
+#-----------------------------------------------------------------------------------------
+
+*g++*: {
+    QMAKE_CXXFLAGS_RELEASE -= -O
+    QMAKE_CXXFLAGS_RELEASE *= -O3
+}
+
+*msvc*: {
+    QMAKE_CXXFLAGS_RELEASE -= /O
+    QMAKE_CXXFLAGS_RELEASE *= /O2
+}
+
+#-----------------------------------------------------------------------------------------
+# Import source code
+#-----------------------------------------------------------------------------------------
+
+INCLUDEPATH += ../src
+
+DEFINES += EXAMPLE_PARSER=\\\"$$PWD/../example-parser.js\\\"
+
+HEADERS += \
+    ../src/IO/Checksum.h \
+    ../src/IO/Framing.h \
+    ../src/IO/Search.h \
+    ../src/JSON/FrameParser.h \
+    ../src/JSON/FrameSchema.h \
+    Benchmark.h \
+    ChecksumBenchmark.h \
+    FrameParserBenchmark.h \
+    FramingBenchmark.h \
+    ScriptBenchmark.h \
+    SearchBenchmark.h
+
+SOURCES += \
+    ../src/IO/Checksum.cpp \
+    ../src/IO/Framing.cpp \
+    ../src/IO/Search.cpp \
+    ../src/JSON/FrameParser.cpp \
+    ../src/JSON/FrameSchema.cpp \
+    ChecksumBenchmark.cpp \
+    FrameParserBenchmark.cpp \
+    FramingBenchmark.cpp \
+    ScriptBenchmark.cpp \
+    SearchBenchmark.cpp \
+    main.cpp
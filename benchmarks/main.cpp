@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <QtTest>
+#include <QCoreApplication>
+
+#include "SearchBenchmark.h"
+#include "FramingBenchmark.h"
+#include "ChecksumBenchmark.h"
+#include "ScriptBenchmark.h"
+#include "FrameParserBenchmark.h"
+
+/**
+ * Runs the benchmarks of each module & returns the number of failed checks, the
+ * command line arguments are passed to each benchmark (e.g. to select a function or
+ * to change the output format, run with "-help" for more information).
+ */
+int main(int argc, char **argv)
+{
+    QCoreApplication app(argc, argv);
+
+    int status = 0;
+    SearchBenchmark search;
+    status += QTest::qExec(&search, argc, argv);
+
+    FramingBenchmark framing;
+    status += QTest::qExec(&framing, argc, argv);
+
+    ChecksumBenchmark checksum;
+    status += QTest::qExec(&checksum, argc, argv);
+
+    ScriptBenchmark script;
+    status += QTest::qExec(&script, argc, argv);
+
+    FrameParserBenchmark frameParser;
+    status += QTest::qExec(&frameParser, argc, argv);
+
+    return status;
+}
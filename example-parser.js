@@ -107,3 +107,12 @@
 
 // For testing via node
 //console.log(parse("[2020-10-18 09:01:50.141] 110 rxdata 01 72 73"))
+
+// Scripts that receive many frames per second can also define a batch entry point,
+// which is called once with an array of lines and returns one object per line:
+//
+// (function() {
+//     var parse = function(in_str) { ... };
+//     parse.batch = function(lines) { return lines.map(parse); };
+//     return parse;
+// })()
@@ -36,7 +36,6 @@
 #include <QFileInfo>
 #include <QMessageBox>
 #include <QApplication>
-#include <QJsonDocument>
 #include <QDesktopServices>
 
 using namespace CSV;
@@ -118,6 +117,7 @@ void Export::setExportEnabled(const bool enabled)
     if (!exportEnabled() && isOpen())
     {
         m_jsonList.clear();
+        m_schema.clear();
         closeFile();
     }
 }
@@ -149,82 +149,33 @@ void Export::writeValues()
     JFI_SortList(&m_jsonList);
 
     // Export JSON frames
-    for (int k = 0; k < m_jsonList.count(); ++k)
+    while (!m_jsonList.isEmpty())
     {
-        // Get project title & cell values
-        auto dateTime = m_jsonList.first().rxDateTime;
-        auto json = m_jsonList.first().jsonDocument.object();
-        auto projectTitle = json.value("t").toVariant().toString();
+        // Get frame & RX date/time
+        const auto info = m_jsonList.takeFirst();
+        const auto dateTime = JFI_DateTime(info.rxTimestamp);
+        if (info.values.count() != info.schema->datasets().count())
+            continue;
 
-        // Validate JSON & title
-        if (json.isEmpty() || projectTitle.isEmpty())
-        {
-            m_jsonList.removeFirst();
-            break;
-        }
-
-        // Get cell titles & values
-        QStringList titles;
-        QStringList values;
-        auto groups = json.value("g").toArray();
-        for (int i = 0; i < groups.count(); ++i)
-        {
-            // Get group & dataset array
-            auto group = groups.at(i).toObject();
-            auto datasets = group.value("d").toArray();
-            if (group.isEmpty() || datasets.isEmpty())
-                continue;
+        // Validate project title
+        if (info.schema->title().isEmpty())
+            continue;
 
-            // Get group title
-            auto groupTitle = group.value("t").toVariant().toString();
-
-            // Get dataset titles & values
-            for (int j = 0; j < datasets.count(); ++j)
-            {
-                auto dataset = datasets.at(j).toObject();
-                auto datasetTitle = dataset.value("t").toVariant().toString();
-                auto datasetUnits = dataset.value("u").toVariant().toString();
-                auto datasetValue = dataset.value("v").toVariant().toString();
-
-                ///@todo integrate time into table plotting
-                //auto datasetTime  = dataset.value("x").toVariant().toDouble();
-
-                datasetTitle = datasetTitle.replace("\n", "");
-                datasetUnits = datasetUnits.replace("\n", "");
-                datasetValue = datasetValue.replace("\n", "");
-                datasetTitle = datasetTitle.replace("\r", "");
-                datasetUnits = datasetUnits.replace("\r", "");
-                datasetValue = datasetValue.replace("\r", "");
-
-                if (datasetTitle.isEmpty())
-                    continue;
-
-                // Construct dataset title from group, dataset title & units
-                QString title;
-                if (datasetUnits.isEmpty())
-                    title = QString("(%1) %2").arg(groupTitle).arg(datasetTitle);
-                else
-                    title = QString("(%1) %2 [%3]")
-                                .arg(groupTitle)
-                                .arg(datasetTitle)
-                                .arg(datasetUnits);
-
-                // Add dataset title & value to lists
-                titles.append(title);
-                values.append(datasetValue);
-            }
-        }
+        // Get cell titles (only when the frame structure changes)
+        if (info.schema != m_schema)
+            updateColumns(info.schema);
 
         // Abort if cell titles are empty
-        if (titles.isEmpty())
-        {
-            m_jsonList.removeFirst();
-            break;
-        }
+        if (m_columns.isEmpty())
+            continue;
 
-        // Prepend current time
-        titles.prepend("RX Date/Time");
-        values.prepend(dateTime.toString("yyyy/MM/dd/ HH:mm:ss::zzz"));
+        // Get cell values (prepend current time)
+        ///@todo integrate time into table plotting
+        QStringList values;
+        values.reserve(m_columns.count() + 1);
+        values.append(dateTime.toString("yyyy/MM/dd/ HH:mm:ss::zzz"));
+        for (const auto column : m_columns)
+            values.append(info.values.at(column).text);
 
         // File not open, create it & add cell titles
         if (!isOpen() && exportEnabled())
@@ -234,7 +185,7 @@ void Export::writeValues()
             QString fileName = dateTime.toString("HH-mm-ss") + ".csv";
             QString path = QString("%1/%2/%3/%4")
                                .arg(QDir::homePath(), qApp->applicationName(),
-                                    projectTitle, format);
+                                    info.schema->title(), format);
 
             // Generate file path if required
             QDir dir(path);
@@ -256,10 +207,10 @@ void Export::writeValues()
             m_textStream.setDevice(&m_csvFile);
             m_textStream.setCodec("UTF-8");
             m_textStream.setGenerateByteOrderMark(true);
-            for (int i = 0; i < titles.count(); ++i)
+            for (int i = 0; i < m_titles.count(); ++i)
             {
-                m_textStream << titles.at(i).toUtf8();
-                if (i < titles.count() - 1)
+                m_textStream << m_titles.at(i).toUtf8();
+                if (i < m_titles.count() - 1)
                     m_textStream << ",";
                 else
                     m_textStream << "\n";
@@ -278,10 +229,46 @@ void Export::writeValues()
             else
                 m_textStream << "\n";
         }
+    }
+}
+
+/**
+ * Builds the CSV cell titles from the group titles, dataset titles & units of the given
+ * frame @a schema, and registers the datasets that are exported (datasets without a
+ * title are ignored).
+ */
+void Export::updateColumns(const JSON::FrameSchemaPtr &schema)
+{
+    m_schema = schema;
+    m_titles.clear();
+    m_columns.clear();
 
-        // Remove JSON from list
-        m_jsonList.removeFirst();
+    const auto &groups = schema->groups();
+    const auto &datasets = schema->datasets();
+    for (int i = 0; i < datasets.count(); ++i)
+    {
+        const auto &dataset = datasets.at(i);
+        if (dataset.title.isEmpty())
+            continue;
+
+        // Construct dataset title from group, dataset title & units
+        QString title;
+        const auto &groupTitle = groups.at(dataset.group).title;
+        if (dataset.units.isEmpty())
+            title = QString("(%1) %2").arg(groupTitle).arg(dataset.title);
+        else
+            title = QString("(%1) %2 [%3]")
+                        .arg(groupTitle)
+                        .arg(dataset.title)
+                        .arg(dataset.units);
+
+        m_titles.append(title);
+        m_columns.append(i);
     }
+
+    // Prepend current time
+    if (!m_columns.isEmpty())
+        m_titles.prepend("RX Date/Time");
 }
 
 /**
@@ -69,11 +69,18 @@ private slots:
     void writeValues();
     void registerFrame(const JFI_Object &info);
 
+private:
+    void updateColumns(const JSON::FrameSchemaPtr &schema);
+
 private:
     QFile m_csvFile;
     bool m_exportEnabled;
     QTextStream m_textStream;
     QList<JFI_Object> m_jsonList;
+
+    QStringList m_titles;
+    QVector<int> m_columns;
+    JSON::FrameSchemaPtr m_schema;
 };
 }
 
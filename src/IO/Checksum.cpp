@@ -0,0 +1,610 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Checksum.h"
+#include "Framing.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#    define CHECKSUM_X86_64
+#    include <immintrin.h>
+#    ifdef _MSC_VER
+#        include <intrin.h>
+#    endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#    define TARGET_SSE42 __attribute__((target("sse4.2")))
+#else
+#    define TARGET_SSE42
+#endif
+
+using namespace IO;
+
+/**
+ * Parameters of the predefined CRC algorithms (Rocksoft model), the comment next to
+ * each entry is the CRC of the ASCII string "123456789".
+ */
+static const Checksum::CrcParameters CRC8_PARAMETERS
+    = { 8, 0x07, 0x00, 0x00, false }; // 0xF4
+static const Checksum::CrcParameters CRC16_MODBUS_PARAMETERS
+    = { 16, 0x8005, 0xFFFF, 0x0000, true }; // 0x4B37
+static const Checksum::CrcParameters CRC16_CCITT_PARAMETERS
+    = { 16, 0x1021, 0xFFFF, 0x0000, false }; // 0x29B1
+static const Checksum::CrcParameters CRC32_PARAMETERS
+    = { 32, 0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, true }; // 0xCBF43926
+static const Checksum::CrcParameters CRC32C_PARAMETERS
+    = { 32, 0x1EDC6F41, 0xFFFFFFFF, 0xFFFFFFFF, true }; // 0xE3069283
+
+/**
+ * Returns a mask with the lower @a width bits set
+ */
+static inline quint32 MASK(const int width)
+{
+    return width >= 32 ? 0xFFFFFFFF : (1u << width) - 1;
+}
+
+/**
+ * Reverses the order of the lower @a width bits of the given @a value
+ */
+static quint32 REFLECT(quint32 value, const int width)
+{
+    quint32 result = 0;
+    for (int i = 0; i < width; ++i)
+    {
+        result = (result << 1) | (value & 1);
+        value >>= 1;
+    }
+
+    return result;
+}
+
+/**
+ * Calculates the XOR of all the bytes of the given @a data, eight bytes at a time
+ */
+static quint32 XOR8(const quint8 *data, int length)
+{
+    quint64 word = 0;
+    while (length >= 8)
+    {
+        quint64 value;
+        memcpy(&value, data, sizeof(value));
+        word ^= value;
+        data += 8;
+        length -= 8;
+    }
+
+    word ^= word >> 32;
+    word ^= word >> 16;
+    word ^= word >> 8;
+
+    auto value = static_cast<quint8>(word);
+    while (length-- > 0)
+        value ^= *data++;
+
+    return value;
+}
+
+/**
+ * Calculates the Fletcher-16 checksum of the given @a data. The modulo operation is
+ * only performed every 5802 bytes, which is the largest block size that cannot
+ * overflow the 32-bit accumulators.
+ */
+static quint32 FLETCHER16(const quint8 *data, int length)
+{
+    quint32 sum1 = 0;
+    quint32 sum2 = 0;
+    while (length > 0)
+    {
+        auto block = qMin(length, 5802);
+        length -= block;
+        while (block-- > 0)
+        {
+            sum1 += *data++;
+            sum2 += sum1;
+        }
+
+        sum1 %= 255;
+        sum2 %= 255;
+    }
+
+    return (sum2 << 8) | sum1;
+}
+
+/**
+ * Slice-by-8 CRC calculation for reflected (LSB-first) algorithms, the register holds
+ * the CRC in its lower bits.
+ */
+static quint32 CRC_REFLECTED(const quint32 *t, quint32 crc, const quint8 *p, int length)
+{
+    while (length >= 8)
+    {
+        crc ^= static_cast<quint32>(p[0]) | static_cast<quint32>(p[1]) << 8
+            | static_cast<quint32>(p[2]) << 16 | static_cast<quint32>(p[3]) << 24;
+        crc = t[7 * 256 + (crc & 0xFF)] ^ t[6 * 256 + ((crc >> 8) & 0xFF)]
+            ^ t[5 * 256 + ((crc >> 16) & 0xFF)] ^ t[4 * 256 + (crc >> 24)]
+            ^ t[3 * 256 + p[4]] ^ t[2 * 256 + p[5]] ^ t[1 * 256 + p[6]] ^ t[p[7]];
+
+        p += 8;
+        length -= 8;
+    }
+
+    while (length-- > 0)
+        crc = t[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+
+    return crc;
+}
+
+/**
+ * Slice-by-8 CRC calculation for normal (MSB-first) algorithms, the register holds
+ * the CRC in its upper bits so that all widths can share the same implementation.
+ */
+static quint32 CRC_NORMAL(const quint32 *t, quint32 crc, const quint8 *p, int length)
+{
+    while (length >= 8)
+    {
+        crc ^= static_cast<quint32>(p[0]) << 24 | static_cast<quint32>(p[1]) << 16
+            | static_cast<quint32>(p[2]) << 8 | static_cast<quint32>(p[3]);
+        crc = t[7 * 256 + (crc >> 24)] ^ t[6 * 256 + ((crc >> 16) & 0xFF)]
+            ^ t[5 * 256 + ((crc >> 8) & 0xFF)] ^ t[4 * 256 + (crc & 0xFF)]
+            ^ t[3 * 256 + p[4]] ^ t[2 * 256 + p[5]] ^ t[1 * 256 + p[6]] ^ t[p[7]];
+
+        p += 8;
+        length -= 8;
+    }
+
+    while (length-- > 0)
+        crc = t[(crc >> 24) ^ *p++] ^ (crc << 8);
+
+    return crc;
+}
+
+#ifdef CHECKSUM_X86_64
+/**
+ * CRC-32C calculation using the SSE 4.2 @c crc32 instruction, which implements the
+ * reflected Castagnoli polynomial (without initial value or final XOR).
+ */
+TARGET_SSE42
+static quint32 SSE42_CRC32C(quint32 crc, const quint8 *p, int length)
+{
+    quint64 crc64 = crc;
+    while (length >= 8)
+    {
+        quint64 value;
+        memcpy(&value, p, sizeof(value));
+        crc64 = _mm_crc32_u64(crc64, value);
+        p += 8;
+        length -= 8;
+    }
+
+    crc = static_cast<quint32>(crc64);
+    while (length-- > 0)
+        crc = _mm_crc32_u8(crc, *p++);
+
+    return crc;
+}
+
+/**
+ * Returns @c true if the CPU supports SSE 4.2 instructions
+ */
+static bool CPU_HAS_SSE42()
+{
+#    if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 20)) != 0;
+#    else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse4.2");
+#    endif
+}
+#endif
+
+/**
+ * Returns @c true if CRC-32C can be calculated with dedicated CPU instructions
+ */
+static bool HARDWARE_CRC32C()
+{
+#ifdef CHECKSUM_X86_64
+    static const auto SUPPORTED = CPU_HAS_SSE42();
+    return SUPPORTED;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Constructor function, by default frames are not validated
+ */
+Checksum::Checksum()
+    : m_algorithm(Algorithm::None)
+    , m_position(Position::Trailing)
+    , m_bigEndian(true)
+    , m_asciiHex(false)
+    , m_crc(CRC32_PARAMETERS)
+    , m_custom(CRC32_PARAMETERS)
+    , m_register(0)
+{
+}
+
+/**
+ * Returns the checksum algorithm used to validate frames
+ */
+Checksum::Algorithm Checksum::algorithm() const
+{
+    return m_algorithm;
+}
+
+/**
+ * Returns the location of the checksum field in the frame (at the end or at the
+ * beginning of the frame).
+ */
+Checksum::Position Checksum::position() const
+{
+    return m_position;
+}
+
+/**
+ * Returns @c true if binary checksum fields are transmitted with the most significant
+ * byte first. ASCII hexadecimal fields are always read with the most significant digit
+ * first.
+ */
+bool Checksum::bigEndian() const
+{
+    return m_bigEndian;
+}
+
+/**
+ * Returns @c true if the checksum field is transmitted as ASCII hexadecimal digits
+ * (two characters per byte) instead of binary data.
+ */
+bool Checksum::asciiHex() const
+{
+    return m_asciiHex;
+}
+
+/**
+ * Returns the parameters of the current CRC algorithm (or of the custom CRC algorithm,
+ * if a non-CRC algorithm is selected).
+ */
+Checksum::CrcParameters Checksum::crcParameters() const
+{
+    return m_crc;
+}
+
+/**
+ * Returns the width of the checksum in bits
+ */
+int Checksum::width() const
+{
+    switch (m_algorithm)
+    {
+        case Algorithm::None:
+            return 0;
+        case Algorithm::XOR8:
+            return 8;
+        case Algorithm::Fletcher16:
+            return 16;
+        default:
+            return m_crc.width;
+    }
+}
+
+/**
+ * Returns the number of bytes that the checksum field occupies in each frame
+ */
+int Checksum::fieldSize() const
+{
+    const auto bytes = (width() + 7) / 8;
+    return m_asciiHex ? bytes * 2 : bytes;
+}
+
+/**
+ * Returns @c true if frames shall be validated
+ */
+bool Checksum::isEnabled() const
+{
+    return m_algorithm != Algorithm::None;
+}
+
+/**
+ * Returns the name of the CRC-32C implementation selected for the current CPU (used
+ * for logs).
+ */
+const char *Checksum::crc32cKernelName()
+{
+    return HARDWARE_CRC32C() ? "SSE 4.2" : "Slice-by-8";
+}
+
+/**
+ * Changes the checksum algorithm & generates the lookup tables used by CRC algorithms.
+ * Selecting @c Algorithm::CustomCRC restores the parameters given to the last call of
+ * @c setCustomCrc().
+ */
+void Checksum::setAlgorithm(const Algorithm algorithm)
+{
+    m_algorithm = algorithm;
+    switch (algorithm)
+    {
+        case Algorithm::CRC8:
+            m_crc = CRC8_PARAMETERS;
+            break;
+        case Algorithm::CRC16_MODBUS:
+            m_crc = CRC16_MODBUS_PARAMETERS;
+            break;
+        case Algorithm::CRC16_CCITT:
+            m_crc = CRC16_CCITT_PARAMETERS;
+            break;
+        case Algorithm::CRC32:
+            m_crc = CRC32_PARAMETERS;
+            break;
+        case Algorithm::CRC32C:
+            m_crc = CRC32C_PARAMETERS;
+            break;
+        case Algorithm::CustomCRC:
+            m_crc = m_custom;
+            break;
+        default:
+            break;
+    }
+
+    generateTables();
+}
+
+/**
+ * Selects a custom CRC algorithm with the given @a parameters. The width of the CRC
+ * must be between 8 and 32 bits, the initial value is given in non-reflected form
+ * (same convention as the usual CRC catalogues).
+ */
+void Checksum::setCustomCrc(const CrcParameters &parameters)
+{
+    m_custom = parameters;
+    m_custom.width = qBound(8, parameters.width, 32);
+    m_custom.polynomial &= MASK(m_custom.width);
+    m_custom.init &= MASK(m_custom.width);
+    m_custom.xorOut &= MASK(m_custom.width);
+
+    m_algorithm = Algorithm::CustomCRC;
+    m_crc = m_custom;
+    generateTables();
+}
+
+/**
+ * Changes the location of the checksum field in the frame
+ */
+void Checksum::setPosition(const Position position)
+{
+    m_position = position;
+}
+
+/**
+ * Changes the byte order of binary checksum fields
+ */
+void Checksum::setBigEndian(const bool bigEndian)
+{
+    m_bigEndian = bigEndian;
+}
+
+/**
+ * Changes the encoding of the checksum field (binary or ASCII hexadecimal digits)
+ */
+void Checksum::setAsciiHex(const bool asciiHex)
+{
+    m_asciiHex = asciiHex;
+}
+
+/**
+ * Calculates the checksum of the given @a data with the current algorithm
+ */
+quint32 Checksum::compute(const char *data, const int length) const
+{
+    const auto bytes = reinterpret_cast<const quint8 *>(data);
+    switch (m_algorithm)
+    {
+        case Algorithm::None:
+            return 0;
+        case Algorithm::XOR8:
+            return XOR8(bytes, length);
+        case Algorithm::Fletcher16:
+            return FLETCHER16(bytes, length);
+        default:
+            return crc(data, length);
+    }
+}
+
+/**
+ * Validates the given @a frame & obtains the location of its payload (the frame data
+ * without the checksum field).
+ *
+ * @param frame         frame data, including the checksum field
+ * @param length        size of the frame in bytes
+ * @param payloadOffset set to the index of the first byte of the payload
+ * @param payloadLength set to the size of the payload
+ *
+ * @returns @c true if the checksum field matches the checksum of the payload, or if
+ *          frame validation is disabled
+ */
+bool Checksum::verify(const char *frame, const int length, int &payloadOffset,
+                      int &payloadLength) const
+{
+    // Validation disabled, the whole frame is the payload
+    if (!isEnabled())
+    {
+        payloadOffset = 0;
+        payloadLength = length;
+        return true;
+    }
+
+    // Frame too small to contain a checksum
+    const auto size = fieldSize();
+    if (length < size)
+        return false;
+
+    // Locate checksum field & payload
+    const char *field;
+    payloadLength = length - size;
+    if (m_position == Position::Trailing)
+    {
+        payloadOffset = 0;
+        field = frame + payloadLength;
+    }
+
+    else
+    {
+        payloadOffset = size;
+        field = frame;
+    }
+
+    // Compare checksums
+    quint32 expected;
+    if (!readField(field, expected))
+        return false;
+
+    return compute(frame + payloadOffset, payloadLength) == expected;
+}
+
+/**
+ * Generates the slice-by-8 lookup tables for the current CRC parameters. The first
+ * table is the usual byte-wise CRC table, table @c k contains the CRC of a byte that
+ * is followed by @c k zero bytes.
+ */
+void Checksum::generateTables()
+{
+    // Only CRC algorithms need lookup tables
+    if (m_algorithm == Algorithm::None || m_algorithm == Algorithm::XOR8
+        || m_algorithm == Algorithm::Fletcher16)
+    {
+        m_tables.clear();
+        return;
+    }
+
+    // Generate byte-wise table
+    m_tables.resize(8 * 256);
+    auto t = m_tables.data();
+    const auto width = m_crc.width;
+    if (m_crc.reflected)
+    {
+        const auto poly = REFLECT(m_crc.polynomial, width);
+        for (quint32 i = 0; i < 256; ++i)
+        {
+            auto crc = i;
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc & 1) ? (crc >> 1) ^ poly : crc >> 1;
+
+            t[i] = crc;
+        }
+
+        for (int k = 1; k < 8; ++k)
+        {
+            for (int i = 0; i < 256; ++i)
+            {
+                const auto prev = t[(k - 1) * 256 + i];
+                t[k * 256 + i] = (prev >> 8) ^ t[prev & 0xFF];
+            }
+        }
+
+        m_register = REFLECT(m_crc.init, width);
+    }
+
+    else
+    {
+        const auto poly = m_crc.polynomial << (32 - width);
+        for (quint32 i = 0; i < 256; ++i)
+        {
+            auto crc = i << 24;
+            for (int bit = 0; bit < 8; ++bit)
+                crc = (crc & 0x80000000) ? (crc << 1) ^ poly : crc << 1;
+
+            t[i] = crc;
+        }
+
+        for (int k = 1; k < 8; ++k)
+        {
+            for (int i = 0; i < 256; ++i)
+            {
+                const auto prev = t[(k - 1) * 256 + i];
+                t[k * 256 + i] = (prev << 8) ^ t[prev >> 24];
+            }
+        }
+
+        m_register = m_crc.init << (32 - width);
+    }
+}
+
+/**
+ * Calculates the CRC of the given @a data with the current CRC parameters
+ */
+quint32 Checksum::crc(const char *data, const int length) const
+{
+    quint32 value;
+    const auto bytes = reinterpret_cast<const quint8 *>(data);
+
+#ifdef CHECKSUM_X86_64
+    if (m_algorithm == Algorithm::CRC32C && HARDWARE_CRC32C())
+        return SSE42_CRC32C(m_register, bytes, length) ^ m_crc.xorOut;
+#endif
+
+    if (m_crc.reflected)
+        value = CRC_REFLECTED(m_tables.constData(), m_register, bytes, length);
+    else
+        value = CRC_NORMAL(m_tables.constData(), m_register, bytes, length)
+            >> (32 - m_crc.width);
+
+    return (value ^ m_crc.xorOut) & MASK(m_crc.width);
+}
+
+/**
+ * Reads the checksum @a value stored in the given @a field
+ *
+ * @returns @c false if the field contains invalid hexadecimal digits
+ */
+bool Checksum::readField(const char *field, quint32 &value) const
+{
+    // Binary field
+    const auto bytes = (width() + 7) / 8;
+    if (!m_asciiHex)
+    {
+        value = Framing::readLength(field, bytes, m_bigEndian);
+        return true;
+    }
+
+    // ASCII hexadecimal field
+    value = 0;
+    for (int i = 0; i < bytes * 2; ++i)
+    {
+        const auto c = field[i];
+        quint32 digit;
+        if (c >= '0' && c <= '9')
+            digit = static_cast<quint32>(c - '0');
+        else if (c >= 'A' && c <= 'F')
+            digit = static_cast<quint32>(c - 'A' + 10);
+        else if (c >= 'a' && c <= 'f')
+            digit = static_cast<quint32>(c - 'a' + 10);
+        else
+            return false;
+
+        value = (value << 4) | digit;
+    }
+
+    return true;
+}
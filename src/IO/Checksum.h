@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef IO_CHECKSUM_H
+#define IO_CHECKSUM_H
+
+#include <QVector>
+#include <QObject>
+
+namespace IO
+{
+/**
+ * Frame integrity checker used by the @c Reader class to discard corrupted frames
+ * before they are handed to the JSON generator.
+ *
+ * The checksum is stored at the end (or at the beginning) of each frame, either as
+ * binary data or as ASCII hexadecimal digits (e.g. NMEA-style text protocols). CRCs are
+ * calculated with slice-by-8 lookup tables that are generated when the algorithm is
+ * selected, CRC-32C uses the SSE 4.2 @c crc32 instruction if the CPU supports it.
+ *
+ * Objects of this class are cheap to copy (the lookup tables are implicitly shared),
+ * which allows the @c Manager to configure a checksum in the GUI thread & send a copy
+ * of it to the reader thread.
+ */
+class Checksum
+{
+    Q_GADGET
+
+public:
+    enum class Algorithm
+    {
+        None,
+        XOR8,
+        CRC8,
+        CRC16_MODBUS,
+        CRC16_CCITT,
+        CRC32,
+        CRC32C,
+        Fletcher16,
+        CustomCRC
+    };
+    Q_ENUM(Algorithm)
+
+    enum class Position
+    {
+        Trailing,
+        Leading
+    };
+    Q_ENUM(Position)
+
+    struct CrcParameters
+    {
+        int width;
+        quint32 polynomial;
+        quint32 init;
+        quint32 xorOut;
+        bool reflected;
+    };
+
+    Checksum();
+
+    Algorithm algorithm() const;
+    Position position() const;
+    bool bigEndian() const;
+    bool asciiHex() const;
+    CrcParameters crcParameters() const;
+
+    int width() const;
+    int fieldSize() const;
+    bool isEnabled() const;
+
+    static const char *crc32cKernelName();
+
+    void setAlgorithm(const Algorithm algorithm);
+    void setCustomCrc(const CrcParameters &parameters);
+    void setPosition(const Position position);
+    void setBigEndian(const bool bigEndian);
+    void setAsciiHex(const bool asciiHex);
+
+    quint32 compute(const char *data, const int length) const;
+    bool verify(const char *frame, const int length, int &payloadOffset,
+                int &payloadLength) const;
+
+private:
+    void generateTables();
+    quint32 crc(const char *data, const int length) const;
+    bool readField(const char *field, quint32 &value) const;
+
+private:
+    Algorithm m_algorithm;
+    Position m_position;
+    bool m_bigEndian;
+    bool m_asciiHex;
+    CrcParameters m_crc;
+    CrcParameters m_custom;
+    quint32 m_register;
+    QVector<quint32> m_tables;
+};
+}
+
+#endif
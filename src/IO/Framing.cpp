@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Framing.h"
+
+#include <cstring>
+
+using namespace IO;
+
+/**
+ * Decodes a Consistent Overhead Byte Stuffing (COBS) encoded frame. The @a input must
+ * not contain the trailing zero delimiter.
+ *
+ * @param input  encoded data
+ * @param length number of bytes of the encoded data
+ * @param output buffer for the decoded data, must be able to hold @a length bytes
+ *
+ * @returns the number of decoded bytes, or -1 if the frame is not valid COBS data
+ */
+int Framing::cobsDecode(const char *input, const int length, char *output)
+{
+    int r = 0;
+    int w = 0;
+    while (r < length)
+    {
+        // Read code byte, which contains the offset to the next zero
+        const auto code = static_cast<quint8>(input[r++]);
+        if (code == 0)
+            return -1;
+
+        // Copy the block of non-zero bytes
+        const auto count = code - 1;
+        if (r + count > length)
+            return -1;
+
+        memcpy(output + w, input + r, static_cast<size_t>(count));
+        r += count;
+        w += count;
+
+        // Restore the zero that was replaced by the code byte
+        if (code != 0xFF && r < length)
+            output[w++] = '\x00';
+    }
+
+    return w;
+}
+
+/**
+ * Decodes a Serial Line Internet Protocol (SLIP, RFC 1055) encoded frame. The @a input
+ * must not contain the @c SLIP_END delimiters.
+ *
+ * @param input  encoded data
+ * @param length number of bytes of the encoded data
+ * @param output buffer for the decoded data, must be able to hold @a length bytes
+ *
+ * @returns the number of decoded bytes, or -1 if the frame contains an invalid escape
+ *          sequence
+ */
+int Framing::slipDecode(const char *input, const int length, char *output)
+{
+    int r = 0;
+    int w = 0;
+    while (r < length)
+    {
+        // Copy everything until the next escape byte in a single operation
+        auto esc = static_cast<const char *>(memchr(input + r, SLIP_ESC, length - r));
+        const auto run = esc ? static_cast<int>(esc - input) - r : length - r;
+        memcpy(output + w, input + r, static_cast<size_t>(run));
+        r += run;
+        w += run;
+
+        // Decode escape sequence
+        if (esc)
+        {
+            if (r + 1 >= length)
+                return -1;
+
+            const auto c = input[r + 1];
+            if (c == SLIP_ESC_END)
+                output[w++] = SLIP_END;
+            else if (c == SLIP_ESC_ESC)
+                output[w++] = SLIP_ESC;
+            else
+                return -1;
+
+            r += 2;
+        }
+    }
+
+    return w;
+}
+
+/**
+ * Reads an unsigned length field of @a fieldSize bytes (1, 2, 3 or 4) from the given
+ * @a data, using big-endian or little-endian byte order.
+ */
+quint32 Framing::readLength(const char *data, const int fieldSize, const bool bigEndian)
+{
+    quint32 length = 0;
+    const auto bytes = reinterpret_cast<const quint8 *>(data);
+
+    if (bigEndian)
+    {
+        for (int i = 0; i < fieldSize; ++i)
+            length = (length << 8) | bytes[i];
+    }
+
+    else
+    {
+        for (int i = fieldSize - 1; i >= 0; --i)
+            length = (length << 8) | bytes[i];
+    }
+
+    return length;
+}
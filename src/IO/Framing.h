@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef IO_FRAMING_H
+#define IO_FRAMING_H
+
+#include <QtGlobal>
+
+namespace IO
+{
+/**
+ * Decoding functions for the binary framing modes supported by the @c Reader class.
+ *
+ * All functions operate on caller-provided buffers & never allocate memory, the reader
+ * locates the frame boundaries in its ring buffer & calls these functions to decode
+ * the payload into a reusable scratch buffer, which is then validated & copied into
+ * the frame that is handed to the GUI thread.
+ */
+namespace Framing
+{
+static constexpr char COBS_DELIMITER = '\x00';
+
+static constexpr char SLIP_END = '\xC0';
+static constexpr char SLIP_ESC = '\xDB';
+static constexpr char SLIP_ESC_END = '\xDC';
+static constexpr char SLIP_ESC_ESC = '\xDD';
+
+int cobsDecode(const char *input, const int length, char *output);
+int slipDecode(const char *input, const int length, char *output);
+
+quint32 readLength(const char *data, const int fieldSize, const bool bigEndian);
+}
+}
+
+#endif
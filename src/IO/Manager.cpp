@@ -22,10 +22,18 @@
 
 #include "Manager.h"
 
+#include <QFile>
+#include <QtMath>
+#include <QFileInfo>
+#include <QTcpSocket>
+#include <QUdpSocket>
+#include <QSerialPort>
 #include <Logger.h>
 #include <IO/DataSources/Serial.h>
 #include <IO/DataSources/Network.h>
 #include <IO/DataSources/File.h>
+#include <IO/Search.h>
+#include <Misc/TimerEvents.h>
 
 using namespace IO;
 
@@ -56,20 +64,90 @@ static QString ADD_ESCAPE_SEQUENCES(const QString &str)
     return escapedStr;
 }
 
+/**
+ * Converts the given hexadecimal string (with or without the "0x" prefix) to an
+ * unsigned integer, invalid strings are converted to zero.
+ */
+static quint32 HEX_VALUE(const QString &str)
+{
+    auto hex = str.trimmed();
+    if (hex.startsWith("0x", Qt::CaseInsensitive))
+        hex = hex.mid(2);
+
+    return hex.toUInt(nullptr, 16);
+}
+
+/**
+ * Returns the number of bits used to transmit each character (start, data, parity &
+ * stop bits) with the current serial port configuration.
+ */
+static double BITS_PER_CHARACTER()
+{
+    auto serial = IO::DataSources::Serial::getInstance();
+
+    double bits = 1 + qMax(5, static_cast<int>(serial->dataBits()));
+    if (serial->parity() != QSerialPort::NoParity)
+        bits += 1;
+
+    if (serial->stopBits() == QSerialPort::TwoStop)
+        bits += 2;
+    else if (serial->stopBits() == QSerialPort::OneAndHalfStop)
+        bits += 1.5;
+    else
+        bits += 1;
+
+    return bits;
+}
+
 /**
  * Constructor function
  */
 Manager::Manager()
     : m_writeEnabled(true)
     , m_maxBuzzerSize(1024 * 1024)
+    , m_reader(new Reader)
     , m_device(nullptr)
     , m_dataSource(DataSource::Serial)
     , m_receivedBytes(0)
+    , m_invalidFrames(0)
+    , m_passedFrames(0)
+    , m_failedFrames(0)
+    , m_discardedBytes(0)
+    , m_droppedChunks(0)
+    , m_droppedFrames(0)
+    , m_lastDroppedFrames(0)
+    , m_frameMode(Reader::FrameMode::Delimiter)
+    , m_overflowPolicy(Reader::OverflowPolicy::Resync)
+    , m_idleGap(0)
+    , m_timestampInterpolation(false)
+    , m_rxPending(false)
+    , m_ingestMode(Reader::IngestMode::Immediate)
+    , m_coalescingThreshold(4096)
+    , m_latencyBudget(2000)
+    , m_readEventsPerSecond(0)
+    , m_deviceReadsPerSecond(0)
+    , m_framesPerSecond(0)
+    , m_lastReadEvents(0)
+    , m_lastDeviceReads(0)
+    , m_lastQueuedFrames(0)
+    , m_lengthFieldSize(2)
+    , m_lengthFieldBigEndian(true)
     , m_startSequence("/*")
     , m_finishSequence("*/")
+    , m_nextSourceId(1)
 {
+    // Move the frame reader to its own thread
+    m_reader->moveToThread(&m_readerThread);
+    connect(&m_readerThread, &QThread::finished, m_reader, &QObject::deleteLater);
+    connect(m_reader, &Reader::dataAvailable, this, &Manager::onDataReceived,
+            Qt::QueuedConnection);
+    m_readerThread.setObjectName("IO::Reader");
+    m_readerThread.start(QThread::TimeCriticalPriority);
+
     // setWatchdogInterval(15);
     setMaxBufferSize(1024 * 1024);
+    LOG_TRACE() << "Delimiter search kernel:" << Search::kernelName();
+    LOG_TRACE() << "CRC-32C kernel:" << Checksum::crc32cKernelName();
     LOG_TRACE() << "Class initialized";
 
     // Configure signals/slots
@@ -81,12 +159,36 @@ Manager::Manager()
     connect(this, SIGNAL(dataSourceChanged()), this, SIGNAL(configurationChanged()));
     connect(serial, SIGNAL(portIndexChanged()), this, SIGNAL(configurationChanged()));
     connect(file, SIGNAL(pathChanged()), this, SIGNAL(configurationChanged()));
+
+    // Update idle gap threshold & line rate when the serial port configuration changes
+    connect(serial, SIGNAL(parityChanged()), this, SLOT(updateIdleGap()));
+    connect(serial, SIGNAL(baudRateChanged()), this, SLOT(updateIdleGap()));
+    connect(serial, SIGNAL(dataBitsChanged()), this, SLOT(updateIdleGap()));
+    connect(serial, SIGNAL(stopBitsChanged()), this, SLOT(updateIdleGap()));
+    connect(serial, SIGNAL(parityChanged()), this, SLOT(updateLineRate()));
+    connect(serial, SIGNAL(baudRateChanged()), this, SLOT(updateLineRate()));
+    connect(serial, SIGNAL(dataBitsChanged()), this, SLOT(updateLineRate()));
+    connect(serial, SIGNAL(stopBitsChanged()), this, SLOT(updateLineRate()));
+    connect(this, SIGNAL(dataSourceChanged()), this, SLOT(updateLineRate()));
+    updateIdleGap();
+
+    // Throttle user interface notifications & update statistics
+    auto te = Misc::TimerEvents::getInstance();
+    connect(te, SIGNAL(timeout1Hz()), this, SLOT(updateStatistics()));
+    connect(te, SIGNAL(timeout42Hz()), this, SLOT(updateIndicators()));
+    m_statisticsTimer.start();
 }
 
 /**
- * Destructor function
+ * Destructor function, stops the reader thread
  */
-Manager::~Manager() { }
+Manager::~Manager()
+{
+    removeAllSources();
+    disconnectDevice();
+    m_readerThread.quit();
+    m_readerThread.wait();
+}
 
 /**
  * Returns the only instance of the class
@@ -188,6 +290,304 @@ int Manager::maxBufferSize() const
     return m_maxBuzzerSize;
 }
 
+/**
+ * Returns the number of received bytes that were discarded by the reader because the
+ * receive buffer was full & no valid frame could be extracted from it.
+ */
+quint64 Manager::discardedBytes() const
+{
+    return m_discardedBytes;
+}
+
+/**
+ * Returns the number of raw data chunks of the main device that were not shown in the
+ * console because the user interface could not keep up with the received data.
+ */
+quint64 Manager::droppedChunks() const
+{
+    return m_droppedChunks;
+}
+
+/**
+ * Returns the number of extracted frames that were discarded because the user interface
+ * could not keep up with the received data (the frame queue of a reader was full).
+ */
+quint64 Manager::droppedFrames() const
+{
+    return m_droppedFrames;
+}
+
+/**
+ * Returns the number of frames that were discarded because they could not be decoded
+ * (e.g. corrupted COBS or SLIP frames).
+ */
+quint64 Manager::invalidFrames() const
+{
+    return m_invalidFrames;
+}
+
+/**
+ * Returns the number of frames that passed the checksum validation since the device
+ * was connected.
+ */
+quint64 Manager::passedFrames() const
+{
+    return m_passedFrames;
+}
+
+/**
+ * Returns the number of frames that were discarded because their checksum did not
+ * match the received data.
+ */
+quint64 Manager::failedFrames() const
+{
+    return m_failedFrames;
+}
+
+/**
+ * Returns the algorithm used to validate the integrity of received frames
+ */
+Checksum::Algorithm Manager::checksumAlgorithm() const
+{
+    return m_checksum.algorithm();
+}
+
+/**
+ * Returns the location of the checksum field (at the end or at the beginning of each
+ * frame).
+ */
+Checksum::Position Manager::checksumPosition() const
+{
+    return m_checksum.position();
+}
+
+/**
+ * Returns @c true if binary checksum fields are transmitted with the most significant
+ * byte first.
+ */
+bool Manager::checksumBigEndian() const
+{
+    return m_checksum.bigEndian();
+}
+
+/**
+ * Returns @c true if the checksum field is transmitted as ASCII hexadecimal digits
+ */
+bool Manager::checksumAsciiHex() const
+{
+    return m_checksum.asciiHex();
+}
+
+/**
+ * Returns the width (in bits) of the current CRC algorithm
+ */
+int Manager::crcWidth() const
+{
+    return m_checksum.crcParameters().width;
+}
+
+/**
+ * Returns the polynomial of the current CRC algorithm as a hexadecimal string
+ */
+QString Manager::crcPolynomial() const
+{
+    return QString::number(m_checksum.crcParameters().polynomial, 16).toUpper();
+}
+
+/**
+ * Returns the initial value of the current CRC algorithm as a hexadecimal string
+ */
+QString Manager::crcInit() const
+{
+    return QString::number(m_checksum.crcParameters().init, 16).toUpper();
+}
+
+/**
+ * Returns the final XOR value of the current CRC algorithm as a hexadecimal string
+ */
+QString Manager::crcXorOut() const
+{
+    return QString::number(m_checksum.crcParameters().xorOut, 16).toUpper();
+}
+
+/**
+ * Returns @c true if the current CRC algorithm processes bits LSB-first
+ */
+bool Manager::crcReflected() const
+{
+    return m_checksum.crcParameters().reflected;
+}
+
+/**
+ * Returns the idle time (in microseconds) that marks the end of a frame in idle gap
+ * frame mode, a value of zero means that the threshold is calculated automatically
+ * from the serial port configuration.
+ */
+int Manager::idleGap() const
+{
+    return m_idleGap;
+}
+
+/**
+ * Returns the idle time threshold (in microseconds) that is used by the reader.
+ *
+ * If no threshold is set by the user, the threshold is 3.5 character times at the
+ * current serial port configuration (same rule as Modbus RTU), with a minimum of
+ * 1750 microseconds for baud rates above 19200 bps.
+ */
+int Manager::effectiveIdleGap() const
+{
+    return idleGapFor(DataSources::Serial::getInstance()->baudRate());
+}
+
+/**
+ * Returns the names of the additional data sources that are read in parallel to the
+ * main device.
+ */
+QStringList Manager::sources() const
+{
+    QStringList list;
+    for (auto source : m_sources)
+        list.append(source->name());
+
+    return list;
+}
+
+/**
+ * Returns the configured additional data sources, which are opened together with the
+ * main device. Each entry has one of the following formats (see @c sourceEntry()):
+ * - @c serial:<port>@<baud rate>
+ * - @c tcp:<host>:<port>
+ * - @c udp:<host>:<port>
+ * - @c file:<path>
+ */
+QStringList Manager::sourceList() const
+{
+    return m_sourceList;
+}
+
+/**
+ * Returns the number of additional data sources that are read in parallel to the main
+ * device.
+ */
+int Manager::auxiliarySourceCount() const
+{
+    return m_sources.count();
+}
+
+/**
+ * Returns the name of the data source with the given @a id, or an empty string if
+ * @a id refers to the main device.
+ */
+QString Manager::sourceName(const int id) const
+{
+    for (auto source : m_sources)
+    {
+        if (source->id() == id)
+            return source->name();
+    }
+
+    return "";
+}
+
+/**
+ * Returns @c true if the receive timestamps of frames that are read from the device at
+ * the same time are interpolated using the byte offset of each frame & the serial
+ * port line rate. Interpolation is only performed for serial port devices.
+ */
+bool Manager::timestampInterpolation() const
+{
+    return m_timestampInterpolation;
+}
+
+/**
+ * Returns the selected trade-off between latency & throughput, check the
+ * @c Reader::setIngestMode() function for more information.
+ */
+Reader::IngestMode Manager::ingestMode() const
+{
+    return m_ingestMode;
+}
+
+/**
+ * Returns the minimum number of bytes that are processed as a batch in coalesced
+ * ingest mode.
+ */
+int Manager::coalescingThreshold() const
+{
+    return m_coalescingThreshold;
+}
+
+/**
+ * Returns the maximum time (in microseconds) that received data can wait before being
+ * processed in coalesced ingest mode.
+ */
+int Manager::latencyBudget() const
+{
+    return m_latencyBudget;
+}
+
+/**
+ * Returns the number of data notifications (@c readyRead() signals) received from the
+ * device during the last second.
+ */
+int Manager::readEventsPerSecond() const
+{
+    return m_readEventsPerSecond;
+}
+
+/**
+ * Returns the number of batches of data read & processed by the reader thread during
+ * the last second.
+ */
+int Manager::deviceReadsPerSecond() const
+{
+    return m_deviceReadsPerSecond;
+}
+
+/**
+ * Returns the number of frames extracted by the reader thread during the last second.
+ */
+int Manager::framesPerSecond() const
+{
+    return m_framesPerSecond;
+}
+
+/**
+ * Returns the size (in bytes) of the length field used in length-prefixed frame mode.
+ */
+int Manager::lengthFieldSize() const
+{
+    return m_lengthFieldSize;
+}
+
+/**
+ * Returns @c true if the length field of length-prefixed frames is transmitted with
+ * the most significant byte first.
+ */
+bool Manager::lengthFieldBigEndian() const
+{
+    return m_lengthFieldBigEndian;
+}
+
+/**
+ * Returns the method used by the reader to find frames in the received data, check the
+ * @c Reader::setFrameMode() function for more information.
+ */
+Reader::FrameMode Manager::frameMode() const
+{
+    return m_frameMode;
+}
+
+/**
+ * Returns the action that the reader takes when the receive buffer is full, check the
+ * @c Reader::setOverflowPolicy() function for more information.
+ */
+Reader::OverflowPolicy Manager::overflowPolicy() const
+{
+    return m_overflowPolicy;
+}
+
 /**
  * Returns a pointer to the currently selected device.
  *
@@ -210,6 +610,15 @@ Manager::DataSource Manager::dataSource() const
     return m_dataSource;
 }
 
+/**
+ * Returns the fixed header that precedes the length field of length-prefixed frames
+ * as a string of hexadecimal bytes (e.g. "AA 55").
+ */
+QString Manager::frameHeader() const
+{
+    return QString::fromLatin1(m_frameHeader.toHex(' ').toUpper());
+}
+
 /**
  * Returns the start sequence string used by the application to know where to consider
  * that a frame begins. If the start sequence is empty, then the application shall ignore
@@ -262,6 +671,49 @@ QString Manager::receivedDataLength() const
     return QString("%1 %2").arg(value).arg(units);
 }
 
+/**
+ * Returns a list with the possible frame detection modes.
+ */
+QStringList Manager::frameModesList() const
+{
+    QStringList list;
+    list.append(tr("Start/end delimiters"));
+    list.append(tr("Length-prefixed"));
+    list.append(tr("COBS"));
+    list.append(tr("SLIP"));
+    list.append(tr("Idle time between frames"));
+    return list;
+}
+
+/**
+ * Returns a list with the possible frame checksum algorithms.
+ */
+QStringList Manager::checksumAlgorithmsList() const
+{
+    QStringList list;
+    list.append(tr("None"));
+    list.append(tr("XOR-8"));
+    list.append(tr("CRC-8"));
+    list.append(tr("CRC-16/MODBUS"));
+    list.append(tr("CRC-16/CCITT"));
+    list.append(tr("CRC-32"));
+    list.append(tr("CRC-32C"));
+    list.append(tr("Fletcher-16"));
+    list.append(tr("Custom CRC"));
+    return list;
+}
+
+/**
+ * Returns a list with the possible ingest modes.
+ */
+QStringList Manager::ingestModesList() const
+{
+    QStringList list;
+    list.append(tr("Low latency"));
+    list.append(tr("High throughput"));
+    return list;
+}
+
 /**
  * Returns a list with the possible data source options.
  */
@@ -274,17 +726,86 @@ QStringList Manager::dataSourcesList() const
     return list;
 }
 
+/**
+ * Returns a list with the types of additional data sources, the index of each type is
+ * used by the @c sourceEntry() function.
+ */
+QStringList Manager::sourceTypesList() const
+{
+    QStringList list;
+    list.append(tr("Serial port"));
+    list.append(tr("TCP socket"));
+    list.append(tr("UDP socket"));
+    list.append(tr("File path"));
+    return list;
+}
+
+/**
+ * Builds an entry for the additional data source list from the given source @a type
+ * (index of @c sourceTypesList()), @a address (port name, host or path) and
+ * @a parameter (baud rate or network port, ignored for files).
+ *
+ * @returns an empty string if the given configuration is not valid
+ */
+QString Manager::sourceEntry(const int type, const QString &address,
+                             const int parameter) const
+{
+    const auto addr = address.trimmed();
+    if (addr.isEmpty())
+        return "";
+
+    switch (type)
+    {
+        case 0:
+            if (parameter > 0)
+                return QString("serial:%1@%2").arg(addr).arg(parameter);
+            break;
+        case 1:
+            if (parameter > 0 && parameter <= 65535)
+                return QString("tcp:%1:%2").arg(addr).arg(parameter);
+            break;
+        case 2:
+            if (parameter > 0 && parameter <= 65535)
+                return QString("udp:%1:%2").arg(addr).arg(parameter);
+            break;
+        case 3:
+            return QString("file:%1").arg(addr);
+        default:
+            break;
+    }
+
+    return "";
+}
+
+/**
+ * Returns a list with the possible receive buffer overflow policies.
+ */
+QStringList Manager::overflowPoliciesList() const
+{
+    QStringList list;
+    list.append(tr("Drop oldest data"));
+    list.append(tr("Resync to next frame"));
+    list.append(tr("Clear buffer"));
+    return list;
+}
+
 /**
  * Tries to write the given @a data to the current device. Upon data write, the class
  * emits the @a tx() signal for UI updating.
  *
+ * @note The device lives in the reader thread, so the write operation is performed
+ *       by the reader object & this function blocks until it finishes.
+ *
  * @returns the number of bytes written to the target device
  */
 qint64 Manager::writeData(const QByteArray &data)
 {
     if (connected())
     {
-        qint64 bytes = device()->write(data);
+        qint64 bytes = -1;
+        QMetaObject::invokeMethod(
+            m_reader, [&] { bytes = m_reader->write(data); },
+            Qt::BlockingQueuedConnection);
 
         if (bytes > 0)
         {
@@ -344,16 +865,17 @@ void Manager::connectDevice()
             mode = QIODevice::ReadWrite;
         }
 
-        // Open device
+        // Open device & hand it over to the reader thread
         if (device()->open(mode))
         {
-            connect(device(), &QIODevice::readyRead, this, &Manager::onDataReceived);
-
-            ///@todo try to find a way in Qt to identify if a file is a plain file
-            ///      or a named pipe.
-            if (dataSource() == DataSource::File) {
-                onDataReceived();
-            }
+            auto dev = device();
+            auto reader = m_reader;
+            dev->moveToThread(&m_readerThread);
+            QMetaObject::invokeMethod(
+                reader, [=] { reader->attach(dev); }, Qt::QueuedConnection);
+
+            // Open the additional data sources
+            openSources();
         }
 
         // Error opening the device
@@ -375,8 +897,22 @@ void Manager::disconnectDevice()
 {
     if (deviceAvailable())
     {
-        // Disconnect device signals/slots
-        device()->disconnect(this, SLOT(onDataReceived()));
+        // Close the additional data sources
+        removeAllSources();
+
+        // Stop reading data & move device back to this thread
+        auto reader = m_reader;
+        auto target = thread();
+        QMetaObject::invokeMethod(
+            reader, [=] { reader->detach(target); }, Qt::BlockingQueuedConnection);
+
+        // Discard frames that were not processed yet
+        QByteArray chunk;
+        RawFrame frame;
+        while (m_reader->takeChunk(chunk))
+            continue;
+        while (m_reader->takeFrame(frame))
+            continue;
 
         // Call-appropiate interface functions
         if (dataSource() == DataSource::Serial)
@@ -389,8 +925,14 @@ void Manager::disconnectDevice()
         // Update device pointer
         m_device = nullptr;
         m_receivedBytes = 0;
-        m_dataBuffer.clear();
-        m_dataBuffer.reserve(maxBufferSize());
+        m_rxPending = true;
+        m_invalidFrames = 0;
+        m_passedFrames = 0;
+        m_failedFrames = 0;
+        m_discardedBytes = 0;
+        m_droppedChunks = 0;
+        m_droppedFrames = 0;
+        m_lastDroppedFrames = 0;
 
         // Update UI
         emit deviceChanged();
@@ -436,103 +978,256 @@ void Manager::setMaxBufferSize(const int maxBufferSize)
     m_maxBuzzerSize = maxBufferSize;
     emit maxBufferSizeChanged();
 
-    m_dataBuffer.reserve(maxBufferSize);
+    configureReaders([=](Reader *reader) { reader->setMaxBufferSize(maxBufferSize); });
 }
 
 /**
- * Changes the frame start sequence. Check the @c startSequence() function for more
- * information.
+ * Changes the method used to find frames in the received data. Check the
+ * @c frameMode() function for more information.
  */
-void Manager::setStartSequence(const QString &sequence)
+void Manager::setFrameMode(const Reader::FrameMode mode)
 {
-    m_startSequence = ADD_ESCAPE_SEQUENCES(sequence);
-    if (m_startSequence.isEmpty())
-        m_startSequence = "";
+    m_frameMode = mode;
 
-    emit startSequenceChanged();
+    configureReaders([=](Reader *reader) { reader->setFrameMode(mode); });
+
+    emit frameModeChanged();
 }
 
 /**
- * Changes the frame end sequence. Check the @c finishSequence() function for more
- * information.
+ * Changes the fixed header of length-prefixed frames, the @a header is given as a
+ * string of hexadecimal bytes (e.g. "AA 55"), non-hexadecimal characters are ignored.
  */
-void Manager::setFinishSequence(const QString &sequence)
+void Manager::setFrameHeader(const QString &header)
 {
-    m_finishSequence = ADD_ESCAPE_SEQUENCES(sequence);
-    if (m_finishSequence.isEmpty())
-        m_finishSequence = "\r\n";
+    m_frameHeader = QByteArray::fromHex(header.toLatin1());
+    updateLengthPrefix();
+}
 
-    emit finishSequenceChanged();
+/**
+ * Changes the size (in bytes) of the length field of length-prefixed frames, valid
+ * values range from 1 to 4 bytes.
+ */
+void Manager::setLengthFieldSize(const int size)
+{
+    m_lengthFieldSize = qBound(1, size, 4);
+    updateLengthPrefix();
 }
 
 /**
- * Changes the expiration interval of the watchdog timer. Check the @c watchdogInterval()
- * function for more information.
+ * Changes the byte order of the length field of length-prefixed frames.
  */
-void Manager::setWatchdogInterval(const int interval)
+void Manager::setLengthFieldBigEndian(const bool bigEndian)
 {
-    m_watchdog.setInterval(interval);
-    m_watchdog.setTimerType(Qt::PreciseTimer);
-    emit watchdogIntervalChanged();
+    m_lengthFieldBigEndian = bigEndian;
+    updateLengthPrefix();
 }
 
 /**
- * Read frames from temporary buffer, every frame that contains the appropiate start/end
- * sequence is removed from the buffer as soon as its read.
- *
- * This function also checks that the buffer size does not exceed specified size
- * limitations.
+ * Changes the idle time (in microseconds) that marks the end of a frame in idle gap
+ * frame mode, set to zero to calculate the threshold from the serial port settings.
  */
-void Manager::readFrames()
+void Manager::setIdleGap(const int microseconds)
 {
-    // No device connected, abort
-    if (!connected())
-        return;
+    m_idleGap = qMax(0, microseconds);
+    updateIdleGap();
+}
+
+/**
+ * Enables or disables receive timestamp interpolation, check the
+ * @c timestampInterpolation() function for more information.
+ */
+void Manager::setTimestampInterpolation(const bool enabled)
+{
+    m_timestampInterpolation = enabled;
+    updateLineRate();
+
+    emit timestampInterpolationChanged();
+}
+
+/**
+ * Changes the trade-off between latency & throughput used by the reader thread
+ */
+void Manager::setIngestMode(const Reader::IngestMode mode)
+{
+    m_ingestMode = mode;
 
-    // Read until start/finish combinations are not found
-    ///@note asprintf is used to enable start/finish to contain escape sequences.
-    ///@todo Qt throws a lot of FUD at the code below, but I don't know another way within Qt
-    ///      to turn escape characters into real characters
-    auto start = QString::asprintf(qPrintable(startSequence())).toUtf8();
-    auto finish = QString::asprintf(qPrintable(finishSequence())).toUtf8();
+    configureReaders([=](Reader *reader) { reader->setIngestMode(mode); });
 
-    // Read until start/finish combinations are not found
-    //auto start = startSequence().toUtf8();
-    //auto finish = finishSequence().toUtf8();
+    emit ingestModeChanged();
+}
 
-    auto cursor = m_dataBuffer;
-    auto bytes = 0;
+/**
+ * Changes the minimum number of bytes processed as a batch in coalesced ingest mode
+ */
+void Manager::setCoalescingThreshold(const int bytes)
+{
+    m_coalescingThreshold = qMax(1, bytes);
 
-    while ( ((start.length() == 0) || cursor.contains(start)) \
-          && cursor.contains(finish) )
-    {
-        // Remove the part of the buffer prior to, and including, the start sequence.
-        auto sIndex = 0;
-        if (start.length() != 0)  {
-            sIndex = cursor.indexOf(start);
-            cursor = cursor.mid(sIndex, -1);
-            bytes += sIndex;
-        }
+    auto threshold = m_coalescingThreshold;
+    configureReaders([=](Reader *reader) { reader->setCoalescingThreshold(threshold); });
 
-        // Copy a sub-buffer that goes until the finish sequence, and emit it
-        auto fIndex = cursor.indexOf(finish);
-        auto buffer = cursor.left(fIndex);
-        if (!buffer.isEmpty()) {
-            emit frameReceived(buffer);
-            ///@note might be best to simply call the function that receives the emit above
-        }
+    emit ingestModeChanged();
+}
 
-        // Remove the data including the finish sequence, from the master buffer
-        cursor = cursor.mid(fIndex + finish.length(), -1);
-        bytes += fIndex + finish.length();
-    }
+/**
+ * Changes the maximum time (in microseconds) that received data can wait before being
+ * processed in coalesced ingest mode.
+ */
+void Manager::setLatencyBudget(const int microseconds)
+{
+    m_latencyBudget = qMax(1, microseconds);
 
-    if (bytes > 0)
-        m_dataBuffer.remove(0, bytes);
+    auto budget = static_cast<qint64>(m_latencyBudget) * 1000;
+    configureReaders([=](Reader *reader) { reader->setLatencyBudget(budget); });
+
+    emit ingestModeChanged();
+}
+
+/**
+ * Changes the algorithm used to validate the integrity of received frames, frames with
+ * an invalid checksum are discarded by the reader thread.
+ */
+void Manager::setChecksumAlgorithm(const Checksum::Algorithm algorithm)
+{
+    m_checksum.setAlgorithm(algorithm);
+    updateChecksum();
+}
+
+/**
+ * Changes the location of the checksum field in each frame
+ */
+void Manager::setChecksumPosition(const Checksum::Position position)
+{
+    m_checksum.setPosition(position);
+    updateChecksum();
+}
+
+/**
+ * Changes the byte order of binary checksum fields
+ */
+void Manager::setChecksumBigEndian(const bool bigEndian)
+{
+    m_checksum.setBigEndian(bigEndian);
+    updateChecksum();
+}
+
+/**
+ * Changes the encoding of the checksum field (binary or ASCII hexadecimal digits)
+ */
+void Manager::setChecksumAsciiHex(const bool asciiHex)
+{
+    m_checksum.setAsciiHex(asciiHex);
+    updateChecksum();
+}
+
+/**
+ * Changes the width (8 to 32 bits) of the CRC & selects the custom CRC algorithm
+ */
+void Manager::setCrcWidth(const int width)
+{
+    auto parameters = m_checksum.crcParameters();
+    parameters.width = width;
+    setCustomCrc(parameters);
+}
+
+/**
+ * Changes the polynomial (given as a hexadecimal string, without the implicit most
+ * significant bit) of the CRC & selects the custom CRC algorithm.
+ */
+void Manager::setCrcPolynomial(const QString &polynomial)
+{
+    auto parameters = m_checksum.crcParameters();
+    parameters.polynomial = HEX_VALUE(polynomial);
+    setCustomCrc(parameters);
+}
+
+/**
+ * Changes the initial value (given as a hexadecimal string) of the CRC & selects the
+ * custom CRC algorithm.
+ */
+void Manager::setCrcInit(const QString &init)
+{
+    auto parameters = m_checksum.crcParameters();
+    parameters.init = HEX_VALUE(init);
+    setCustomCrc(parameters);
+}
+
+/**
+ * Changes the final XOR value (given as a hexadecimal string) of the CRC & selects the
+ * custom CRC algorithm.
+ */
+void Manager::setCrcXorOut(const QString &xorOut)
+{
+    auto parameters = m_checksum.crcParameters();
+    parameters.xorOut = HEX_VALUE(xorOut);
+    setCustomCrc(parameters);
+}
+
+/**
+ * Changes the bit order of the CRC & selects the custom CRC algorithm
+ */
+void Manager::setCrcReflected(const bool reflected)
+{
+    auto parameters = m_checksum.crcParameters();
+    parameters.reflected = reflected;
+    setCustomCrc(parameters);
+}
+
+/**
+ * Changes the receive buffer overflow policy. Check the @c overflowPolicy() function
+ * for more information.
+ */
+void Manager::setOverflowPolicy(const Reader::OverflowPolicy policy)
+{
+    m_overflowPolicy = policy;
+
+    configureReaders([=](Reader *reader) { reader->setOverflowPolicy(policy); });
+
+    emit overflowPolicyChanged();
+}
+
+/**
+ * Changes the frame start sequence. Check the @c startSequence() function for more
+ * information.
+ */
+void Manager::setStartSequence(const QString &sequence)
+{
+    m_startSequence = ADD_ESCAPE_SEQUENCES(sequence);
+    if (m_startSequence.isEmpty())
+        m_startSequence = "";
+
+    auto start = m_startSequence.toUtf8();
+    configureReaders([=](Reader *reader) { reader->setStartSequence(start); });
+
+    emit startSequenceChanged();
+}
+
+/**
+ * Changes the frame end sequence. Check the @c finishSequence() function for more
+ * information.
+ */
+void Manager::setFinishSequence(const QString &sequence)
+{
+    m_finishSequence = ADD_ESCAPE_SEQUENCES(sequence);
+    if (m_finishSequence.isEmpty())
+        m_finishSequence = "\r\n";
 
-    // Clear temp. buffer (e.g. device sends a lot of invalid data)
-    if (m_dataBuffer.size() > maxBufferSize())
-        clearTempBuffer();
+    auto finish = m_finishSequence.toUtf8();
+    configureReaders([=](Reader *reader) { reader->setFinishSequence(finish); });
+
+    emit finishSequenceChanged();
+}
+
+/**
+ * Changes the expiration interval of the watchdog timer. Check the @c watchdogInterval()
+ * function for more information.
+ */
+void Manager::setWatchdogInterval(const int interval)
+{
+    m_watchdog.setInterval(interval);
+    m_watchdog.setTimerType(Qt::PreciseTimer);
+    emit watchdogIntervalChanged();
 }
 
 /**
@@ -546,26 +1241,48 @@ void Manager::feedWatchdog()
 }
 
 /**
- * Reads incoming data from the serial device, updates the serial console object,
- * registers incoming data to temporary buffer & extracts valid data frames from the
- * buffer using the @c readFrame() function.
+ * Called (in a batched manner) when the reader thread has extracted new frames or read
+ * new data from the device. Updates the serial console object, notifies the rest of
+ * the application about the received frames & updates the received bytes indicator.
  */
 void Manager::onDataReceived()
 {
-    // Verify that device is still valid
-    if (!device())
-        disconnectDevice();
+    QByteArray data;
+    RawFrame frame;
+    quint64 bytes = 0;
+
+    // Let the readers know that we are processing their data
+    m_reader->acknowledge();
+    for (auto source : m_sources)
+        source->reader()->acknowledge();
 
-    // Read data & append it to buffer
-    auto data = device()->readAll();
-    auto bytes = data.length();
+    // Process data from the main device
+    if (connected())
+    {
+        // Feed watchdog (so that data is not cleared automatically)
+        feedWatchdog();
+
+        // Send raw data to the console
+        while (m_reader->takeChunk(data))
+        {
+            bytes += data.length();
+            emit dataReceived(data);
+        }
 
-    // Feed watchdog (so that data is not cleared automatically)
-    feedWatchdog();
+        // Send extracted frames to the JSON generator
+        while (m_reader->takeFrame(frame))
+            emit frameReceived(frame.data, frame.timestamp, frame.sourceId);
+    }
 
-    // Obtain frames from data buffer
-    m_dataBuffer.append(data);
-    readFrames();
+    // Process data from additional sources (raw data is not shown in the console)
+    for (auto source : m_sources)
+    {
+        auto reader = source->reader();
+        while (reader->takeChunk(data))
+            bytes += data.length();
+        while (reader->takeFrame(frame))
+            emit frameReceived(frame.data, frame.timestamp, frame.sourceId);
+    }
 
     // Update received bytes indicator
     ///@todo probably a wise idea to enforce a buffer limitation smaller than UINT64_MAX...
@@ -573,20 +1290,343 @@ void Manager::onDataReceived()
     if (m_receivedBytes >= UINT64_MAX)
         m_receivedBytes = 0;
 
-    // Notify user interface
-    emit receivedBytesChanged();
-    emit dataReceived(data);
-    emit rx();
+    // User interface is notified at display rate by updateIndicators()
+    if (bytes > 0)
+        m_rxPending = true;
+}
+
+/**
+ * Called at display rate (42 Hz), notifies the user interface about received data &
+ * updates the reader statistics indicators. This avoids re-evaluating QML bindings for
+ * every batch of received data at high data rates.
+ */
+void Manager::updateIndicators()
+{
+    // Notify user interface about received data
+    if (m_rxPending)
+    {
+        m_rxPending = false;
+        emit receivedBytesChanged();
+        emit rx();
+    }
+
+    // Sum the counters of all readers
+    quint64 discarded = 0;
+    quint64 droppedFrames = 0;
+    quint64 invalid = 0;
+    quint64 passed = 0;
+    quint64 failed = 0;
+    for (auto reader : readers())
+    {
+        discarded += reader->discardedBytes();
+        droppedFrames += reader->droppedFrames();
+        invalid += reader->invalidFrames();
+        passed += reader->passedFrames();
+        failed += reader->failedFrames();
+    }
+
+    // Update discarded bytes indicator
+    if (discarded != m_discardedBytes)
+    {
+        m_discardedBytes = discarded;
+        emit discardedBytesChanged();
+    }
+
+    // Update dropped console chunks indicator (only the main device feeds the console)
+    const auto dropped = m_reader->droppedChunks();
+    if (dropped != m_droppedChunks)
+    {
+        m_droppedChunks = dropped;
+        emit droppedChunksChanged();
+    }
+
+    // Update dropped frames indicator
+    if (droppedFrames != m_droppedFrames)
+    {
+        m_droppedFrames = droppedFrames;
+        emit droppedFramesChanged();
+    }
+
+    // Update invalid frames indicator
+    if (invalid != m_invalidFrames)
+    {
+        m_invalidFrames = invalid;
+        emit invalidFramesChanged();
+    }
+
+    // Update frame validation counters
+    if (passed != m_passedFrames || failed != m_failedFrames)
+    {
+        m_passedFrames = passed;
+        m_failedFrames = failed;
+        emit frameValidationChanged();
+    }
+}
+
+/**
+ * Called every second, calculates the number of device notifications, device reads &
+ * frames processed per second by the reader thread.
+ */
+void Manager::updateStatistics()
+{
+    // Obtain elapsed time since last update
+    const auto elapsed = m_statisticsTimer.nsecsElapsed();
+    m_statisticsTimer.restart();
+    if (elapsed <= 0)
+        return;
+
+    // Obtain counters of all readers
+    quint64 events = 0;
+    quint64 reads = 0;
+    quint64 frames = 0;
+    for (auto reader : readers())
+    {
+        events += reader->readEvents();
+        reads += reader->deviceReads();
+        frames += reader->queuedFrames();
+    }
+
+    // Calculate rates (counters go backwards when a data source is removed)
+    const auto scale = 1e9 / elapsed;
+    m_readEventsPerSecond = qRound(qMax<qint64>(0, events - m_lastReadEvents) * scale);
+    m_deviceReadsPerSecond = qRound(qMax<qint64>(0, reads - m_lastDeviceReads) * scale);
+    m_framesPerSecond = qRound(qMax<qint64>(0, frames - m_lastQueuedFrames) * scale);
+
+    // Report frames that were lost because the frame queue was full
+    if (m_droppedFrames > m_lastDroppedFrames)
+        LOG_WARNING() << m_droppedFrames - m_lastDroppedFrames
+                      << "frames dropped, the user interface is not keeping up";
+
+    // Save counters for next update
+    m_lastDroppedFrames = m_droppedFrames;
+    m_lastReadEvents = events;
+    m_lastDeviceReads = reads;
+    m_lastQueuedFrames = frames;
+
+    // Update UI
+    emit ingestStatisticsChanged();
+}
+
+/**
+ * Sends the current idle gap threshold (in nanoseconds) to the reader threads, the
+ * threshold of each additional source depends on its own baud rate.
+ */
+void Manager::updateIdleGap()
+{
+    auto reader = m_reader;
+    auto gap = static_cast<qint64>(effectiveIdleGap()) * 1000;
+    QMetaObject::invokeMethod(reader, [=] { reader->setIdleGap(gap); }, Qt::QueuedConnection);
+
+    for (auto source : m_sources)
+    {
+        auto sourceReader = source->reader();
+        auto sourceGap = static_cast<qint64>(idleGapFor(source->baudRate())) * 1000;
+        QMetaObject::invokeMethod(
+            sourceReader, [=] { sourceReader->setIdleGap(sourceGap); },
+            Qt::QueuedConnection);
+    }
+
+    emit idleGapChanged();
+}
+
+/**
+ * Sends the current line rate (in bytes per second) to the reader threads, which use it
+ * to interpolate frame timestamps. A rate of zero disables interpolation.
+ */
+void Manager::updateLineRate()
+{
+    auto reader = m_reader;
+    auto baudRate = 0;
+    if (dataSource() == DataSource::Serial)
+        baudRate = DataSources::Serial::getInstance()->baudRate();
+
+    auto rate = lineRateFor(baudRate);
+    QMetaObject::invokeMethod(
+        reader, [=] { reader->setLineRate(rate); }, Qt::QueuedConnection);
+
+    for (auto source : m_sources)
+    {
+        auto sourceReader = source->reader();
+        auto sourceRate = lineRateFor(source->baudRate());
+        QMetaObject::invokeMethod(
+            sourceReader, [=] { sourceReader->setLineRate(sourceRate); },
+            Qt::QueuedConnection);
+    }
+}
+
+/**
+ * Returns the idle time threshold (in microseconds) for a serial device with the given
+ * @a baudRate, check the @c effectiveIdleGap() function for more information.
+ *
+ * Devices without a baud rate (e.g. network sockets) use the 1750 microseconds minimum.
+ */
+int Manager::idleGapFor(const qint32 baudRate) const
+{
+    // User-defined threshold
+    if (m_idleGap > 0)
+        return m_idleGap;
+
+    // Calculate 3.5 character times
+    if (baudRate <= 0 || baudRate > 19200)
+        return 1750;
+
+    return qCeil(3.5 * BITS_PER_CHARACTER() * 1e6 / baudRate);
+}
+
+/**
+ * Returns the line rate (in bytes per second) of a serial device with the given
+ * @a baudRate, or zero if timestamp interpolation is disabled.
+ */
+double Manager::lineRateFor(const qint32 baudRate) const
+{
+    if (!m_timestampInterpolation || baudRate <= 0)
+        return 0;
+
+    return baudRate / BITS_PER_CHARACTER();
+}
+
+/**
+ * Returns a list with the main reader & the readers of all additional sources
+ */
+QVector<Reader *> Manager::readers() const
+{
+    QVector<Reader *> list;
+    list.append(m_reader);
+    for (auto source : m_sources)
+        list.append(source->reader());
+
+    return list;
+}
+
+/**
+ * Sends the current configuration of the main reader to the reader of the given
+ * @a source, this is done before the source starts reading data.
+ */
+void Manager::configureSource(Source *source)
+{
+    Q_ASSERT(source);
+
+    auto reader = source->reader();
+    auto maxBufferSize = m_maxBuzzerSize;
+    auto frameMode = m_frameMode;
+    auto overflowPolicy = m_overflowPolicy;
+    auto header = m_frameHeader;
+    auto fieldSize = m_lengthFieldSize;
+    auto bigEndian = m_lengthFieldBigEndian;
+    auto checksum = m_checksum;
+    auto gap = static_cast<qint64>(idleGapFor(source->baudRate())) * 1000;
+    auto rate = lineRateFor(source->baudRate());
+    auto ingestMode = m_ingestMode;
+    auto threshold = m_coalescingThreshold;
+    auto budget = static_cast<qint64>(m_latencyBudget) * 1000;
+    auto start = m_startSequence.toUtf8();
+    auto finish = m_finishSequence.toUtf8();
+
+    QMetaObject::invokeMethod(
+        reader,
+        [=] {
+            reader->setMaxBufferSize(maxBufferSize);
+            reader->setFrameMode(frameMode);
+            reader->setOverflowPolicy(overflowPolicy);
+            reader->setLengthPrefix(header, fieldSize, bigEndian);
+            reader->setChecksum(checksum);
+            reader->setIdleGap(gap);
+            reader->setLineRate(rate);
+            reader->setIngestMode(ingestMode);
+            reader->setCoalescingThreshold(threshold);
+            reader->setLatencyBudget(budget);
+            reader->setStartSequence(start);
+            reader->setFinishSequence(finish);
+        },
+        Qt::QueuedConnection);
+}
+
+/**
+ * Calls the given @a function in the thread of the main reader & in the threads of
+ * the readers of all additional sources.
+ */
+template<typename Function>
+void Manager::configureReaders(Function function)
+{
+    for (auto reader : readers())
+        QMetaObject::invokeMethod(
+            reader, [=] { function(reader); }, Qt::QueuedConnection);
+}
+
+/**
+ * Registers the given @a source, configures its reader & starts reading data from it.
+ *
+ * @returns the ID of the source, or -1 if the device could not be opened
+ */
+int Manager::addSource(const QString &name, QIODevice *device, const qint32 baudRate)
+{
+    // Device could not be opened
+    if (!device->isOpen())
+    {
+        LOG_WARNING() << "Failed to open" << name;
+        device->deleteLater();
+        return -1;
+    }
+
+    // Create source & start reading data
+    auto source = new Source(m_nextSourceId++, name, device, baudRate);
+    connect(source->reader(), &Reader::dataAvailable, this, &Manager::onDataReceived,
+            Qt::QueuedConnection);
+    configureSource(source);
+    source->start();
+
+    // Update UI
+    m_sources.append(source);
+    emit sourcesChanged();
+
+    // Log changes
+    LOG_INFO() << "Added data source" << source->id() << name;
+    return source->id();
+}
+
+/**
+ * Sends a copy of the current frame checksum configuration to the reader thread.
+ */
+void Manager::updateChecksum()
+{
+    auto checksum = m_checksum;
+    configureReaders([=](Reader *reader) { reader->setChecksum(checksum); });
+
+    emit checksumChanged();
+}
+
+/**
+ * Selects a custom CRC algorithm with the given @a parameters
+ */
+void Manager::setCustomCrc(const Checksum::CrcParameters &parameters)
+{
+    m_checksum.setCustomCrc(parameters);
+    updateChecksum();
+}
+
+/**
+ * Sends the current length-prefixed frame format to the reader thread.
+ */
+void Manager::updateLengthPrefix()
+{
+    auto header = m_frameHeader;
+    auto fieldSize = m_lengthFieldSize;
+    auto bigEndian = m_lengthFieldBigEndian;
+    configureReaders(
+        [=](Reader *reader) { reader->setLengthPrefix(header, fieldSize, bigEndian); });
+
+    emit lengthPrefixChanged();
 }
 
 /**
- * Deletes the contents of the temporary buffer. This function is called automatically by
- * the class when the temporary buffer size exceeds the limit imposed by the
- * @c maxBufferSize() function.
+ * Deletes the contents of the temporary buffer of the reader thread. This is done
+ * automatically by the reader when the temporary buffer size exceeds the limit imposed
+ * by the @c maxBufferSize() function.
  */
 void Manager::clearTempBuffer()
 {
-    m_dataBuffer.clear();
+    auto reader = m_reader;
+    QMetaObject::invokeMethod(reader, [=] { reader->clearBuffer(); }, Qt::QueuedConnection);
 }
 
 /**
@@ -598,6 +1638,146 @@ void Manager::onWatchdogTriggered()
     clearTempBuffer();
 }
 
+/**
+ * Opens the serial port with the given @a portName & @a baudRate as an additional data
+ * source. The rest of the port settings (data bits, parity, stop bits & flow control)
+ * are the same as the ones of the main serial port.
+ *
+ * @returns the ID of the source, or -1 if the port could not be opened
+ */
+int Manager::addSerialSource(const QString &portName, const qint32 baudRate)
+{
+    auto serial = DataSources::Serial::getInstance();
+    auto port = new QSerialPort(portName);
+    port->setBaudRate(baudRate);
+    port->setParity(serial->parity());
+    port->setDataBits(serial->dataBits());
+    port->setStopBits(serial->stopBits());
+    port->setFlowControl(serial->flowControl());
+    port->open(m_writeEnabled ? QIODevice::ReadWrite : QIODevice::ReadOnly);
+
+    return addSource(portName, port, baudRate);
+}
+
+/**
+ * Connects to the given @a host & @a port (using TCP or UDP) as an additional data
+ * source.
+ *
+ * @returns the ID of the source, or -1 if the socket could not be opened
+ */
+int Manager::addNetworkSource(const QString &host, const quint16 port, const bool udp)
+{
+    QAbstractSocket *socket;
+    if (udp)
+        socket = new QUdpSocket;
+    else
+        socket = new QTcpSocket;
+
+    const auto mode = m_writeEnabled ? QIODevice::ReadWrite : QIODevice::ReadOnly;
+    socket->connectToHost(host, port, mode);
+
+    return addSource(QString("%1:%2").arg(host).arg(port), socket);
+}
+
+/**
+ * Opens the file or named pipe at the given @a path as an additional data source
+ *
+ * @returns the ID of the source, or -1 if the file could not be opened
+ */
+int Manager::addFileSource(const QString &path)
+{
+    auto file = new QFile(path);
+    file->open(QIODevice::ReadOnly);
+
+    return addSource(QFileInfo(path).fileName(), file);
+}
+
+/**
+ * Stops reading data from the additional source with the given @a id & closes its
+ * device.
+ */
+void Manager::removeSource(const int id)
+{
+    for (int i = 0; i < m_sources.count(); ++i)
+    {
+        auto source = m_sources.at(i);
+        if (source->id() == id)
+        {
+            m_sources.removeAt(i);
+            delete source;
+
+            emit sourcesChanged();
+            break;
+        }
+    }
+}
+
+/**
+ * Stops reading data from all the additional sources
+ */
+void Manager::removeAllSources()
+{
+    if (m_sources.isEmpty())
+        return;
+
+    qDeleteAll(m_sources);
+    m_sources.clear();
+    emit sourcesChanged();
+}
+
+/**
+ * Changes the list of additional data sources, check the @c sourceList() function for
+ * more information. If the main device is connected, the sources are re-opened.
+ */
+void Manager::setSourceList(const QStringList &list)
+{
+    if (m_sourceList == list)
+        return;
+
+    m_sourceList = list;
+    emit sourceListChanged();
+
+    if (connected())
+    {
+        removeAllSources();
+        openSources();
+    }
+}
+
+/**
+ * Opens all the additional data sources registered with @c setSourceList(), invalid
+ * entries are ignored.
+ */
+void Manager::openSources()
+{
+    for (const auto &entry : qAsConst(m_sourceList))
+    {
+        const auto type = entry.section(':', 0, 0);
+        const auto value = entry.section(':', 1);
+
+        if (type == "serial")
+        {
+            const auto separator = value.lastIndexOf('@');
+            if (separator > 0)
+                addSerialSource(value.left(separator), value.mid(separator + 1).toInt());
+        }
+
+        else if (type == "tcp" || type == "udp")
+        {
+            const auto separator = value.lastIndexOf(':');
+            if (separator > 0)
+                addNetworkSource(value.left(separator), value.mid(separator + 1).toUShort(),
+                                 type == "udp");
+        }
+
+        else if (type == "file")
+            addFileSource(value);
+
+        else
+            LOG_WARNING() << "Invalid data source" << entry;
+    }
+}
+
 /**
  * Changes the target device pointer. Deletion should be handled by the interface
  * implementation, not by this class.
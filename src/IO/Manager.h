@@ -25,7 +25,13 @@
 
 #include <QTimer>
 #include <QObject>
+#include <QThread>
+#include <QElapsedTimer>
 #include <QIODevice>
+#include <QVector>
+
+#include "Reader.h"
+#include "Source.h"
 
 namespace IO
 {
@@ -63,6 +69,119 @@ class Manager : public QObject
     Q_PROPERTY(bool configurationOk
                READ configurationOk
                NOTIFY configurationChanged)
+    Q_PROPERTY(IO::Reader::OverflowPolicy overflowPolicy
+               READ overflowPolicy
+               WRITE setOverflowPolicy
+               NOTIFY overflowPolicyChanged)
+    Q_PROPERTY(quint64 discardedBytes
+               READ discardedBytes
+               NOTIFY discardedBytesChanged)
+    Q_PROPERTY(quint64 droppedChunks
+               READ droppedChunks
+               NOTIFY droppedChunksChanged)
+    Q_PROPERTY(quint64 droppedFrames
+               READ droppedFrames
+               NOTIFY droppedFramesChanged)
+    Q_PROPERTY(IO::Reader::FrameMode frameMode
+               READ frameMode
+               WRITE setFrameMode
+               NOTIFY frameModeChanged)
+    Q_PROPERTY(QString frameHeader
+               READ frameHeader
+               WRITE setFrameHeader
+               NOTIFY lengthPrefixChanged)
+    Q_PROPERTY(int lengthFieldSize
+               READ lengthFieldSize
+               WRITE setLengthFieldSize
+               NOTIFY lengthPrefixChanged)
+    Q_PROPERTY(bool lengthFieldBigEndian
+               READ lengthFieldBigEndian
+               WRITE setLengthFieldBigEndian
+               NOTIFY lengthPrefixChanged)
+    Q_PROPERTY(quint64 invalidFrames
+               READ invalidFrames
+               NOTIFY invalidFramesChanged)
+    Q_PROPERTY(int idleGap
+               READ idleGap
+               WRITE setIdleGap
+               NOTIFY idleGapChanged)
+    Q_PROPERTY(int effectiveIdleGap
+               READ effectiveIdleGap
+               NOTIFY idleGapChanged)
+    Q_PROPERTY(IO::Reader::IngestMode ingestMode
+               READ ingestMode
+               WRITE setIngestMode
+               NOTIFY ingestModeChanged)
+    Q_PROPERTY(int coalescingThreshold
+               READ coalescingThreshold
+               WRITE setCoalescingThreshold
+               NOTIFY ingestModeChanged)
+    Q_PROPERTY(int latencyBudget
+               READ latencyBudget
+               WRITE setLatencyBudget
+               NOTIFY ingestModeChanged)
+    Q_PROPERTY(int readEventsPerSecond
+               READ readEventsPerSecond
+               NOTIFY ingestStatisticsChanged)
+    Q_PROPERTY(int deviceReadsPerSecond
+               READ deviceReadsPerSecond
+               NOTIFY ingestStatisticsChanged)
+    Q_PROPERTY(int framesPerSecond
+               READ framesPerSecond
+               NOTIFY ingestStatisticsChanged)
+    Q_PROPERTY(bool timestampInterpolation
+               READ timestampInterpolation
+               WRITE setTimestampInterpolation
+               NOTIFY timestampInterpolationChanged)
+    Q_PROPERTY(IO::Checksum::Algorithm checksumAlgorithm
+               READ checksumAlgorithm
+               WRITE setChecksumAlgorithm
+               NOTIFY checksumChanged)
+    Q_PROPERTY(IO::Checksum::Position checksumPosition
+               READ checksumPosition
+               WRITE setChecksumPosition
+               NOTIFY checksumChanged)
+    Q_PROPERTY(bool checksumBigEndian
+               READ checksumBigEndian
+               WRITE setChecksumBigEndian
+               NOTIFY checksumChanged)
+    Q_PROPERTY(bool checksumAsciiHex
+               READ checksumAsciiHex
+               WRITE setChecksumAsciiHex
+               NOTIFY checksumChanged)
+    Q_PROPERTY(int crcWidth
+               READ crcWidth
+               WRITE setCrcWidth
+               NOTIFY checksumChanged)
+    Q_PROPERTY(QString crcPolynomial
+               READ crcPolynomial
+               WRITE setCrcPolynomial
+               NOTIFY checksumChanged)
+    Q_PROPERTY(QString crcInit
+               READ crcInit
+               WRITE setCrcInit
+               NOTIFY checksumChanged)
+    Q_PROPERTY(QString crcXorOut
+               READ crcXorOut
+               WRITE setCrcXorOut
+               NOTIFY checksumChanged)
+    Q_PROPERTY(bool crcReflected
+               READ crcReflected
+               WRITE setCrcReflected
+               NOTIFY checksumChanged)
+    Q_PROPERTY(quint64 passedFrames
+               READ passedFrames
+               NOTIFY frameValidationChanged)
+    Q_PROPERTY(quint64 failedFrames
+               READ failedFrames
+               NOTIFY frameValidationChanged)
+    Q_PROPERTY(QStringList sources
+               READ sources
+               NOTIFY sourcesChanged)
+    Q_PROPERTY(QStringList sourceList
+               READ sourceList
+               WRITE setSourceList
+               NOTIFY sourceListChanged)
     // clang-format on
 
 signals:
@@ -76,13 +195,29 @@ signals:
     void configurationChanged();
     void receivedBytesChanged();
     void maxBufferSizeChanged();
+    void overflowPolicyChanged();
+    void discardedBytesChanged();
+    void droppedChunksChanged();
+    void droppedFramesChanged();
+    void frameModeChanged();
+    void lengthPrefixChanged();
+    void idleGapChanged();
+    void timestampInterpolationChanged();
+    void ingestModeChanged();
+    void ingestStatisticsChanged();
+    void invalidFramesChanged();
+    void checksumChanged();
+    void frameValidationChanged();
     void startSequenceChanged();
     void finishSequenceChanged();
     void watchdogIntervalChanged();
     void frameValidationRegexChanged();
     void dataSent(const QByteArray &data);
     void dataReceived(const QByteArray &data);
-    void frameReceived(const QByteArray &frame);
+    void sourcesChanged();
+    void sourceListChanged();
+    void frameReceived(const QByteArray &frame, const qint64 timestamp,
+                       const int sourceId);
 
 public:
     enum class DataSource
@@ -103,17 +238,64 @@ public:
 
     int maxBufferSize() const;
     int watchdogInterval() const;
+    int idleGap() const;
+    int effectiveIdleGap() const;
+    bool timestampInterpolation() const;
+    Reader::IngestMode ingestMode() const;
+    int coalescingThreshold() const;
+    int latencyBudget() const;
+    int readEventsPerSecond() const;
+    int deviceReadsPerSecond() const;
+    int framesPerSecond() const;
+    int lengthFieldSize() const;
+    bool lengthFieldBigEndian() const;
+    quint64 invalidFrames() const;
+    quint64 passedFrames() const;
+    quint64 failedFrames() const;
+    quint64 discardedBytes() const;
+    quint64 droppedChunks() const;
+    quint64 droppedFrames() const;
+    Reader::FrameMode frameMode() const;
+    Reader::OverflowPolicy overflowPolicy() const;
+
+    Checksum::Algorithm checksumAlgorithm() const;
+    Checksum::Position checksumPosition() const;
+    bool checksumBigEndian() const;
+    bool checksumAsciiHex() const;
+    int crcWidth() const;
+    QString crcPolynomial() const;
+    QString crcInit() const;
+    QString crcXorOut() const;
+    bool crcReflected() const;
 
     QIODevice *device();
     DataSource dataSource() const;
 
+    QString frameHeader() const;
     QString startSequence() const;
     QString finishSequence() const;
     QString receivedDataLength() const;
 
+    QStringList sources() const;
+    QStringList sourceList() const;
+    int auxiliarySourceCount() const;
+    QString sourceName(const int id) const;
+
+    Q_INVOKABLE QStringList frameModesList() const;
+    Q_INVOKABLE QStringList ingestModesList() const;
+    Q_INVOKABLE QStringList checksumAlgorithmsList() const;
     Q_INVOKABLE QStringList dataSourcesList() const;
+    Q_INVOKABLE QStringList sourceTypesList() const;
+    Q_INVOKABLE QString sourceEntry(const int type, const QString &address,
+                                    const int parameter) const;
+    Q_INVOKABLE QStringList overflowPoliciesList() const;
     Q_INVOKABLE qint64 writeData(const QByteArray &data);
 
+    Q_INVOKABLE int addSerialSource(const QString &portName, const qint32 baudRate);
+    Q_INVOKABLE int addNetworkSource(const QString &host, const quint16 port,
+                                     const bool udp = false);
+    Q_INVOKABLE int addFileSource(const QString &path);
+
 public slots:
     void connectDevice();
     void toggleConnection();
@@ -121,32 +303,103 @@ public slots:
     void setWriteEnabled(const bool enabled);
     void setDataSource(const DataSource source);
     void setMaxBufferSize(const int maxBufferSize);
+    void setFrameMode(const IO::Reader::FrameMode mode);
+    void setOverflowPolicy(const IO::Reader::OverflowPolicy policy);
+    void setFrameHeader(const QString &header);
+    void setLengthFieldSize(const int size);
+    void setLengthFieldBigEndian(const bool bigEndian);
+    void setIdleGap(const int microseconds);
+    void setTimestampInterpolation(const bool enabled);
+    void setIngestMode(const IO::Reader::IngestMode mode);
+    void setCoalescingThreshold(const int bytes);
+    void setLatencyBudget(const int microseconds);
+    void setChecksumAlgorithm(const IO::Checksum::Algorithm algorithm);
+    void setChecksumPosition(const IO::Checksum::Position position);
+    void setChecksumBigEndian(const bool bigEndian);
+    void setChecksumAsciiHex(const bool asciiHex);
+    void setCrcWidth(const int width);
+    void setCrcPolynomial(const QString &polynomial);
+    void setCrcInit(const QString &init);
+    void setCrcXorOut(const QString &xorOut);
+    void setCrcReflected(const bool reflected);
     void setStartSequence(const QString &sequence);
     void setFinishSequence(const QString &sequence);
     void setWatchdogInterval(const int interval = 15);
+    void removeSource(const int id);
+    void removeAllSources();
+    void setSourceList(const QStringList &list);
 
 private slots:
-    void readFrames();
     void feedWatchdog();
     void onDataReceived();
     void clearTempBuffer();
     void onWatchdogTriggered();
+    void updateIdleGap();
+    void updateIndicators();
+    void updateStatistics();
+    void updateLineRate();
+    void updateChecksum();
+    void updateLengthPrefix();
+    void setCustomCrc(const Checksum::CrcParameters &parameters);
     void setDevice(QIODevice *device);
 
 private:
     Manager();
     ~Manager();
 
+    int idleGapFor(const qint32 baudRate) const;
+    double lineRateFor(const qint32 baudRate) const;
+
+    void openSources();
+    QVector<Reader *> readers() const;
+    void configureSource(Source *source);
+    int addSource(const QString &name, QIODevice *device, const qint32 baudRate = 0);
+
+    template<typename Function>
+    void configureReaders(Function function);
+
 private:
     QTimer m_watchdog;
     bool m_writeEnabled;
     int m_maxBuzzerSize;
+    Reader *m_reader;
     QIODevice *m_device;
+    QThread m_readerThread;
     DataSource m_dataSource;
-    QByteArray m_dataBuffer;
     quint64 m_receivedBytes;
+    quint64 m_invalidFrames;
+    quint64 m_passedFrames;
+    quint64 m_failedFrames;
+    Checksum m_checksum;
+    quint64 m_discardedBytes;
+    quint64 m_droppedChunks;
+    quint64 m_droppedFrames;
+    quint64 m_lastDroppedFrames;
+    Reader::FrameMode m_frameMode;
+    Reader::OverflowPolicy m_overflowPolicy;
+    QByteArray m_frameHeader;
+    int m_idleGap;
+    bool m_timestampInterpolation;
+    bool m_rxPending;
+
+    Reader::IngestMode m_ingestMode;
+    int m_coalescingThreshold;
+    int m_latencyBudget;
+    int m_readEventsPerSecond;
+    int m_deviceReadsPerSecond;
+    int m_framesPerSecond;
+    quint64 m_lastReadEvents;
+    quint64 m_lastDeviceReads;
+    quint64 m_lastQueuedFrames;
+    QElapsedTimer m_statisticsTimer;
+    int m_lengthFieldSize;
+    bool m_lengthFieldBigEndian;
     QString m_startSequence;
     QString m_finishSequence;
+
+    int m_nextSourceId;
+    QStringList m_sourceList;
+    QVector<Source *> m_sources;
 };
 }
 
@@ -0,0 +1,908 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Reader.h"
+#include "Search.h"
+#include "Framing.h"
+
+#include <QTimer>
+#include <QThread>
+
+#include <chrono>
+
+using namespace IO;
+
+/**
+ * Returns the current time of the monotonic clock in nanoseconds. Unlike the wall
+ * clock, this clock never jumps when the system time is adjusted, so it can be used
+ * to measure the time between received chunks.
+ */
+static inline qint64 MONOTONIC_NS()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Constructor function
+ */
+Reader::Reader()
+    : m_sourceId(0)
+    , m_device(nullptr)
+    , m_buffer(1024 * 1024)
+    , m_overflowPolicy(OverflowPolicy::Resync)
+    , m_frameMode(FrameMode::Delimiter)
+    , m_lengthFieldSize(2)
+    , m_bigEndian(true)
+    , m_idleGap(1750000)
+    , m_lastChunkTime(0)
+    , m_prevChunkTime(0)
+    , m_pendingBytes(0)
+    , m_nsPerByte(0)
+    , m_idleTimer(new QTimer(this))
+    , m_ingestMode(IngestMode::Immediate)
+    , m_coalescingThreshold(4096)
+    , m_lastArrivalTime(0)
+    , m_budgetTimer(new QTimer(this))
+    , m_startSequence("/*")
+    , m_finishSequence("*/")
+    , m_readPos(0)
+    , m_scanPos(0)
+    , m_frameStart(-1)
+    , m_notifyPending(0)
+    , m_droppedFrames(0)
+    , m_droppedChunks(0)
+    , m_discardedBytes(0)
+    , m_invalidFrames(0)
+    , m_passedFrames(0)
+    , m_failedFrames(0)
+    , m_readEvents(0)
+    , m_deviceReads(0)
+    , m_queuedFrames(0)
+    , m_frames(4096)
+    , m_chunks(1024)
+{
+    m_idleTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_idleTimer, &QTimer::timeout, this, &Reader::onIdleTimeout);
+    setIdleGap(m_idleGap);
+
+    m_budgetTimer->setSingleShot(true);
+    m_budgetTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_budgetTimer, &QTimer::timeout, this, &Reader::readDevice);
+    setLatencyBudget(2000000);
+}
+
+/**
+ * Returns the number of @c readyRead() notifications received from the device
+ */
+quint64 Reader::readEvents() const
+{
+    return m_readEvents.loadRelaxed();
+}
+
+/**
+ * Returns the number of times that data was read from the device & processed as a
+ * single batch. In coalesced ingest mode, this is lower than @c readEvents().
+ */
+quint64 Reader::deviceReads() const
+{
+    return m_deviceReads.loadRelaxed();
+}
+
+/**
+ * Returns the number of frames that were handed to the GUI thread
+ */
+quint64 Reader::queuedFrames() const
+{
+    return m_queuedFrames.loadRelaxed();
+}
+
+/**
+ * Returns the number of frames that were discarded because the GUI thread did not
+ * consume them fast enough (e.g. the frame queue was full).
+ */
+quint64 Reader::droppedFrames() const
+{
+    return m_droppedFrames.loadRelaxed();
+}
+
+/**
+ * Returns the number of raw data chunks that were not shown in the console because the
+ * GUI thread did not consume them fast enough (e.g. the chunk queue was full).
+ */
+quint64 Reader::droppedChunks() const
+{
+    return m_droppedChunks.loadRelaxed();
+}
+
+/**
+ * Returns the number of received bytes that were discarded because the receive buffer
+ * was full and no frame could be extracted from it (see @c setOverflowPolicy()).
+ */
+quint64 Reader::discardedBytes() const
+{
+    return m_discardedBytes.loadRelaxed();
+}
+
+/**
+ * Returns the number of frames that were discarded because they could not be decoded
+ * (e.g. invalid COBS/SLIP data).
+ */
+quint64 Reader::invalidFrames() const
+{
+    return m_invalidFrames.loadRelaxed();
+}
+
+/**
+ * Returns the number of frames that passed the checksum validation
+ */
+quint64 Reader::passedFrames() const
+{
+    return m_passedFrames.loadRelaxed();
+}
+
+/**
+ * Returns the number of frames that were discarded because their checksum did not
+ * match the checksum of the received data.
+ */
+quint64 Reader::failedFrames() const
+{
+    return m_failedFrames.loadRelaxed();
+}
+
+/**
+ * Obtains the oldest frame extracted by the reader thread.
+ *
+ * @returns @c false if there are no pending frames
+ * @note This function must only be called from the GUI thread
+ */
+bool Reader::takeFrame(RawFrame &frame)
+{
+    return m_frames.pop(frame);
+}
+
+/**
+ * Obtains the oldest chunk of raw data read by the reader thread (used by the console).
+ *
+ * @returns @c false if there are no pending chunks
+ * @note This function must only be called from the GUI thread
+ */
+bool Reader::takeChunk(QByteArray &chunk)
+{
+    return m_chunks.pop(chunk);
+}
+
+/**
+ * Lets the reader know that the consumer is about to drain the queues, any data pushed
+ * after this call shall generate a new @c dataAvailable() signal.
+ */
+void Reader::acknowledge()
+{
+    m_notifyPending.storeRelease(0);
+}
+
+/**
+ * Deletes the contents of the receive buffer
+ */
+void Reader::clearBuffer()
+{
+    m_buffer.clear();
+    resetScanner();
+}
+
+/**
+ * Changes the capacity of the receive buffer (rounded up to a power of two)
+ */
+void Reader::setMaxBufferSize(const int size)
+{
+    m_buffer.setCapacity(static_cast<quint32>(qMax(size, 1)));
+    resetScanner();
+}
+
+/**
+ * Changes the action that is taken when the receive buffer is full & no frames can be
+ * extracted from it:
+ *
+ * - @c OverflowPolicy::DropOldest discards the oldest bytes of the buffer, just enough to
+ *                                 make room for the incoming data
+ * - @c OverflowPolicy::Resync     discards data until the next start sequence, so that
+ *                                 the next frame is received in full
+ * - @c OverflowPolicy::Clear      discards the whole buffer
+ */
+void Reader::setOverflowPolicy(const OverflowPolicy policy)
+{
+    m_overflowPolicy = policy;
+}
+
+/**
+ * Starts reading data from the given @a device. The device must already live in the
+ * thread of the reader (this is done by the @c Manager class).
+ */
+void Reader::attach(QIODevice *device)
+{
+    Q_ASSERT(device);
+    Q_ASSERT(device->thread() == thread());
+
+    m_device = device;
+    m_droppedFrames.storeRelaxed(0);
+    m_droppedChunks.storeRelaxed(0);
+    m_invalidFrames.storeRelaxed(0);
+    m_passedFrames.storeRelaxed(0);
+    m_failedFrames.storeRelaxed(0);
+    m_discardedBytes.storeRelaxed(0);
+    clearBuffer();
+    connect(device, &QIODevice::readyRead, this, &Reader::onReadyRead);
+
+    ///@note files & named pipes may not emit the readyRead() signal, so we read
+    ///      the device once after attaching to it.
+    onReadyRead();
+}
+
+/**
+ * Stops reading data from the current device & moves it to the @a target thread, so
+ * that the data source interfaces can safely close/delete the device.
+ */
+void Reader::detach(QThread *target)
+{
+    if (m_device)
+    {
+        m_device->disconnect(this);
+        m_device->moveToThread(target);
+        m_device = nullptr;
+    }
+
+    m_idleTimer->stop();
+    m_budgetTimer->stop();
+    clearBuffer();
+}
+
+/**
+ * Writes the given @a data to the current device from the reader thread.
+ *
+ * @returns the number of bytes written to the device, or -1 on error
+ */
+qint64 Reader::write(const QByteArray &data)
+{
+    if (m_device && m_device->isOpen())
+        return m_device->write(data);
+
+    return -1;
+}
+
+/**
+ * Changes the method used to find frames in the received data:
+ *
+ * - @c FrameMode::Delimiter      frames are delimited by the start/finish sequences
+ * - @c FrameMode::LengthPrefixed frames start with a (optional) fixed header, followed by
+ *                                a length field & the payload
+ * - @c FrameMode::COBS           frames are COBS-encoded & terminated with a zero byte
+ * - @c FrameMode::SLIP           frames are SLIP-encoded & terminated with a 0xC0 byte
+ * - @c FrameMode::IdleGap        frames end when no data is received for a given time,
+ *                                check the @c setIdleGap() function
+ */
+void Reader::setFrameMode(const FrameMode mode)
+{
+    m_frameMode = mode;
+    m_idleTimer->stop();
+    resetScanner();
+}
+
+/**
+ * Changes the minimum time (in nanoseconds) without received data that marks the end
+ * of a frame in @c FrameMode::IdleGap mode.
+ *
+ * The reader does not re-arm a timer for each read. Instead, it stores the arrival time
+ * of each chunk & compares it with the arrival time of the next chunk, a single
+ * repeating timer (running at half of the gap) is only used to close the last frame
+ * when no more data arrives.
+ *
+ * @note Gaps are detected at chunk granularity, so the threshold should be larger than
+ *       the latency of the serial driver (e.g. the latency timer of USB adapters).
+ */
+void Reader::setIdleGap(const qint64 nanoseconds)
+{
+    m_idleGap = qMax<qint64>(nanoseconds, 1000);
+    m_idleTimer->setInterval(qMax(1, static_cast<int>(m_idleGap / 2000000)));
+}
+
+/**
+ * Changes the format of length-prefixed frames.
+ *
+ * @param header    fixed bytes that precede the length field (can be empty)
+ * @param fieldSize size of the length field in bytes (1 to 4)
+ * @param bigEndian byte order of the length field
+ */
+void Reader::setLengthPrefix(const QByteArray &header, const int fieldSize,
+                             const bool bigEndian)
+{
+    m_frameHeader = header;
+    m_lengthFieldSize = qBound(1, fieldSize, 4);
+    m_bigEndian = bigEndian;
+    resetScanner();
+}
+
+/**
+ * Changes the algorithm & format used to validate the integrity of each frame, check
+ * the @c Checksum class for more information.
+ */
+void Reader::setChecksum(const Checksum &checksum)
+{
+    m_checksum = checksum;
+}
+
+/**
+ * Changes the rate (in bytes per second) at which data is received, which is used to
+ * interpolate the receive timestamps of frames that are read in the same chunk. Set
+ * to zero to disable interpolation.
+ */
+void Reader::setLineRate(const double bytesPerSecond)
+{
+    m_nsPerByte = bytesPerSecond > 0 ? 1e9 / bytesPerSecond : 0;
+}
+
+/**
+ * Changes how the reader balances latency & throughput:
+ *
+ * - @c IngestMode::Immediate every @c readyRead() notification is processed right away,
+ *                            which gives the lowest latency
+ * - @c IngestMode::Coalesced data is processed in batches of (at least) the coalescing
+ *                            threshold, or when the latency budget expires, which
+ *                            reduces the per-chunk overhead at high data rates
+ */
+void Reader::setIngestMode(const IngestMode mode)
+{
+    m_ingestMode = mode;
+
+    if (mode == IngestMode::Immediate && m_budgetTimer->isActive())
+        readDevice();
+}
+
+/**
+ * Changes the minimum number of bytes that are processed as a batch in coalesced
+ * ingest mode.
+ */
+void Reader::setCoalescingThreshold(const int bytes)
+{
+    m_coalescingThreshold = qMax(1, bytes);
+}
+
+/**
+ * Changes the maximum time (in nanoseconds) that received data can wait before it is
+ * processed in coalesced ingest mode. The budget is rounded up to milliseconds, which
+ * is the resolution of @c QTimer.
+ */
+void Reader::setLatencyBudget(const qint64 nanoseconds)
+{
+    const auto ms = (qMax<qint64>(nanoseconds, 1) + 999999) / 1000000;
+    m_budgetTimer->setInterval(static_cast<int>(ms));
+}
+
+/**
+ * Changes the ID of the data source, which is assigned to all the extracted frames
+ */
+void Reader::setSourceId(const int id)
+{
+    m_sourceId = id;
+}
+
+/**
+ * Changes the frame start sequence. The @a sequence is given as the raw bytes that
+ * shall be searched for (escape sequences are resolved by the @c Manager class).
+ */
+void Reader::setStartSequence(const QByteArray &sequence)
+{
+    m_startSequence = sequence;
+    resetScanner();
+}
+
+/**
+ * Changes the frame finish sequence. The @a sequence is given as the raw bytes that
+ * shall be searched for (escape sequences are resolved by the @c Manager class).
+ */
+void Reader::setFinishSequence(const QByteArray &sequence)
+{
+    m_finishSequence = sequence;
+    resetScanner();
+}
+
+/**
+ * Extracts frames from the receive buffer using the selected framing mode & releases
+ * the consumed data from the ring buffer.
+ *
+ * The scanners are incremental: the buffer is never re-scanned from the beginning, the
+ * search for a delimiter resumes where the previous search stopped (minus the length
+ * of the delimiter, in case it was split between two reads). Frames are identified by
+ * their offsets in the buffer, and consumed data is only released once per call, so
+ * the cost per received byte does not depend on how many frames are in the buffer.
+ */
+void Reader::readFrames()
+{
+    // Extract frames
+    const auto data = m_buffer.data();
+    const auto size = static_cast<int>(m_buffer.size());
+    switch (m_frameMode)
+    {
+        case FrameMode::Delimiter:
+            readDelimitedFrames(data, size);
+            break;
+        case FrameMode::LengthPrefixed:
+            readLengthPrefixedFrames(data, size);
+            break;
+        case FrameMode::COBS:
+        case FrameMode::SLIP:
+            readEncodedFrames(data, size);
+            break;
+        case FrameMode::IdleGap:
+            break;
+    }
+
+    // Release consumed data from the ring buffer
+    if (m_readPos > 0)
+    {
+        m_buffer.consume(static_cast<quint32>(m_readPos));
+        m_scanPos -= m_readPos;
+        if (m_frameStart >= 0)
+            m_frameStart -= m_readPos;
+
+        m_readPos = 0;
+    }
+}
+
+/**
+ * Extracts every frame that is delimited by the start and finish sequences (without
+ * the delimiters) from the given @a data.
+ */
+void Reader::readDelimitedFrames(const char *data, const int size)
+{
+    // No finish sequence, nothing to do
+    const auto &start = m_startSequence;
+    const auto &finish = m_finishSequence;
+    if (finish.isEmpty())
+        return;
+
+    // Extract frames until start/finish combinations are not found
+    forever
+    {
+        // Find the start of the frame (skipping the start sequence)
+        if (m_frameStart < 0)
+        {
+            if (start.isEmpty())
+                m_frameStart = m_readPos;
+
+            else
+            {
+                auto sIndex = Search::indexOf(data, size, start.constData(),
+                                              start.length(), m_scanPos);
+                if (sIndex < 0)
+                {
+                    m_scanPos = qMax(m_readPos, size - start.length() + 1);
+                    break;
+                }
+
+                m_frameStart = sIndex + start.length();
+            }
+
+            m_scanPos = m_frameStart;
+        }
+
+        // Find the end of the frame
+        auto fIndex = Search::indexOf(data, size, finish.constData(), finish.length(),
+                                      m_scanPos);
+        if (fIndex < 0)
+        {
+            m_scanPos = qMax(m_frameStart, size - finish.length() + 1);
+            break;
+        }
+
+        // Copy the frame & queue it
+        if (fIndex > m_frameStart)
+            pushFrame(data + m_frameStart, fIndex - m_frameStart,
+                      frameTimestamp(fIndex + finish.length()));
+
+        // Mark the frame (including the finish sequence) as consumed
+        m_readPos = fIndex + finish.length();
+        m_scanPos = m_readPos;
+        m_frameStart = -1;
+    }
+}
+
+/**
+ * Extracts binary frames with the following format from the given @a data:
+ *
+ *     [header (optional)] [length field (1-4 bytes)] [payload (length bytes)]
+ *
+ * If the length field contains a value that cannot possibly fit in the receive buffer,
+ * the header is considered to be a false positive & the scanner resyncs by searching
+ * for the next header.
+ */
+void Reader::readLengthPrefixedFrames(const char *data, const int size)
+{
+    const auto &header = m_frameHeader;
+    const auto fieldSize = m_lengthFieldSize;
+    const auto maxLength = m_buffer.capacity() - header.length() - fieldSize;
+
+    forever
+    {
+        // Find the header
+        if (m_frameStart < 0)
+        {
+            if (header.isEmpty())
+                m_frameStart = m_readPos;
+
+            else
+            {
+                auto hIndex = Search::indexOf(data, size, header.constData(),
+                                              header.length(), m_scanPos);
+                if (hIndex < 0)
+                {
+                    m_scanPos = qMax(m_readPos, size - header.length() + 1);
+                    break;
+                }
+
+                m_frameStart = hIndex + header.length();
+            }
+
+            m_scanPos = m_frameStart;
+        }
+
+        // Wait for the length field
+        if (size - m_frameStart < fieldSize)
+            break;
+
+        // Validate length, resync on invalid values
+        auto length = Framing::readLength(data + m_frameStart, fieldSize, m_bigEndian);
+        if (length > maxLength)
+        {
+            m_readPos = m_frameStart - header.length() + 1;
+            m_scanPos = m_readPos;
+            m_frameStart = -1;
+            continue;
+        }
+
+        // Wait for the payload
+        const auto payload = m_frameStart + fieldSize;
+        if (size - payload < static_cast<int>(length))
+            break;
+
+        // Copy the payload & queue it
+        if (length > 0)
+            pushFrame(data + payload, static_cast<int>(length),
+                      frameTimestamp(payload + static_cast<int>(length)));
+
+        // Mark the frame as consumed
+        m_readPos = payload + static_cast<int>(length);
+        m_scanPos = m_readPos;
+        m_frameStart = -1;
+    }
+}
+
+/**
+ * Extracts COBS or SLIP encoded frames from the given @a data. Both encodings guarantee
+ * that the delimiter byte never appears inside of a frame, so we only need to search
+ * for the delimiter & decode the data between two delimiters. Frames are decoded into
+ * a reusable scratch buffer, so that no memory is allocated for frames that fail the
+ * checksum validation.
+ */
+void Reader::readEncodedFrames(const char *data, const int size)
+{
+    const auto cobs = (m_frameMode == FrameMode::COBS);
+    const auto delimiter = cobs ? Framing::COBS_DELIMITER : Framing::SLIP_END;
+
+    forever
+    {
+        // Find the end of the frame
+        auto index = Search::indexOf(data, size, &delimiter, 1, m_scanPos);
+        if (index < 0)
+        {
+            m_scanPos = size;
+            break;
+        }
+
+        // Decode the frame (decoded data is never larger than the encoded data)
+        const auto length = index - m_readPos;
+        if (length > 0)
+        {
+            if (m_decodeBuffer.size() < length)
+                m_decodeBuffer.resize(length);
+
+            const auto input = data + m_readPos;
+            const auto output = m_decodeBuffer.data();
+            const auto decoded = cobs ? Framing::cobsDecode(input, length, output)
+                                      : Framing::slipDecode(input, length, output);
+
+            if (decoded > 0)
+                pushFrame(output, decoded, frameTimestamp(index + 1));
+
+            else if (decoded < 0)
+                m_invalidFrames.fetchAndAddRelaxed(1);
+        }
+
+        // Mark the frame (including the delimiter) as consumed
+        m_readPos = index + 1;
+        m_scanPos = m_readPos;
+    }
+}
+
+/**
+ * Returns the receive timestamp of a frame that ends at the given buffer position.
+ *
+ * All the bytes of a chunk are read at the same time, so by default every frame in
+ * the chunk gets the arrival time of the chunk. If the line rate is known (see
+ * @c setLineRate()), the timestamp is interpolated backwards from the arrival time
+ * using the number of bytes received after the end of the frame. Interpolated
+ * timestamps never precede the arrival time of the previous chunk.
+ */
+qint64 Reader::frameTimestamp(const int end) const
+{
+    if (m_nsPerByte <= 0)
+        return m_lastChunkTime;
+
+    const auto after = static_cast<qint64>(m_buffer.size()) - end + m_pendingBytes;
+    const auto offset = static_cast<qint64>(after * m_nsPerByte);
+    return qMax(m_prevChunkTime, m_lastChunkTime - offset);
+}
+
+/**
+ * Validates the frame with the given @a data & @a length using the configured
+ * checksum, and copies its payload (without the checksum field) to the frame queue
+ * along with its receive @a timestamp.
+ *
+ * Frames that fail validation are discarded before any memory is allocated for them.
+ * If the queue is full, the frame is discarded & the dropped frames counter is
+ * incremented.
+ */
+void Reader::pushFrame(const char *data, const int length, const qint64 timestamp)
+{
+    // Validate frame
+    int offset;
+    int payload;
+    if (!m_checksum.verify(data, length, offset, payload))
+    {
+        m_failedFrames.fetchAndAddRelaxed(1);
+        return;
+    }
+
+    // Update passed frames counter
+    if (m_checksum.isEnabled())
+        m_passedFrames.fetchAndAddRelaxed(1);
+
+    // Copy the payload & queue it
+    if (payload > 0)
+    {
+        RawFrame frame;
+        frame.data = QByteArray(data + offset, payload);
+        frame.timestamp = timestamp;
+        frame.sourceId = m_sourceId;
+        if (m_frames.push(std::move(frame)))
+            m_queuedFrames.fetchAndAddRelaxed(1);
+        else
+            m_droppedFrames.fetchAndAddRelaxed(1);
+    }
+}
+
+/**
+ * Called when the device has new data. In immediate ingest mode (or in idle gap frame
+ * mode, which depends on the arrival time of each chunk), the data is read & processed
+ * right away.
+ *
+ * In coalesced ingest mode, data is left in the buffer of the device until the
+ * coalescing threshold is reached or the latency budget expires, so that many small
+ * chunks are processed as a single batch. The budget timer is only started by the
+ * first chunk of each batch, it is not re-armed for every notification.
+ */
+void Reader::onReadyRead()
+{
+    // Verify that device is still valid
+    if (!m_device || !m_device->isOpen())
+        return;
+
+    // Register arrival time of the data
+    m_readEvents.fetchAndAddRelaxed(1);
+    m_lastArrivalTime = MONOTONIC_NS();
+
+    // Wait for more data if the batch is still small
+    if (m_ingestMode == IngestMode::Coalesced && m_frameMode != FrameMode::IdleGap)
+    {
+        if (m_device->bytesAvailable() < m_coalescingThreshold)
+        {
+            if (!m_budgetTimer->isActive())
+                m_budgetTimer->start();
+
+            return;
+        }
+    }
+
+    // Process data now
+    readDevice();
+}
+
+/**
+ * Reads all the pending data from the device, registers incoming data to temporary
+ * buffer, extracts valid data frames from the buffer using the @c readFrames()
+ * function and notifies the GUI thread.
+ */
+void Reader::readDevice()
+{
+    // Batch is being processed, no need to wait for the latency budget
+    m_budgetTimer->stop();
+
+    // Verify that device is still valid
+    if (!m_device || !m_device->isOpen())
+        return;
+
+    // Read data & append it to buffer
+    auto data = m_device->readAll();
+    if (data.isEmpty())
+        return;
+
+    // Update statistics
+    m_deviceReads.fetchAndAddRelaxed(1);
+
+    // Close the pending frame if the line was idle for longer than the threshold
+    const auto now = m_lastArrivalTime;
+    if (m_frameMode == FrameMode::IdleGap)
+    {
+        if (now - m_lastChunkTime >= m_idleGap)
+            readIdleFrame();
+
+        if (!m_idleTimer->isActive())
+            m_idleTimer->start();
+    }
+
+    // Register arrival time of the chunk
+    m_prevChunkTime = m_lastChunkTime;
+    m_lastChunkTime = now;
+
+    // Obtain frames from data buffer
+    processData(data.constData(), static_cast<quint32>(data.length()));
+
+    // Register raw data for the console
+    if (!m_chunks.push(std::move(data)))
+        m_droppedChunks.fetchAndAddRelaxed(1);
+
+    // Notify consumer
+    notify();
+}
+
+/**
+ * Called periodically while there is pending data in @c FrameMode::IdleGap mode,
+ * closes the pending frame once the line has been idle for longer than the threshold.
+ */
+void Reader::onIdleTimeout()
+{
+    // Line is still active, wait
+    const auto pending = m_buffer.size() > 0;
+    if (pending && MONOTONIC_NS() - m_lastChunkTime < m_idleGap)
+        return;
+
+    // Nothing to wait for until the next chunk is received
+    m_idleTimer->stop();
+
+    // Close the frame & notify consumer
+    if (pending)
+    {
+        readIdleFrame();
+        notify();
+    }
+}
+
+/**
+ * Registers all the data stored in the receive buffer as a single frame, used by the
+ * @c FrameMode::IdleGap mode.
+ */
+void Reader::readIdleFrame()
+{
+    const auto size = m_buffer.size();
+    if (size > 0)
+    {
+        pushFrame(m_buffer.data(), static_cast<int>(size), m_lastChunkTime);
+        m_buffer.consume(size);
+    }
+
+    resetScanner();
+}
+
+/**
+ * Appends the given @a data to the receive buffer & extracts frames from it. If the
+ * data does not fit in the buffer, it is written in pieces (extracting frames after
+ * each piece), and the overflow policy is only applied when the buffer is full and
+ * no frame could be extracted from it.
+ */
+void Reader::processData(const char *data, const quint32 bytes)
+{
+    quint32 offset = 0;
+    while (offset < bytes)
+    {
+        if (m_buffer.available() == 0)
+            handleOverflow(bytes - offset);
+
+        offset += m_buffer.append(data + offset, bytes - offset);
+        m_pendingBytes = bytes - offset;
+        readFrames();
+    }
+}
+
+/**
+ * Discards data from the full receive buffer according to the overflow policy, so that
+ * (up to) @a bytes of new data can be appended to it.
+ */
+void Reader::handleOverflow(const quint32 bytes)
+{
+    const auto size = m_buffer.size();
+    const auto lengthPrefixed = (m_frameMode == FrameMode::LengthPrefixed);
+    const auto resyncSupported = lengthPrefixed || m_frameMode == FrameMode::Delimiter;
+    const auto &start = lengthPrefixed ? m_frameHeader : m_startSequence;
+
+    quint32 discard = size;
+    switch (m_overflowPolicy)
+    {
+        // Discard only the bytes needed to store the incoming data
+        case OverflowPolicy::DropOldest:
+            discard = qMin(size, bytes);
+            break;
+
+        // Discard data until the next start sequence (skipping the current frame)
+        case OverflowPolicy::Resync:
+            if (!start.isEmpty() && resyncSupported)
+            {
+                const auto from = qMax(m_frameStart, 1);
+                const auto index = Search::indexOf(m_buffer.data(), static_cast<int>(size),
+                                                   start.constData(), start.length(), from);
+                if (index > 0)
+                    discard = static_cast<quint32>(index);
+                else if (size >= static_cast<quint32>(start.length()))
+                    discard = size - static_cast<quint32>(start.length()) + 1;
+            }
+            break;
+
+        // Discard everything
+        case OverflowPolicy::Clear:
+            break;
+    }
+
+    // Always make some room for new data
+    discard = qMax<quint32>(discard, 1);
+    m_buffer.consume(discard);
+    m_discardedBytes.fetchAndAddRelaxed(discard);
+    resetScanner();
+}
+
+/**
+ * Resets the state of the incremental frame scanner, so that the next call to
+ * @c readFrames() starts searching from the beginning of the buffer.
+ */
+void Reader::resetScanner()
+{
+    m_readPos = 0;
+    m_scanPos = 0;
+    m_frameStart = -1;
+}
+
+/**
+ * Emits the @c dataAvailable() signal if the consumer has already processed the
+ * previous notification.
+ */
+void Reader::notify()
+{
+    if (m_notifyPending.testAndSetOrdered(0, 1))
+        emit dataAvailable();
+}
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef IO_READER_H
+#define IO_READER_H
+
+#include <QTimer>
+#include <QObject>
+#include <QIODevice>
+#include <QByteArray>
+#include <QAtomicInteger>
+
+#include "Checksum.h"
+#include "SpscQueue.h"
+#include "RingBuffer.h"
+
+namespace IO
+{
+/**
+ * Frame extracted by the reader thread, along with the monotonic clock time (in
+ * nanoseconds) at which its last byte was received & the ID of the data source.
+ */
+struct RawFrame
+{
+    QByteArray data;
+    qint64 timestamp;
+    int sourceId;
+};
+
+/**
+ * Reads data from a @c QIODevice in a dedicated thread and extracts frames from the
+ * received data.
+ *
+ * The @c Manager class moves the active device to the thread of this object, so that
+ * the UART/socket buffers are drained even while the GUI thread is busy rendering.
+ * Extracted frames and raw data chunks are handed to the GUI thread through
+ * single-producer/single-consumer queues. Instead of emitting one signal per frame,
+ * the reader emits @c dataAvailable() only when the consumer has acknowledged the
+ * previous notification, which batches all frames received in the meantime.
+ *
+ * Received data is stored in a fixed-capacity @c RingBuffer. If the buffer fills up
+ * without a complete frame being found, the configured @c OverflowPolicy decides which
+ * data is discarded. Frames are validated with the configured @c Checksum before they
+ * are copied out of the ring buffer.
+ *
+ * Each frame carries the monotonic clock time at which it was read from the device,
+ * so that the timestamp does not depend on how long the frame waits in the queue.
+ */
+class Reader : public QObject
+{
+    Q_OBJECT
+
+signals:
+    void dataAvailable();
+
+public:
+    enum class OverflowPolicy
+    {
+        DropOldest,
+        Resync,
+        Clear
+    };
+    Q_ENUM(OverflowPolicy)
+
+    enum class FrameMode
+    {
+        Delimiter,
+        LengthPrefixed,
+        COBS,
+        SLIP,
+        IdleGap
+    };
+    Q_ENUM(FrameMode)
+
+    enum class IngestMode
+    {
+        Immediate,
+        Coalesced
+    };
+    Q_ENUM(IngestMode)
+
+    Reader();
+
+    quint64 readEvents() const;
+    quint64 deviceReads() const;
+    quint64 queuedFrames() const;
+
+    quint64 droppedFrames() const;
+    quint64 droppedChunks() const;
+    quint64 invalidFrames() const;
+    quint64 passedFrames() const;
+    quint64 failedFrames() const;
+    quint64 discardedBytes() const;
+
+    bool takeFrame(RawFrame &frame);
+    bool takeChunk(QByteArray &chunk);
+
+    void acknowledge();
+
+public slots:
+    void clearBuffer();
+    void setMaxBufferSize(const int size);
+    void setFrameMode(const FrameMode mode);
+    void setChecksum(const IO::Checksum &checksum);
+    void setIdleGap(const qint64 nanoseconds);
+    void setLineRate(const double bytesPerSecond);
+    void setSourceId(const int id);
+    void setIngestMode(const IngestMode mode);
+    void setCoalescingThreshold(const int bytes);
+    void setLatencyBudget(const qint64 nanoseconds);
+    void setOverflowPolicy(const OverflowPolicy policy);
+    void setLengthPrefix(const QByteArray &header, const int fieldSize,
+                         const bool bigEndian);
+    void attach(QIODevice *device);
+    void detach(QThread *target);
+    qint64 write(const QByteArray &data);
+    void setStartSequence(const QByteArray &sequence);
+    void setFinishSequence(const QByteArray &sequence);
+
+private slots:
+    void readFrames();
+    void readDevice();
+    void onReadyRead();
+    void onIdleTimeout();
+
+private:
+    void notify();
+    void resetScanner();
+    void readIdleFrame();
+    qint64 frameTimestamp(const int end) const;
+    void pushFrame(const char *data, const int length, const qint64 timestamp);
+    void readEncodedFrames(const char *data, const int size);
+    void readDelimitedFrames(const char *data, const int size);
+    void readLengthPrefixedFrames(const char *data, const int size);
+    void handleOverflow(const quint32 bytes);
+    void processData(const char *data, const quint32 bytes);
+
+private:
+    int m_sourceId;
+    QIODevice *m_device;
+    RingBuffer m_buffer;
+    OverflowPolicy m_overflowPolicy;
+
+    FrameMode m_frameMode;
+    int m_lengthFieldSize;
+    bool m_bigEndian;
+    qint64 m_idleGap;
+    qint64 m_lastChunkTime;
+    qint64 m_prevChunkTime;
+    quint32 m_pendingBytes;
+    double m_nsPerByte;
+    QTimer *m_idleTimer;
+
+    IngestMode m_ingestMode;
+    qint64 m_coalescingThreshold;
+    qint64 m_lastArrivalTime;
+    QTimer *m_budgetTimer;
+    QByteArray m_frameHeader;
+    QByteArray m_decodeBuffer;
+    Checksum m_checksum;
+    QByteArray m_startSequence;
+    QByteArray m_finishSequence;
+
+    int m_readPos;
+    int m_scanPos;
+    int m_frameStart;
+
+    QAtomicInt m_notifyPending;
+    QAtomicInteger<quint64> m_droppedFrames;
+    QAtomicInteger<quint64> m_droppedChunks;
+    QAtomicInteger<quint64> m_discardedBytes;
+    QAtomicInteger<quint64> m_invalidFrames;
+    QAtomicInteger<quint64> m_passedFrames;
+    QAtomicInteger<quint64> m_failedFrames;
+    QAtomicInteger<quint64> m_readEvents;
+    QAtomicInteger<quint64> m_deviceReads;
+    QAtomicInteger<quint64> m_queuedFrames;
+    SpscQueue<RawFrame> m_frames;
+    SpscQueue<QByteArray> m_chunks;
+};
+}
+
+#endif
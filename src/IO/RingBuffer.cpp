@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "RingBuffer.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(Q_OS_UNIX) && !defined(Q_OS_ANDROID)
+#    define RING_BUFFER_MIRRORED
+#    include <fcntl.h>
+#    include <unistd.h>
+#    include <sys/mman.h>
+#endif
+
+using namespace IO;
+
+#ifdef RING_BUFFER_MIRRORED
+/**
+ * Maps the same shared memory object of @a size bytes twice, back-to-back, into the
+ * virtual address space of the process. Returns @c nullptr on failure.
+ *
+ * @note @a size must be a multiple of the system page size.
+ */
+static char *MAP_MIRRORED(const size_t size)
+{
+    // Create an anonymous shared memory object
+    static QAtomicInt counter;
+    char name[64];
+    snprintf(name, sizeof(name), "/serial-studio-%d-%d", static_cast<int>(getpid()),
+             counter.fetchAndAddRelaxed(1));
+    auto fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0)
+        return nullptr;
+
+    // Remove the name immediately, the object lives until it is unmapped
+    shm_unlink(name);
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+    {
+        close(fd);
+        return nullptr;
+    }
+
+    // Reserve twice the required address space
+    auto addr = mmap(nullptr, 2 * size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED)
+    {
+        close(fd);
+        return nullptr;
+    }
+
+    // Map the shared memory object in both halves of the reserved space
+    auto base = static_cast<char *>(addr);
+    auto a = mmap(base, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+    auto b = mmap(base + size, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+    close(fd);
+
+    // Validate mapping
+    if (a != base || b != base + size)
+    {
+        munmap(addr, 2 * size);
+        return nullptr;
+    }
+
+    return base;
+}
+#endif
+
+/**
+ * Constructor function, allocates a buffer with (at least) the given @a capacity
+ */
+RingBuffer::RingBuffer(const quint32 capacity)
+    : m_data(nullptr)
+    , m_mask(0)
+    , m_head(0)
+    , m_size(0)
+    , m_mirrored(false)
+{
+    allocate(capacity);
+}
+
+/**
+ * Destructor function, frees the buffer memory
+ */
+RingBuffer::~RingBuffer()
+{
+    release();
+}
+
+/**
+ * Returns @c true if the buffer memory is mapped twice in the virtual address space,
+ * returns @c false if the mirror is emulated by writing every byte twice.
+ */
+bool RingBuffer::isMirrored() const
+{
+    return m_mirrored;
+}
+
+/**
+ * Returns the number of unread bytes stored in the buffer
+ */
+quint32 RingBuffer::size() const
+{
+    return m_size;
+}
+
+/**
+ * Returns the maximum number of bytes that the buffer can store
+ */
+quint32 RingBuffer::capacity() const
+{
+    return m_mask + 1;
+}
+
+/**
+ * Returns the number of bytes that can be appended before the buffer is full
+ */
+quint32 RingBuffer::available() const
+{
+    return capacity() - size();
+}
+
+/**
+ * Returns a pointer to the oldest unread byte. The returned pointer can be used to read
+ * the @c size() unread bytes as a single contiguous block, even if the data wraps
+ * around the end of the buffer.
+ *
+ * @note The pointer is invalidated by @c consume(), @c clear() & @c setCapacity().
+ */
+const char *RingBuffer::data() const
+{
+    return m_data + m_head;
+}
+
+/**
+ * Discards all the unread data of the buffer
+ */
+void RingBuffer::clear()
+{
+    m_head = 0;
+    m_size = 0;
+}
+
+/**
+ * Marks the given number of @a bytes as read, freeing space for new data
+ */
+void RingBuffer::consume(const quint32 bytes)
+{
+    const auto n = qMin(bytes, m_size);
+    m_head = (m_head + n) & m_mask;
+    m_size -= n;
+
+    if (m_size == 0)
+        m_head = 0;
+}
+
+/**
+ * Changes the capacity of the buffer, the capacity is rounded up to the next power of
+ * two. The most recent unread data is kept (as long as it fits in the new buffer).
+ */
+void RingBuffer::setCapacity(const quint32 capacity)
+{
+    // Keep a copy of the most recent data
+    const auto keep = qMin(m_size, capacity);
+    auto backup = static_cast<char *>(malloc(qMax<quint32>(keep, 1)));
+    if (backup && keep > 0)
+        memcpy(backup, data() + m_size - keep, keep);
+
+    // Allocate new buffer & restore data
+    release();
+    allocate(capacity);
+    if (backup)
+    {
+        append(backup, keep);
+        free(backup);
+    }
+}
+
+/**
+ * Appends up to @a bytes from the given @a data to the buffer.
+ *
+ * @returns the number of bytes that were actually written, which is less than @a bytes
+ *          if the buffer is full
+ */
+quint32 RingBuffer::append(const char *data, const quint32 bytes)
+{
+    const auto n = qMin(bytes, available());
+    if (n == 0)
+        return 0;
+
+    // Mirrored mapping, writes past the end of the buffer wrap around automatically
+    const auto tail = (m_head + m_size) & m_mask;
+    if (m_mirrored)
+        memcpy(m_data + tail, data, n);
+
+    // Emulated mirror, write data in both halves of the buffer
+    else
+    {
+        const auto cap = capacity();
+        const auto first = qMin(n, cap - tail);
+        memcpy(m_data + tail, data, first);
+        memcpy(m_data + tail + cap, data, first);
+        if (n > first)
+        {
+            memcpy(m_data, data + first, n - first);
+            memcpy(m_data + cap, data + first, n - first);
+        }
+    }
+
+    m_size += n;
+    return n;
+}
+
+/**
+ * Allocates a buffer with a capacity of at least @a capacity bytes. The capacity is
+ * rounded up to a power of two (and to a multiple of the page size).
+ */
+void RingBuffer::allocate(const quint32 capacity)
+{
+    quint32 size = 4096;
+#ifdef RING_BUFFER_MIRRORED
+    const auto pageSize = static_cast<quint32>(sysconf(_SC_PAGESIZE));
+    size = qMax(size, pageSize);
+#endif
+    while (size < capacity)
+        size <<= 1;
+
+    m_head = 0;
+    m_size = 0;
+    m_mask = size - 1;
+    m_mirrored = false;
+
+#ifdef RING_BUFFER_MIRRORED
+    m_data = MAP_MIRRORED(size);
+    m_mirrored = (m_data != nullptr);
+#endif
+
+    if (!m_data)
+        m_data = static_cast<char *>(malloc(2 * static_cast<size_t>(size)));
+
+    Q_CHECK_PTR(m_data);
+}
+
+/**
+ * Frees the memory used by the buffer
+ */
+void RingBuffer::release()
+{
+    if (!m_data)
+        return;
+
+#ifdef RING_BUFFER_MIRRORED
+    if (m_mirrored)
+        munmap(m_data, 2 * static_cast<size_t>(capacity()));
+    else
+        free(m_data);
+#else
+    free(m_data);
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+    m_head = 0;
+}
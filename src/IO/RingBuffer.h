@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef IO_RING_BUFFER_H
+#define IO_RING_BUFFER_H
+
+#include <QtGlobal>
+
+namespace IO
+{
+/**
+ * Fixed-capacity byte ring buffer used to store received data until frames are
+ * extracted from it.
+ *
+ * The capacity is always a power of two. The unread data is always available as a
+ * single contiguous block of memory (see @c data()), which allows the frame scanner to
+ * search for delimiters & hand out frames without ever moving the buffer contents:
+ *
+ * - On UNIX systems, the same physical pages are mapped twice, back-to-back, into the
+ *   virtual address space (a "mirrored" ring buffer), so reads past the end of the
+ *   buffer wrap around to its beginning automatically.
+ * - On other systems (or if the mapping fails), the buffer allocates twice its capacity
+ *   and every byte is written twice, emulating the mirrored mapping.
+ */
+class RingBuffer
+{
+public:
+    explicit RingBuffer(const quint32 capacity = 1024 * 1024);
+    ~RingBuffer();
+
+    bool isMirrored() const;
+    quint32 size() const;
+    quint32 capacity() const;
+    quint32 available() const;
+
+    const char *data() const;
+
+    void clear();
+    void consume(const quint32 bytes);
+    void setCapacity(const quint32 capacity);
+    quint32 append(const char *data, const quint32 bytes);
+
+private:
+    void allocate(const quint32 capacity);
+    void release();
+
+private:
+    char *m_data;
+    quint32 m_mask;
+    quint32 m_head;
+    quint32 m_size;
+    bool m_mirrored;
+};
+}
+
+#endif
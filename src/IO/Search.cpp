@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Search.h"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#    define SEARCH_X86_64
+#    include <immintrin.h>
+#    ifdef _MSC_VER
+#        include <intrin.h>
+#    endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#    define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#    define TARGET_AVX2
+#endif
+
+using namespace IO;
+
+/**
+ * Returns the index of the least significant bit set in the given @a mask.
+ * @note @a mask must not be zero.
+ */
+static inline int CTZ(const quint32 mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+/**
+ * Scalar search, uses @c memchr() to find candidates for the first byte of the needle
+ * and @c memcmp() to verify the rest of the needle.
+ */
+static int SCALAR_INDEX_OF(const char *haystack, const int size, const char *needle,
+                           const int needleSize, const int from)
+{
+    const auto first = needle[0];
+    const auto last = haystack + size - needleSize;
+
+    auto ptr = haystack + from;
+    while (ptr <= last)
+    {
+        auto match = static_cast<const char *>(memchr(ptr, first, last - ptr + 1));
+        if (!match)
+            return -1;
+
+        if (memcmp(match + 1, needle + 1, needleSize - 1) == 0)
+            return static_cast<int>(match - haystack);
+
+        ptr = match + 1;
+    }
+
+    return -1;
+}
+
+#ifdef SEARCH_X86_64
+/**
+ * SSE2 search, compares 16 candidate positions per iteration using the first & last
+ * bytes of the needle as a filter. The tail of the haystack is searched with the
+ * scalar implementation.
+ */
+static int SSE2_INDEX_OF(const char *haystack, const int size, const char *needle,
+                         const int needleSize, const int from)
+{
+    const auto first = _mm_set1_epi8(needle[0]);
+    const auto last = _mm_set1_epi8(needle[needleSize - 1]);
+
+    auto i = from;
+    for (; i + needleSize + 15 <= size; i += 16)
+    {
+        auto blockF = _mm_loadu_si128(reinterpret_cast<const __m128i *>(haystack + i));
+        auto blockL = _mm_loadu_si128(
+            reinterpret_cast<const __m128i *>(haystack + i + needleSize - 1));
+
+        auto eqF = _mm_cmpeq_epi8(first, blockF);
+        auto eqL = _mm_cmpeq_epi8(last, blockL);
+        auto mask = static_cast<quint32>(_mm_movemask_epi8(_mm_and_si128(eqF, eqL)));
+
+        while (mask != 0)
+        {
+            const auto bit = CTZ(mask);
+            const auto pos = i + bit;
+            if (memcmp(haystack + pos + 1, needle + 1, needleSize - 2) == 0)
+                return pos;
+
+            mask &= mask - 1;
+        }
+    }
+
+    return SCALAR_INDEX_OF(haystack, size, needle, needleSize, i);
+}
+
+/**
+ * AVX2 search, same algorithm as the SSE2 implementation, but compares 32 candidate
+ * positions per iteration. Only called if the CPU supports AVX2.
+ */
+TARGET_AVX2
+static int AVX2_INDEX_OF(const char *haystack, const int size, const char *needle,
+                         const int needleSize, const int from)
+{
+    const auto first = _mm256_set1_epi8(needle[0]);
+    const auto last = _mm256_set1_epi8(needle[needleSize - 1]);
+
+    auto i = from;
+    for (; i + needleSize + 31 <= size; i += 32)
+    {
+        auto blockF = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(haystack + i));
+        auto blockL = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i *>(haystack + i + needleSize - 1));
+
+        auto eqF = _mm256_cmpeq_epi8(first, blockF);
+        auto eqL = _mm256_cmpeq_epi8(last, blockL);
+        auto mask
+            = static_cast<quint32>(_mm256_movemask_epi8(_mm256_and_si256(eqF, eqL)));
+
+        while (mask != 0)
+        {
+            const auto bit = CTZ(mask);
+            const auto pos = i + bit;
+            if (memcmp(haystack + pos + 1, needle + 1, needleSize - 2) == 0)
+                return pos;
+
+            mask &= mask - 1;
+        }
+    }
+
+    return SSE2_INDEX_OF(haystack, size, needle, needleSize, i);
+}
+
+/**
+ * Returns @c true if both the CPU & the operating system support AVX2 instructions
+ */
+static bool CPU_HAS_AVX2()
+{
+#    if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+        return false;
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#    else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#    endif
+}
+#endif
+
+/**
+ * Detects the fastest search kernel supported by the current CPU
+ */
+static Search::Kernel DETECT_KERNEL()
+{
+#ifdef SEARCH_X86_64
+    if (CPU_HAS_AVX2())
+        return Search::Kernel::AVX2;
+
+    return Search::Kernel::SSE2;
+#else
+    return Search::Kernel::Scalar;
+#endif
+}
+
+/**
+ * Returns the search kernel selected for the current CPU
+ */
+Search::Kernel Search::kernel()
+{
+    static const auto KERNEL = DETECT_KERNEL();
+    return KERNEL;
+}
+
+/**
+ * Returns the name of the search kernel selected for the current CPU (used for logs)
+ */
+const char *Search::kernelName()
+{
+    switch (kernel())
+    {
+        case Kernel::AVX2:
+            return "AVX2";
+        case Kernel::SSE2:
+            return "SSE2";
+        default:
+            return "Scalar";
+    }
+}
+
+/**
+ * Returns the index of the first occurrence of @a needle (with a length of
+ * @a needleSize bytes) in the @a haystack buffer (with a length of @a size bytes),
+ * searching forward from index position @a from. Returns -1 if the needle is not found.
+ *
+ * If the needle is empty, @a from is returned (same behaviour as @c QByteArray).
+ */
+int Search::indexOf(const char *haystack, const int size, const char *needle,
+                    const int needleSize, const int from)
+{
+    // Validate arguments
+    const auto start = qMax(0, from);
+    if (needleSize <= 0)
+        return start <= size ? start : -1;
+    if (size - start < needleSize)
+        return -1;
+
+    // Single-byte needles (e.g. separators), use libc's optimized memchr()
+    if (needleSize == 1)
+    {
+        auto match = memchr(haystack + start, needle[0], size - start);
+        if (match)
+            return static_cast<int>(static_cast<const char *>(match) - haystack);
+
+        return -1;
+    }
+
+    // Select implementation
+    switch (kernel())
+    {
+#ifdef SEARCH_X86_64
+        case Kernel::AVX2:
+            return AVX2_INDEX_OF(haystack, size, needle, needleSize, start);
+        case Kernel::SSE2:
+            return SSE2_INDEX_OF(haystack, size, needle, needleSize, start);
+#endif
+        default:
+            return SCALAR_INDEX_OF(haystack, size, needle, needleSize, start);
+    }
+}
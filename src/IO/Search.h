@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef IO_SEARCH_H
+#define IO_SEARCH_H
+
+#include <QByteArray>
+
+namespace IO
+{
+/**
+ * Vectorized substring search used to find frame delimiters & value separators.
+ *
+ * On x86 CPUs the search uses SSE2 (always available on x86-64) or AVX2 (selected at
+ * runtime if the CPU supports it). The kernels compare the first & last byte of the
+ * needle against a full vector of candidate positions at once, and only verify the
+ * remaining bytes of the needle for positions where both bytes match. Other CPUs use
+ * a scalar implementation based on @c memchr().
+ */
+namespace Search
+{
+enum class Kernel
+{
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+Kernel kernel();
+const char *kernelName();
+
+int indexOf(const char *haystack, const int size, const char *needle,
+            const int needleSize, const int from = 0);
+
+/**
+ * Returns the index of the first occurrence of @a needle in @a haystack, searching
+ * forward from index position @a from. Returns -1 if @a needle is not found.
+ */
+inline int indexOf(const QByteArray &haystack, const QByteArray &needle, const int from = 0)
+{
+    return indexOf(haystack.constData(), haystack.size(), needle.constData(),
+                   needle.size(), from);
+}
+
+/**
+ * Returns the index of the first occurrence of the character @a c in @a haystack,
+ * searching forward from index position @a from. Returns -1 if @a c is not found.
+ */
+inline int indexOf(const QByteArray &haystack, const char c, const int from = 0)
+{
+    return indexOf(haystack.constData(), haystack.size(), &c, 1, from);
+}
+}
+}
+
+#endif
@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Source.h"
+
+#include <Logger.h>
+
+using namespace IO;
+
+/**
+ * Constructor function, takes ownership of the given @a device (which must already be
+ * open or connecting) & starts the thread of the reader.
+ *
+ * @param id       source ID, used to tag the frames read from the device
+ * @param name     user-visible name of the source (e.g. port name or host address)
+ * @param device   device to read data from
+ * @param baudRate baud rate of the device (zero if the device is not a serial port)
+ */
+Source::Source(const int id, const QString &name, QIODevice *device,
+               const qint32 baudRate)
+    : m_id(id)
+    , m_name(name)
+    , m_baudRate(baudRate)
+    , m_reader(new Reader)
+    , m_device(device)
+{
+    Q_ASSERT(device);
+
+    m_reader->setSourceId(id);
+    m_reader->moveToThread(&m_thread);
+    connect(&m_thread, &QThread::finished, m_reader, &QObject::deleteLater);
+    m_thread.setObjectName(QString("IO::Reader (%1)").arg(name));
+    m_thread.start(QThread::TimeCriticalPriority);
+}
+
+/**
+ * Destructor function, stops reading data, closes the device & stops the reader thread
+ */
+Source::~Source()
+{
+    // Stop reading data & move device back to this thread
+    auto reader = m_reader;
+    auto target = thread();
+    QMetaObject::invokeMethod(
+        reader, [=] { reader->detach(target); }, Qt::BlockingQueuedConnection);
+
+    // Close & delete device
+    m_device->close();
+    m_device->deleteLater();
+
+    // Stop reader thread
+    m_thread.quit();
+    m_thread.wait();
+
+    LOG_INFO() << "Disconnected from" << m_name;
+}
+
+/**
+ * Returns the ID of the source, which is assigned to all the frames read from it
+ */
+int Source::id() const
+{
+    return m_id;
+}
+
+/**
+ * Returns the user-visible name of the source
+ */
+QString Source::name() const
+{
+    return m_name;
+}
+
+/**
+ * Returns the baud rate of the source (zero if the device is not a serial port)
+ */
+qint32 Source::baudRate() const
+{
+    return m_baudRate;
+}
+
+/**
+ * Returns a pointer to the reader object, which lives in the thread of the source
+ */
+Reader *Source::reader() const
+{
+    return m_reader;
+}
+
+/**
+ * Returns a pointer to the device of the source
+ */
+QIODevice *Source::device() const
+{
+    return m_device;
+}
+
+/**
+ * Returns @c true if the device of the source is open
+ */
+bool Source::isOpen() const
+{
+    return m_device->isOpen();
+}
+
+/**
+ * Moves the device to the thread of the reader & starts reading data from it. Call
+ * this function after configuring the reader.
+ */
+void Source::start()
+{
+    auto device = m_device;
+    auto reader = m_reader;
+    device->moveToThread(&m_thread);
+    QMetaObject::invokeMethod(
+        reader, [=] { reader->attach(device); }, Qt::QueuedConnection);
+}
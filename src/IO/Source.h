@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef IO_SOURCE_H
+#define IO_SOURCE_H
+
+#include <QThread>
+#include <QObject>
+#include <QIODevice>
+
+#include "Reader.h"
+
+namespace IO
+{
+/**
+ * Additional data source that is read at the same time as the main device of the
+ * @c Manager class (e.g. several boards of a test rig streaming at once).
+ *
+ * Each source owns its device, a @c Reader object (with its own receive buffer &
+ * framing state) and the thread in which the reader runs. Frames extracted by the
+ * reader are tagged with the ID of the source, so that all the sources can share the
+ * same JSON generator & dashboard.
+ */
+class Source : public QObject
+{
+    Q_OBJECT
+
+public:
+    Source(const int id, const QString &name, QIODevice *device,
+           const qint32 baudRate = 0);
+    ~Source();
+
+    int id() const;
+    QString name() const;
+    qint32 baudRate() const;
+    Reader *reader() const;
+    QIODevice *device() const;
+
+    bool isOpen() const;
+    void start();
+
+private:
+    int m_id;
+    QString m_name;
+    qint32 m_baudRate;
+    Reader *m_reader;
+    QIODevice *m_device;
+    QThread m_thread;
+};
+}
+
+#endif
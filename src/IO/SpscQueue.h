@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef IO_SPSC_QUEUE_H
+#define IO_SPSC_QUEUE_H
+
+#include <QVector>
+#include <QAtomicInteger>
+
+namespace IO
+{
+/**
+ * Bounded, lock-free single-producer/single-consumer queue.
+ *
+ * Used to hand off data between the I/O reader thread (producer) and the GUI thread
+ * (consumer) without taking a mutex for every received frame. Only one thread may call
+ * @c push() and only one thread may call @c pop() at any given time.
+ *
+ * The capacity is rounded up to the next power of two so that indexes can be wrapped
+ * with a bit mask. The head & tail counters grow monotonically and are only masked when
+ * accessing the storage vector.
+ */
+template<typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(const quint32 capacity = 1024)
+        : m_head(0)
+        , m_tail(0)
+    {
+        quint32 size = 2;
+        while (size < capacity)
+            size <<= 1;
+
+        m_mask = size - 1;
+        m_items.resize(static_cast<int>(size));
+    }
+
+    /**
+     * Returns the maximum number of items that the queue can hold
+     */
+    quint32 capacity() const { return m_mask + 1; }
+
+    /**
+     * Returns @c true if the queue does not contain any items. The value is only a hint
+     * if called while the producer thread is active.
+     */
+    bool isEmpty() const { return m_head.loadAcquire() == m_tail.loadAcquire(); }
+
+    /**
+     * Moves the given @a item to the queue, returns @c false if the queue is full.
+     * @note Must only be called from the producer thread.
+     */
+    bool push(T &&item)
+    {
+        const auto tail = m_tail.loadRelaxed();
+        if (tail - m_head.loadAcquire() > m_mask)
+            return false;
+
+        m_items[static_cast<int>(tail & m_mask)] = std::move(item);
+        m_tail.storeRelease(tail + 1);
+        return true;
+    }
+
+    /**
+     * Copies the given @a item to the queue, returns @c false if the queue is full.
+     * @note Must only be called from the producer thread.
+     */
+    bool push(const T &item)
+    {
+        T copy = item;
+        return push(std::move(copy));
+    }
+
+    /**
+     * Moves the oldest item of the queue to @a item, returns @c false if the queue is
+     * empty.
+     * @note Must only be called from the consumer thread.
+     */
+    bool pop(T &item)
+    {
+        const auto head = m_head.loadRelaxed();
+        if (head == m_tail.loadAcquire())
+            return false;
+
+        auto &slot = m_items[static_cast<int>(head & m_mask)];
+        item = std::move(slot);
+        slot = T();
+        m_head.storeRelease(head + 1);
+        return true;
+    }
+
+    /**
+     * Removes all items from the queue.
+     * @note Must only be called from the consumer thread.
+     */
+    void clear()
+    {
+        T item;
+        while (pop(item))
+            continue;
+    }
+
+private:
+    quint32 m_mask;
+    QVector<T> m_items;
+    QAtomicInteger<quint32> m_head;
+    QAtomicInteger<quint32> m_tail;
+};
+}
+
+#endif
@@ -21,7 +21,6 @@
  */
 
 #include "Dataset.h"
-#include "Generator.h"
 
 using namespace JSON;
 
@@ -30,7 +29,10 @@ Dataset::Dataset(QObject *parent)
     , m_graph(false)
     , m_title("")
     , m_value("")
-    , m_tick("")
+    , m_number(0)
+    , m_tick(0)
+    , m_min(0)
+    , m_max(0)
     , m_units("")
     , m_widget("")
 {
@@ -60,14 +62,38 @@ QString Dataset::value() const
     return m_value;
 }
 
+/**
+ * @return The numeric value of this dataset
+ */
+double Dataset::number() const
+{
+    return m_number;
+}
+
 /**
  * @return The time value of this dataset
  */
-QString Dataset::tick() const
+double Dataset::tick() const
 {
     return m_tick;
 }
 
+/**
+ * @return The minimum value of this dataset (used by bar widgets)
+ */
+double Dataset::min() const
+{
+    return m_min;
+}
+
+/**
+ * @return The maximum value of this dataset (used by bar widgets)
+ */
+double Dataset::max() const
+{
+    return m_max;
+}
+
 /**
  * @return The units of this dataset
  */
@@ -85,56 +111,39 @@ QString Dataset::widget() const
 }
 
 /**
- * Returns the JSON data that represents this widget
+ * Reads the dataset structure from the given schema @a info & the dataset reading from
+ * the given frame @a value.
+ *
+ * @return @c true on read success, @c false on failure (empty value)
  */
-QJsonObject Dataset::jsonData() const
+bool Dataset::read(const FrameSchema::Dataset &info, const FrameValue &value)
 {
-    return m_jsonData;
+    m_graph = info.graph;
+    m_title = info.title;
+    m_units = info.units;
+    m_widget = info.widget;
+    m_min = info.min;
+    m_max = info.max;
+    m_value = value.text;
+    m_number = value.number;
+    m_tick = value.tick;
+
+    emit infoChanged();
+    emit valueChanged();
+    return !m_value.isEmpty();
 }
 
 /**
- * Reads dataset information from the given @a object and evaluates any JS code in the
- * "value" field of the dataset.
- *
- * @return @c true on read success, @c false on failure
+ * Updates the reading of the dataset with the given frame @a value, the structure of
+ * the dataset (title, units, etc.) is not modified.
  */
-bool Dataset::read(const QJsonObject &object)
+void Dataset::update(const FrameValue &value)
 {
-    static QJSEngine JAVASCRIPT_ENGINE;
-
-    if (!object.isEmpty())
+    if (m_value != value.text || m_tick != value.tick)
     {
-        auto graph = object.value("g").toVariant().toBool();
-        auto title = object.value("t").toVariant().toString();
-        auto value = object.value("v").toVariant().toString();
-        auto tick = object.value("x").toVariant().toString();
-        auto units = object.value("u").toVariant().toString();
-        auto widget = object.value("w").toVariant().toString();
-
-        title = title.replace("\n", "");
-        title = title.replace("\r", "");
-        value = value.replace("\n", "");
-        value = value.replace("\r", "");
-        tick = tick.replace("\n", "");
-        tick = tick.replace("\r", "");
-        units = units.replace("\n", "");
-        units = units.replace("\r", "");
-        widget = widget.replace("\n", "");
-        widget = widget.replace("\r", "");
-
-        if (!value.isEmpty())
-        {
-            m_graph = graph;
-            m_title = title;
-            m_units = units;
-            m_value = value;
-            m_tick = tick;
-            m_widget = widget;
-            m_jsonData = object;
-
-            return true;
-        }
+        m_value = value.text;
+        m_number = value.number;
+        m_tick = value.tick;
+        emit valueChanged();
     }
-
-    return false;
 }
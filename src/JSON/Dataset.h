@@ -25,7 +25,8 @@
 
 #include <QObject>
 #include <QVariant>
-#include <QJsonObject>
+
+#include "FrameSchema.h"
 
 namespace JSON
 {
@@ -35,48 +36,63 @@ class Dataset : public QObject
     Q_OBJECT
     Q_PROPERTY(bool graph
                READ graph
-               CONSTANT)
+               NOTIFY infoChanged)
     Q_PROPERTY(QString title
                READ title
-               CONSTANT)
+               NOTIFY infoChanged)
     Q_PROPERTY(QString value
                READ value
-               CONSTANT)
-    Q_PROPERTY(QString tick
+               NOTIFY valueChanged)
+    Q_PROPERTY(double number
+               READ number
+               NOTIFY valueChanged)
+    Q_PROPERTY(double tick
                READ tick
-               CONSTANT)
+               NOTIFY valueChanged)
     Q_PROPERTY(QString units
                READ units
-               CONSTANT)
+               NOTIFY infoChanged)
     Q_PROPERTY(QString widget
                READ widget
-               CONSTANT)
-    Q_PROPERTY(QJsonObject jsonData
-               READ jsonData
-               CONSTANT)
+               NOTIFY infoChanged)
+    Q_PROPERTY(double min
+               READ min
+               NOTIFY infoChanged)
+    Q_PROPERTY(double max
+               READ max
+               NOTIFY infoChanged)
     // clang-format on
 
+signals:
+    void infoChanged();
+    void valueChanged();
+
 public:
     Dataset(QObject *parent = nullptr);
 
     bool graph() const;
     QString title() const;
     QString value() const;
-    QString tick() const;
+    double number() const;
+    double tick() const;
+    double min() const;
+    double max() const;
     QString units() const;
     QString widget() const;
-    QJsonObject jsonData() const;
 
-    bool read(const QJsonObject &object);
+    bool read(const FrameSchema::Dataset &info, const FrameValue &value);
+    void update(const FrameValue &value);
 
 private:
     bool m_graph;
     QString m_title;
     QString m_value;
-    QString m_tick;
+    double m_number;
+    double m_tick;
+    double m_min;
+    double m_max;
     QString m_units;
     QString m_widget;
-    QJsonObject m_jsonData;
 };
 }
 
@@ -0,0 +1,553 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "DecodingPlan.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <IO/Search.h>
+#include <algorithm>
+
+using namespace JSON;
+
+/**
+ * Removes line breaks from the given @a string (same as the @c FrameSchema class)
+ */
+static QString CLEAN_STRING(QString string)
+{
+    string.remove('\n');
+    string.remove('\r');
+    return string;
+}
+
+/**
+ * Returns the kind of frame data that is generated by the string with the given @a key
+ * of the group/dataset tree. Strings that are not part of the frame schema or values
+ * (e.g. "min" or "max", which are numeric) are not registered as slots.
+ */
+static bool SLOT_TARGET(const QString &key, const int group, const int dataset,
+                        DecodingPlan::Target *target)
+{
+    Q_ASSERT(target);
+
+    if (dataset >= 0 && key == "v")
+        *target = DecodingPlan::Target::Value;
+    else if (dataset >= 0 && key == "x")
+        *target = DecodingPlan::Target::Tick;
+    else if (dataset >= 0 && (key == "t" || key == "u" || key == "w" || key == "g"))
+        *target = DecodingPlan::Target::Structure;
+    else if (dataset < 0 && group >= 0 && (key == "t" || key == "w"))
+        *target = DecodingPlan::Target::Structure;
+    else if (group < 0 && key == "t")
+        *target = DecodingPlan::Target::Structure;
+    else
+        return false;
+
+    return true;
+}
+
+/**
+ * Splits the given string @a str into literal text & %N placeholders (with one or two
+ * digits, same as @c QString::arg()). The column of placeholder segments is set to the
+ * placeholder number, the column of literal segments is set to -1.
+ */
+static QVector<DecodingPlan::Segment> PARSE_SEGMENTS(const QString &str)
+{
+    QVector<DecodingPlan::Segment> segments;
+
+    int from = 0;
+    const auto size = str.length();
+    for (int i = 0; i < size - 1; ++i)
+    {
+        // Not a placeholder
+        if (str.at(i) != '%' || !str.at(i + 1).isDigit())
+            continue;
+
+        // Read placeholder number
+        int end = i + 2;
+        int number = str.at(i + 1).digitValue();
+        if (end < size && str.at(end).isDigit())
+        {
+            number = number * 10 + str.at(end).digitValue();
+            ++end;
+        }
+
+        // Register literal text before the placeholder
+        if (i > from)
+            segments.append({str.mid(from, i - from), -1});
+
+        // Register placeholder
+        segments.append({str.mid(i, end - i), number});
+        from = end;
+        i = end - 1;
+    }
+
+    // Register remaining literal text
+    if (from < size && !segments.isEmpty())
+        segments.append({str.mid(from), -1});
+
+    return segments;
+}
+
+/**
+ * Constructor function
+ */
+DecodingPlan::DecodingPlan()
+    : m_valid(false)
+    , m_expressions(false)
+{
+}
+
+/**
+ * Returns @c true if a JSON map was loaded successfully
+ */
+bool DecodingPlan::isValid() const
+{
+    return m_valid;
+}
+
+/**
+ * Returns the number of comma-separated values that a frame must contain, which is the
+ * number of distinct placeholders of the JSON map.
+ */
+int DecodingPlan::columnCount() const
+{
+    return m_numbers.count();
+}
+
+/**
+ * Removes the loaded JSON map
+ */
+void DecodingPlan::clear()
+{
+    m_valid = false;
+    m_expressions = false;
+    m_numbers.clear();
+    m_slots.clear();
+    m_structureSlots.clear();
+    m_root = QJsonObject();
+    m_schema.clear();
+    m_structure.clear();
+    m_values.clear();
+    m_columns.clear();
+    m_columnNumbers.clear();
+    m_columnValid.clear();
+}
+
+/**
+ * Parses the given @a jsonMapData & builds the decoding plan.
+ *
+ * Dataset values ("v") without placeholders are only evaluated once if they are numbers
+ * or pure arithmetic expressions (which can be compiled into native expressions).
+ * Other values may not be deterministic (e.g. "Math.random()" or "Date.now()"), so
+ * they are evaluated with the JS engine for every frame. Dataset values with
+ * placeholders are compiled into native expressions when possible (the JS engine is
+ * used for the values that cannot be compiled).
+ *
+ * If the titles, units & widgets of the map do not contain placeholders, the frame
+ * schema is built here. Otherwise, it is built when the first frame is decoded.
+ *
+ * @returns @c true if the JSON map is a valid JSON object
+ */
+bool DecodingPlan::load(const QString &jsonMapData)
+{
+    clear();
+
+    // Parse JSON map
+    auto document = QJsonDocument::fromJson(jsonMapData.toUtf8());
+    if (!document.isObject())
+        return false;
+
+    // Evaluate constant dataset values
+    m_root = document.object();
+    auto groups = m_root.value("g").toArray();
+    for (int i = 0; i < groups.count(); ++i)
+    {
+        if (!groups.at(i).isObject())
+            continue;
+
+        auto group = groups.at(i).toObject();
+        auto datasets = group.value("d").toArray();
+        for (int j = 0; j < datasets.count(); ++j)
+        {
+            if (!datasets.at(j).isObject())
+                continue;
+
+            auto dataset = datasets.at(j).toObject();
+            auto value = dataset.value("v");
+            if (value.isString() && PARSE_SEGMENTS(value.toString()).isEmpty())
+            {
+                bool number;
+                const auto str = value.toString();
+                str.toDouble(&number);
+
+                // Numbers are not evaluated, pure arithmetic is evaluated natively
+                double result;
+                Expression expression;
+                if (number)
+                    dataset.insert("v", str);
+                else if (expression.compile(str, m_numbers)
+                         && expression.evaluate({}, {}, result))
+                    dataset.insert("v", Expression::toString(result));
+
+                // Evaluate anything else with the JS engine on every frame
+                else
+                {
+                    Slot slot;
+                    slot.group = i;
+                    slot.dataset = j;
+                    slot.index = -1;
+                    slot.key = "v";
+                    slot.target = Target::Value;
+                    slot.literal = false;
+                    slot.evaluate = true;
+                    slot.segments.append({str, -1});
+                    m_slots.append(slot);
+                }
+            }
+
+            datasets.replace(j, dataset);
+        }
+
+        group.insert("d", datasets);
+        groups.replace(i, group);
+    }
+
+    // Register the strings that contain placeholders
+    m_root.insert("g", groups);
+    addSlots(m_root, -1, -1);
+    for (int i = 0; i < groups.count(); ++i)
+    {
+        const auto group = groups.at(i).toObject();
+        addSlots(group, i, -1);
+
+        const auto datasets = group.value("d").toArray();
+        for (int j = 0; j < datasets.count(); ++j)
+            addSlots(datasets.at(j).toObject(), i, j);
+    }
+
+    // Bind the N-th lowest placeholder number to the N-th column of the frame
+    std::sort(m_numbers.begin(), m_numbers.end());
+    for (int i = 0; i < m_slots.count(); ++i)
+    {
+        auto &slot = m_slots[i];
+        if (slot.target == Target::Structure)
+            m_structureSlots.append(i);
+
+        QString source;
+        for (auto &segment : slot.segments)
+        {
+            source.append(segment.text);
+            if (segment.column >= 0)
+                segment.column = m_numbers.indexOf(segment.column);
+        }
+
+        // Values that only contain a placeholder are not evaluated
+        if (slot.evaluate)
+        {
+            const auto &first = slot.segments.first();
+            slot.literal = slot.segments.count() == 1 && first.column >= 0;
+            if (!slot.literal && slot.expression.compile(source, m_numbers))
+                m_expressions = true;
+        }
+    }
+
+    // Allocate the column buffers once
+    m_columns.resize(m_numbers.count());
+    m_columnNumbers.resize(m_numbers.count());
+    m_columnValid.resize(m_numbers.count());
+
+    // Build the frame schema & the initial values (if the structure is constant)
+    if (m_structureSlots.isEmpty())
+    {
+        m_schema = FrameSchema::read(m_root, &m_values);
+        updateIndexes(m_root);
+    }
+
+    m_valid = true;
+    return true;
+}
+
+/**
+ * Decodes the comma-separated values of the given frame @a data into the given frame
+ * @a schema & @a values, computed dataset values are evaluated natively or with the
+ * given JS @a engine.
+ *
+ * The frame is scanned once, each value is written directly into a copy of the cached
+ * value array & the cached schema is reused (it is only rebuilt if a title, unit or
+ * widget with placeholders changes).
+ *
+ * @returns @c false if there is no valid JSON map, if the map does not describe a valid
+ *          frame, or if the number of values does not match the number of placeholders
+ *          (e.g. truncated frames)
+ */
+bool DecodingPlan::decode(const QByteArray &data, QJSEngine *engine,
+                          FrameSchemaPtr *schema, QVector<FrameValue> *values)
+{
+    Q_ASSERT(schema);
+    Q_ASSERT(values);
+
+    // Invalid frame, the JSON map is incomplete or misses received values
+    if (!m_valid || !readColumns(data))
+        return false;
+
+    // Rebuild the schema if a title, unit or widget changed
+    if (!m_structureSlots.isEmpty())
+    {
+        QStringList structure;
+        for (const auto index : qAsConst(m_structureSlots))
+            structure.append(compose(m_slots.at(index)));
+
+        if (!m_schema || structure != m_structure)
+        {
+            if (!updateSchema(structure))
+                return false;
+        }
+    }
+
+    // Map does not describe a valid frame
+    if (!m_schema)
+        return false;
+
+    // Write the values into a copy of the cached value array
+    *schema = m_schema;
+    *values = m_values;
+    for (const auto &slot : qAsConst(m_slots))
+    {
+        if (slot.index < 0 || slot.target == Target::Structure)
+            continue;
+
+        auto &value = (*values)[slot.index];
+        if (slot.target == Target::Tick)
+            value.tick = CLEAN_STRING(compose(slot)).toDouble();
+
+        else
+        {
+            value.text = CLEAN_STRING(compute(slot, engine));
+            value.number = value.text.toDouble();
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Splits the given frame @a data into its comma-separated values in a single pass,
+ * numeric values are also converted to numbers if there are native expressions.
+ *
+ * @returns @c false if the number of values does not match the number of placeholders
+ */
+bool DecodingPlan::readColumns(const QByteArray &data)
+{
+    int from = 0;
+    int column = 0;
+    const auto size = data.size();
+    const auto count = m_columns.count();
+    forever
+    {
+        auto index = IO::Search::indexOf(data, ',', from);
+        if (index < 0)
+            index = size;
+
+        if (column >= count)
+            return false;
+
+        m_columns[column++] = QString::fromUtf8(data.constData() + from, index - from);
+        if (index >= size)
+            break;
+
+        from = index + 1;
+    }
+
+    if (column != count)
+        return false;
+
+    if (m_expressions)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            bool ok;
+            m_columnNumbers[i] = m_columns.at(i).toDouble(&ok);
+            m_columnValid[i] = ok;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Obtains the position in the value array of the dataset of each slot, check the
+ * @c FrameSchema::valueIndexes() function.
+ */
+void DecodingPlan::updateIndexes(const QJsonObject &object)
+{
+    const auto indexes = FrameSchema::valueIndexes(object);
+    for (auto &slot : m_slots)
+    {
+        slot.index = -1;
+        if (slot.group >= 0 && slot.dataset >= 0 && slot.group < indexes.count())
+            slot.index = indexes.at(slot.group).value(slot.dataset, -1);
+    }
+}
+
+/**
+ * Writes the given @a structure strings (titles, units & widgets with placeholders)
+ * into a copy of the JSON map & rebuilds the frame schema & the initial value array.
+ *
+ * This is only done when the text of these strings changes, so the JSON map is not
+ * processed for consecutive frames with the same structure.
+ */
+bool DecodingPlan::updateSchema(const QStringList &structure)
+{
+    Q_ASSERT(structure.count() == m_structureSlots.count());
+
+    // Write the strings into a copy of the JSON map
+    auto root = m_root;
+    auto groups = root.value("g").toArray();
+    for (int i = 0; i < m_structureSlots.count(); ++i)
+    {
+        const auto &slot = m_slots.at(m_structureSlots.at(i));
+        if (slot.group < 0)
+        {
+            root.insert(slot.key, structure.at(i));
+            continue;
+        }
+
+        auto group = groups.at(slot.group).toObject();
+        if (slot.dataset < 0)
+            group.insert(slot.key, structure.at(i));
+
+        else
+        {
+            auto datasets = group.value("d").toArray();
+            auto dataset = datasets.at(slot.dataset).toObject();
+            dataset.insert(slot.key, structure.at(i));
+            datasets.replace(slot.dataset, dataset);
+            group.insert("d", datasets);
+        }
+
+        groups.replace(slot.group, group);
+    }
+
+    // Build the schema & obtain the new position of each value
+    root.insert("g", groups);
+    m_schema = FrameSchema::read(root, &m_values, m_schema);
+    m_structure = m_schema ? structure : QStringList();
+    updateIndexes(root);
+
+    return !m_schema.isNull();
+}
+
+/**
+ * Registers a slot for each string of the given @a object that contains placeholders
+ * & generates frame data. Dataset values ("v") are marked so that they are evaluated.
+ *
+ * The placeholders of all strings are bound to the frame columns, even if the string
+ * does not generate frame data (same behaviour as substituting the whole JSON map).
+ */
+void DecodingPlan::addSlots(const QJsonObject &object, const int group, const int dataset)
+{
+    for (auto i = object.constBegin(); i != object.constEnd(); ++i)
+    {
+        if (!i.value().isString())
+            continue;
+
+        auto segments = PARSE_SEGMENTS(i.value().toString());
+        if (segments.isEmpty())
+            continue;
+
+        for (const auto &segment : segments)
+        {
+            if (segment.column >= 0 && !m_numbers.contains(segment.column))
+                m_numbers.append(segment.column);
+        }
+
+        Target target;
+        if (!SLOT_TARGET(i.key(), group, dataset, &target))
+            continue;
+
+        Slot slot;
+        slot.group = group;
+        slot.dataset = dataset;
+        slot.index = -1;
+        slot.key = i.key();
+        slot.target = target;
+        slot.literal = false;
+        slot.evaluate = (target == Target::Value);
+        slot.segments = segments;
+        m_slots.append(slot);
+    }
+}
+
+/**
+ * Replaces the placeholders of the given @a slot with the values of the current frame.
+ */
+QString DecodingPlan::compose(const Slot &slot) const
+{
+    // Single placeholder, share the value string
+    if (slot.segments.count() == 1 && slot.segments.first().column >= 0)
+        return m_columns.at(slot.segments.first().column);
+
+    QString value;
+    for (const auto &segment : slot.segments)
+    {
+        if (segment.column >= 0)
+            value.append(m_columns.at(segment.column));
+        else
+            value.append(segment.text);
+    }
+
+    return value;
+}
+
+/**
+ * Returns the value of the given @a slot for the current frame. Computed dataset
+ * values are evaluated with their native expression, or with the given JS @a engine
+ * if the expression could not be compiled.
+ */
+QString DecodingPlan::compute(const Slot &slot, QJSEngine *engine) const
+{
+    if (!slot.evaluate || slot.literal)
+        return compose(slot);
+
+    double result;
+    if (slot.expression.evaluate(m_columnNumbers, m_columnValid, result))
+        return Expression::toString(result);
+
+    return evaluate(compose(slot), engine);
+}
+
+/**
+ * Evaluates the JS code of the given dataset @a value (if any), the value is returned
+ * without changes if the code cannot be evaluated.
+ */
+QString DecodingPlan::evaluate(const QString &value, QJSEngine *engine) const
+{
+    if (!engine)
+        return value;
+
+    auto result = engine->evaluate(value);
+    if (result.isError())
+        return value;
+
+    return result.toString();
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef JSON_DECODING_PLAN_H
+#define JSON_DECODING_PLAN_H
+
+#include <QString>
+#include <QVector>
+#include <QJSEngine>
+#include <QByteArray>
+#include <QStringList>
+#include <QJsonObject>
+
+#include "Expression.h"
+#include "FrameSchema.h"
+
+namespace JSON
+{
+/**
+ * Pre-compiled representation of a JSON map file, used to decode the comma-separated
+ * values of manual mode frames.
+ *
+ * The JSON map is parsed only once (when it is loaded). Every string that contains
+ * %N placeholders is registered as a slot, which stores the location of the string in
+ * the group/dataset tree & the literal text between the placeholders. The N-th lowest
+ * placeholder number is bound to the N-th value of the frame (same behaviour as
+ * repeatedly calling @c QString::arg() on the JSON map text).
+ *
+ * The frame schema & the initial value array are also built when the map is loaded.
+ * Decoding a frame scans the raw frame data once & writes each value directly into a
+ * copy of the cached value array, the cached schema is reused as long as the
+ * placeholders of the titles, units & widgets of the map produce the same text. No
+ * JSON text, objects or documents are generated per frame.
+ *
+ * Dataset values that only contain a placeholder are copied as-is, computed values are
+ * compiled into native expressions (check the @c Expression class). The JS engine is
+ * only used for the values that cannot be compiled.
+ */
+class DecodingPlan
+{
+public:
+    struct Segment
+    {
+        QString text;
+        int column;
+    };
+
+    enum class Target
+    {
+        Value,
+        Tick,
+        Structure
+    };
+
+    struct Slot
+    {
+        int group;
+        int dataset;
+        int index;
+        QString key;
+        Target target;
+        bool literal;
+        bool evaluate;
+        Expression expression;
+        QVector<Segment> segments;
+    };
+
+    DecodingPlan();
+
+    bool isValid() const;
+    int columnCount() const;
+
+    void clear();
+    bool load(const QString &jsonMapData);
+    bool decode(const QByteArray &data, QJSEngine *engine, FrameSchemaPtr *schema,
+                QVector<FrameValue> *values);
+
+private:
+    bool readColumns(const QByteArray &data);
+    void updateIndexes(const QJsonObject &object);
+    bool updateSchema(const QStringList &structure);
+    void addSlots(const QJsonObject &object, const int group, const int dataset);
+    QString compose(const Slot &slot) const;
+    QString compute(const Slot &slot, QJSEngine *engine) const;
+    QString evaluate(const QString &value, QJSEngine *engine) const;
+
+private:
+    bool m_valid;
+    bool m_expressions;
+    QList<int> m_numbers;
+    QVector<Slot> m_slots;
+    QVector<int> m_structureSlots;
+
+    QJsonObject m_root;
+    FrameSchemaPtr m_schema;
+    QStringList m_structure;
+    QVector<FrameValue> m_values;
+
+    QVector<QString> m_columns;
+    QVector<double> m_columnNumbers;
+    QVector<bool> m_columnValid;
+};
+}
+
+#endif
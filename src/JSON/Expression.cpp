@@ -0,0 +1,627 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "Expression.h"
+
+#include <QtMath>
+#include <QLocale>
+#include <QVarLengthArray>
+
+#include <cmath>
+
+using namespace JSON;
+
+/**
+ * JavaScript implementation of Math.round(), which rounds halfway values towards
+ * positive infinity.
+ */
+static double JS_ROUND(double value)
+{
+    return std::floor(value + 0.5);
+}
+
+/**
+ * JavaScript implementation of Math.sign()
+ */
+static double JS_SIGN(double value)
+{
+    if (value > 0)
+        return 1;
+    else if (value < 0)
+        return -1;
+
+    return value;
+}
+
+/**
+ * Single-argument functions supported by the evaluator
+ */
+static const struct
+{
+    const char *name;
+    double (*function)(double);
+} FUNCTIONS_1[] = {
+    {"abs", [](double x) { return std::fabs(x); }},
+    {"acos", [](double x) { return std::acos(x); }},
+    {"asin", [](double x) { return std::asin(x); }},
+    {"atan", [](double x) { return std::atan(x); }},
+    {"cbrt", [](double x) { return std::cbrt(x); }},
+    {"ceil", [](double x) { return std::ceil(x); }},
+    {"cos", [](double x) { return std::cos(x); }},
+    {"exp", [](double x) { return std::exp(x); }},
+    {"floor", [](double x) { return std::floor(x); }},
+    {"log", [](double x) { return std::log(x); }},
+    {"log10", [](double x) { return std::log10(x); }},
+    {"log2", [](double x) { return std::log2(x); }},
+    {"round", JS_ROUND},
+    {"sign", JS_SIGN},
+    {"sin", [](double x) { return std::sin(x); }},
+    {"sqrt", [](double x) { return std::sqrt(x); }},
+    {"tan", [](double x) { return std::tan(x); }},
+    {"trunc", [](double x) { return std::trunc(x); }},
+};
+
+/**
+ * Two-argument functions supported by the evaluator
+ */
+static const struct
+{
+    const char *name;
+    double (*function)(double, double);
+} FUNCTIONS_2[] = {
+    {"atan2", [](double y, double x) { return std::atan2(y, x); }},
+    {"hypot", [](double x, double y) { return std::hypot(x, y); }},
+    {"pow", [](double x, double y) { return std::pow(x, y); }},
+};
+
+//----------------------------------------------------------------------------------------
+// Recursive-descent parser, generates the bytecode program
+//----------------------------------------------------------------------------------------
+
+/**
+ * Parses an expression & appends the equivalent stack-based instructions to the
+ * program, while keeping track of the maximum stack depth.
+ */
+class Expression::Parser
+{
+public:
+    Parser(const QString &source, const QList<int> &numbers,
+           QVector<Instruction> &program)
+        : m_pos(0)
+        , m_depth(0)
+        , m_maxDepth(0)
+        , m_source(source)
+        , m_numbers(numbers)
+        , m_program(program)
+    {
+    }
+
+    /**
+     * Parses the whole source string, returns @c false on syntax errors or if the
+     * expression uses unsupported features.
+     */
+    bool parse(int &stackSize)
+    {
+        if (!parseExpression())
+            return false;
+
+        skipSpaces();
+        stackSize = m_maxDepth;
+        return m_pos == m_source.length() && m_depth == 1;
+    }
+
+private:
+    /**
+     * Returns the current character (or a null character at the end of the source)
+     */
+    QChar peek(const int offset = 0) const
+    {
+        const auto index = m_pos + offset;
+        if (index < m_source.length())
+            return m_source.at(index);
+
+        return QChar();
+    }
+
+    /**
+     * Skips whitespace characters
+     */
+    void skipSpaces()
+    {
+        while (peek().isSpace())
+            ++m_pos;
+    }
+
+    /**
+     * Appends an instruction to the program & updates the stack depth
+     */
+    void emitOp(const OpCode op, const double constant = 0, const int operand = 0,
+                Function1 function1 = nullptr, Function2 function2 = nullptr)
+    {
+        m_program.append({op, constant, operand, function1, function2});
+
+        switch (op)
+        {
+            case OpCode::Constant:
+            case OpCode::Column:
+                ++m_depth;
+                break;
+            case OpCode::Add:
+            case OpCode::Subtract:
+            case OpCode::Multiply:
+            case OpCode::Divide:
+            case OpCode::Modulo:
+            case OpCode::Function2:
+                --m_depth;
+                break;
+            case OpCode::Minimum:
+            case OpCode::Maximum:
+                m_depth += 1 - operand;
+                break;
+            case OpCode::Negate:
+            case OpCode::Function1:
+                break;
+        }
+
+        m_maxDepth = qMax(m_maxDepth, m_depth);
+    }
+
+    /**
+     * expression := term (('+' | '-') term)*
+     */
+    bool parseExpression()
+    {
+        if (!parseTerm())
+            return false;
+
+        forever
+        {
+            skipSpaces();
+            const auto c = peek();
+            if (c != '+' && c != '-')
+                return true;
+            if (peek(1) == c)
+                return false;
+
+            ++m_pos;
+            if (!parseTerm())
+                return false;
+
+            emitOp(c == '+' ? OpCode::Add : OpCode::Subtract);
+        }
+    }
+
+    /**
+     * term := unary (('*' | '/' | '%') unary)*
+     *
+     * A '%' followed by a digit is a column placeholder, not the modulo operator.
+     */
+    bool parseTerm()
+    {
+        if (!parseUnary())
+            return false;
+
+        forever
+        {
+            skipSpaces();
+            const auto c = peek();
+            if (c != '*' && c != '/' && c != '%')
+                return true;
+            if (c == '%' && peek(1).isDigit())
+                return true;
+            if (c == '*' && peek(1) == '*')
+                return false;
+
+            ++m_pos;
+            if (!parseUnary())
+                return false;
+
+            if (c == '*')
+                emitOp(OpCode::Multiply);
+            else if (c == '/')
+                emitOp(OpCode::Divide);
+            else
+                emitOp(OpCode::Modulo);
+        }
+    }
+
+    /**
+     * unary := ('-' | '+') unary | primary
+     */
+    bool parseUnary()
+    {
+        skipSpaces();
+        const auto c = peek();
+        if (c == '-' || c == '+')
+        {
+            if (peek(1) == c)
+                return false;
+
+            ++m_pos;
+            if (!parseUnary())
+                return false;
+
+            if (c == '-')
+                emitOp(OpCode::Negate);
+
+            return true;
+        }
+
+        return parsePrimary();
+    }
+
+    /**
+     * primary := number | column | constant | function '(' arguments ')'
+     *            | '(' expression ')'
+     */
+    bool parsePrimary()
+    {
+        skipSpaces();
+        const auto c = peek();
+
+        // Parenthesized expression
+        if (c == '(')
+        {
+            ++m_pos;
+            if (!parseExpression())
+                return false;
+
+            skipSpaces();
+            if (peek() != ')')
+                return false;
+
+            ++m_pos;
+            return true;
+        }
+
+        // Column placeholder
+        if (c == '%')
+            return parseColumn();
+
+        // Number
+        if (c.isDigit() || c == '.')
+            return parseNumber();
+
+        // Function or constant
+        if (c.isLetter() || c == '_')
+            return parseIdentifier();
+
+        return false;
+    }
+
+    /**
+     * Parses a %N placeholder, which is bound to the column of the N-th lowest
+     * placeholder number of the JSON map.
+     */
+    bool parseColumn()
+    {
+        ++m_pos;
+        if (!peek().isDigit())
+            return false;
+
+        int number = peek().digitValue();
+        ++m_pos;
+        if (peek().isDigit())
+        {
+            number = number * 10 + peek().digitValue();
+            ++m_pos;
+        }
+
+        const auto column = m_numbers.indexOf(number);
+        if (column < 0)
+            return false;
+
+        emitOp(OpCode::Column, 0, column);
+        return true;
+    }
+
+    /**
+     * Parses a decimal number. Legacy octal & hexadecimal numbers are not supported.
+     */
+    bool parseNumber()
+    {
+        const auto start = m_pos;
+        if (peek() == '0' && peek(1).isDigit())
+            return false;
+
+        while (peek().isDigit())
+            ++m_pos;
+
+        if (peek() == '.')
+        {
+            ++m_pos;
+            while (peek().isDigit())
+                ++m_pos;
+        }
+
+        if (peek() == 'e' || peek() == 'E')
+        {
+            ++m_pos;
+            if (peek() == '+' || peek() == '-')
+                ++m_pos;
+            if (!peek().isDigit())
+                return false;
+            while (peek().isDigit())
+                ++m_pos;
+        }
+
+        if (peek().isLetterOrNumber() || peek() == '_')
+            return false;
+
+        bool ok;
+        const auto value = m_source.mid(start, m_pos - start).toDouble(&ok);
+        if (!ok)
+            return false;
+
+        emitOp(OpCode::Constant, value);
+        return true;
+    }
+
+    /**
+     * Parses a function call or a constant with the "Math." prefix. Other identifiers
+     * (e.g. a bare "E") may have a different meaning in JS, so they fail to compile.
+     */
+    bool parseIdentifier()
+    {
+        const auto start = m_pos;
+        while (peek().isLetterOrNumber() || peek() == '_' || peek() == '.')
+            ++m_pos;
+
+        auto name = m_source.mid(start, m_pos - start);
+        if (!name.startsWith("Math."))
+            return false;
+
+        name = name.mid(5);
+
+        // Constants
+        skipSpaces();
+        if (peek() != '(')
+        {
+            if (name == "PI")
+                emitOp(OpCode::Constant, M_PI);
+            else if (name == "E")
+                emitOp(OpCode::Constant, M_E);
+            else
+                return false;
+
+            return true;
+        }
+
+        // Parse arguments
+        ++m_pos;
+        int arguments = 0;
+        skipSpaces();
+        if (peek() == ')')
+            ++m_pos;
+        else
+        {
+            forever
+            {
+                if (!parseExpression())
+                    return false;
+
+                ++arguments;
+                skipSpaces();
+                if (peek() == ',')
+                    ++m_pos;
+                else if (peek() == ')')
+                {
+                    ++m_pos;
+                    break;
+                }
+                else
+                    return false;
+            }
+        }
+
+        // Variadic functions
+        if (name == "min" || name == "max")
+        {
+            emitOp(name == "min" ? OpCode::Minimum : OpCode::Maximum, 0, arguments);
+            return true;
+        }
+
+        // Single-argument functions
+        if (arguments == 1)
+        {
+            for (const auto &f : FUNCTIONS_1)
+            {
+                if (name == QLatin1String(f.name))
+                {
+                    emitOp(OpCode::Function1, 0, 0, f.function);
+                    return true;
+                }
+            }
+        }
+
+        // Two-argument functions
+        if (arguments == 2)
+        {
+            for (const auto &f : FUNCTIONS_2)
+            {
+                if (name == QLatin1String(f.name))
+                {
+                    emitOp(OpCode::Function2, 0, 0, nullptr, f.function);
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+private:
+    int m_pos;
+    int m_depth;
+    int m_maxDepth;
+    const QString &m_source;
+    const QList<int> &m_numbers;
+    QVector<Instruction> &m_program;
+};
+
+//----------------------------------------------------------------------------------------
+// Expression class
+//----------------------------------------------------------------------------------------
+
+/**
+ * Constructor function
+ */
+Expression::Expression()
+    : m_valid(false)
+    , m_stackSize(0)
+{
+}
+
+/**
+ * Returns @c true if the expression was compiled successfully
+ */
+bool Expression::isValid() const
+{
+    return m_valid;
+}
+
+/**
+ * Compiles the given @a source expression. %N placeholders are bound to the column
+ * given by the index of N in the sorted list of placeholder @a numbers.
+ *
+ * @returns @c false if the expression contains unsupported syntax
+ */
+bool Expression::compile(const QString &source, const QList<int> &numbers)
+{
+    m_program.clear();
+    m_stackSize = 0;
+
+    Parser parser(source, numbers, m_program);
+    m_valid = parser.parse(m_stackSize);
+    if (!m_valid)
+        m_program.clear();
+
+    return m_valid;
+}
+
+/**
+ * Runs the compiled program with the given @a columns of the current frame.
+ *
+ * @returns @c false if the expression references a column that is missing or that is
+ *          not a number (@a valid flag is @c false), so that the caller can fall back
+ *          to the JS engine
+ */
+bool Expression::evaluate(const QVector<double> &columns, const QVector<bool> &valid,
+                          double &result) const
+{
+    if (!m_valid)
+        return false;
+
+    int top = 0;
+    QVarLengthArray<double, 32> stack(m_stackSize);
+    for (const auto &i : m_program)
+    {
+        switch (i.op)
+        {
+            case OpCode::Constant:
+                stack[top++] = i.constant;
+                break;
+            case OpCode::Column:
+                if (i.operand >= columns.count() || !valid.at(i.operand))
+                    return false;
+                stack[top++] = columns.at(i.operand);
+                break;
+            case OpCode::Add:
+                --top;
+                stack[top - 1] += stack[top];
+                break;
+            case OpCode::Subtract:
+                --top;
+                stack[top - 1] -= stack[top];
+                break;
+            case OpCode::Multiply:
+                --top;
+                stack[top - 1] *= stack[top];
+                break;
+            case OpCode::Divide:
+                --top;
+                stack[top - 1] /= stack[top];
+                break;
+            case OpCode::Modulo:
+                --top;
+                stack[top - 1] = std::fmod(stack[top - 1], stack[top]);
+                break;
+            case OpCode::Negate:
+                stack[top - 1] = -stack[top - 1];
+                break;
+            case OpCode::Function1:
+                stack[top - 1] = i.function1(stack[top - 1]);
+                break;
+            case OpCode::Function2:
+                --top;
+                stack[top - 1] = i.function2(stack[top - 1], stack[top]);
+                break;
+            case OpCode::Minimum:
+            case OpCode::Maximum: {
+                const bool min = (i.op == OpCode::Minimum);
+                double value = min ? qInf() : -qInf();
+                for (int j = top - i.operand; j < top; ++j)
+                {
+                    if (qIsNaN(stack[j]) || qIsNaN(value))
+                        value = qQNaN();
+                    else
+                        value = min ? qMin(value, stack[j]) : qMax(value, stack[j]);
+                }
+
+                top -= i.operand;
+                stack[top++] = value;
+                break;
+            }
+        }
+    }
+
+    result = stack[0];
+    return true;
+}
+
+/**
+ * Converts the given @a value to a string in the same way as JavaScript does (shortest
+ * representation that round-trips, exponent notation below 1e-6 & above 1e21).
+ */
+QString Expression::toString(const double value)
+{
+    if (qIsNaN(value))
+        return QStringLiteral("NaN");
+    if (qIsInf(value))
+        return value > 0 ? QStringLiteral("Infinity") : QStringLiteral("-Infinity");
+    if (value == 0)
+        return QStringLiteral("0");
+
+    // Fixed notation
+    const auto abs = qAbs(value);
+    if (abs >= 1e-6 && abs < 1e21)
+        return QString::number(value, 'f', QLocale::FloatingPointShortest);
+
+    // Exponent notation, without leading zeros in the exponent (e.g. "1e-7")
+    auto str = QString::number(value, 'e', QLocale::FloatingPointShortest);
+    const auto e = str.indexOf('e');
+    int digit = e + 2;
+    while (digit < str.length() - 1 && str.at(digit) == '0')
+        str.remove(digit, 1);
+
+    return str;
+}
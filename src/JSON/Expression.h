@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef JSON_EXPRESSION_H
+#define JSON_EXPRESSION_H
+
+#include <QString>
+#include <QVector>
+
+namespace JSON
+{
+/**
+ * Native evaluator for the arithmetic subset of JavaScript that is commonly used in
+ * the dataset values of JSON map files (e.g. "%2 * 100 / 1024" or "Math.sqrt(%3)").
+ *
+ * Expressions are compiled once into a small stack-based bytecode program, where %N
+ * placeholders are compiled as references to the columns of the frame. Supported
+ * syntax:
+ *    - Numbers, %N column references & parentheses
+ *    - Binary operators +, -, *, / & % and unary + & - (no increment/decrement)
+ *    - Math functions (with the "Math." prefix): abs, acos, asin, atan, atan2, cbrt,
+ *      ceil, cos, exp, floor, hypot, log, log10, log2, max, min, pow, round, sign,
+ *      sin, sqrt, tan & trunc
+ *    - Constants: Math.PI & Math.E
+ *
+ * Anything else fails to compile, so that the caller can fall back to the JS engine.
+ */
+class Expression
+{
+public:
+    Expression();
+
+    bool isValid() const;
+    bool compile(const QString &source, const QList<int> &numbers);
+    bool evaluate(const QVector<double> &columns, const QVector<bool> &valid,
+                  double &result) const;
+
+    static QString toString(const double value);
+
+private:
+    enum class OpCode
+    {
+        Constant,
+        Column,
+        Add,
+        Subtract,
+        Multiply,
+        Divide,
+        Modulo,
+        Negate,
+        Function1,
+        Function2,
+        Minimum,
+        Maximum
+    };
+
+    typedef double (*Function1)(double);
+    typedef double (*Function2)(double, double);
+
+    struct Instruction
+    {
+        OpCode op;
+        double constant;
+        int operand;
+        Function1 function1;
+        Function2 function2;
+    };
+
+    class Parser;
+
+private:
+    bool m_valid;
+    int m_stackSize;
+    QVector<Instruction> m_program;
+};
+}
+
+#endif
@@ -22,6 +22,8 @@
 
 #include "Frame.h"
 
+#include <QQmlEngine>
+
 using namespace JSON;
 
 /**
@@ -29,29 +31,34 @@ using namespace JSON;
  */
 Frame::Frame()
     : m_title("")
+    , m_generation(0)
 {
 }
 
 /**
- * Destructor function, free memory used by the @c Group objects before destroying an
- * instance of this class.
+ * Destructor function, free memory used by the @c Group objects (including the groups
+ * that are not being used) before destroying an instance of this class.
  */
 Frame::~Frame()
 {
     clear();
+
+    for (int i = 0; i < m_pool.count(); ++i)
+        m_pool.at(i)->deleteLater();
+
+    m_pool.clear();
 }
 
 /**
- * Resets the frame title and frees the memory used by the @c Group objects associated
- * to the instance of the @c Frame object.
+ * Resets the frame title and removes the groups of the frame. The @c Group objects are
+ * kept in a pool, so that they can be reused by the next call to @c read().
  */
 void Frame::clear()
 {
-    for (int i = 0; i < groupCount(); ++i)
-        m_groups.at(i)->deleteLater();
-
     m_title = "";
+    m_generation = 0;
     m_groups.clear();
+    m_datasets.clear();
 }
 
 /**
@@ -79,47 +86,101 @@ QVector<Group *> Frame::groups() const
 }
 
 /**
- * Reads the frame information and all its asociated groups (and datatsets) from the given
- * JSON @c object.
+ * Returns the structure generation of the frame that was used to create the groups &
+ * datasets (check the "FrameInfo.h" file)
+ */
+quint64 Frame::generation() const
+{
+    return m_generation;
+}
+
+/**
+ * Creates the groups (and datasets) of the frame from the schema & the values of the
+ * given frame @a info.
  *
  * @return @c true on success, @c false on failure
  */
-bool Frame::read(const QJsonObject &object)
+bool Frame::read(const JFI_Object &info)
 {
-    // Rest frame data
+    // Reset frame data
     clear();
 
-    // Get title & groups array
-    auto title = object.value("t").toString();
-    auto groups = object.value("g").toArray();
+    // Invalid frame
+    const auto schema = info.schema;
+    if (schema.isNull() || info.values.count() != schema->datasets().count())
+        return false;
 
-    // Remove line breaks from title
-    title = title.replace("\n", "");
-    title = title.replace("\r", "");
-
-    // We need to have a project title and at least one group
-    if (!title.isEmpty() && !groups.isEmpty())
+    // Generate groups & datasets from the frame values, group objects are taken from
+    // the pool & new groups are only created if the pool is exhausted. Pooled groups
+    // are handed to QML, so they must never be garbage-collected by the QML engine.
+    m_title = schema->title();
+    for (auto i = 0; i < schema->groups().count(); ++i)
     {
-        // Update title
-        m_title = title;
-
-        // Generate groups & datasets from data frame
-        for (auto i = 0; i < groups.count(); ++i)
+        if (m_groups.count() == m_pool.count())
         {
-            Group *group = new Group;
-            if (group->read(groups.at(i).toObject()))
-                m_groups.append(group);
-            else
-                group->deleteLater();
+            auto group = new Group;
+            QQmlEngine::setObjectOwnership(group, QQmlEngine::CppOwnership);
+            m_pool.append(group);
         }
 
-        // Return status
-        return groupCount() > 0;
+        auto group = m_pool.at(m_groups.count());
+        if (group->read(*schema, i, info.values))
+            m_groups.append(group);
     }
 
-    // Error
-    clear();
-    return false;
+    // We need to have at least one group
+    if (groupCount() == 0)
+    {
+        clear();
+        return false;
+    }
+
+    // Register the dataset object of each schema dataset (datasets with an empty value
+    // are not created)
+    int index = 0;
+    QVector<Dataset *> datasets;
+    for (const auto group : qAsConst(m_groups))
+        datasets.append(group->datasets());
+
+    m_datasets.fill(Q_NULLPTR, info.values.count());
+    for (int i = 0; i < info.values.count(); ++i)
+    {
+        if (!info.values.at(i).text.isEmpty())
+            m_datasets[i] = datasets.at(index++);
+    }
+
+    m_generation = info.generation;
+    return true;
+}
+
+/**
+ * Updates the values of the existing datasets with the values of the given frame
+ * @a info, without re-creating the groups & datasets.
+ *
+ * @return @c false if the frame has a different structure generation, or if a dataset
+ *         value became empty (or non-empty), in which case the frame must be read again
+ */
+bool Frame::update(const JFI_Object &info)
+{
+    if (!isValid() || info.generation != m_generation)
+        return false;
+
+    if (info.values.count() != m_datasets.count())
+        return false;
+
+    for (int i = 0; i < m_datasets.count(); ++i)
+    {
+        if ((m_datasets.at(i) == Q_NULLPTR) != info.values.at(i).text.isEmpty())
+            return false;
+    }
+
+    for (int i = 0; i < m_datasets.count(); ++i)
+    {
+        if (m_datasets.at(i))
+            m_datasets.at(i)->update(info.values.at(i));
+    }
+
+    return true;
 }
 
 /**
@@ -26,10 +26,9 @@
 #include <QVector>
 #include <QObject>
 #include <QVariant>
-#include <QJsonArray>
-#include <QJsonObject>
 
 #include "Group.h"
+#include "FrameInfo.h"
 
 namespace JSON
 {
@@ -43,14 +42,19 @@ public:
     QString title() const;
     int groupCount() const;
     QVector<Group *> groups() const;
-    bool read(const QJsonObject &object);
+    quint64 generation() const;
+    bool read(const JFI_Object &info);
+    bool update(const JFI_Object &info);
     Q_INVOKABLE Group *getGroup(const int index);
 
     inline bool isValid() const { return !title().isEmpty() && groupCount() > 0; }
 
 private:
     QString m_title;
+    quint64 m_generation;
+    QVector<Group *> m_pool;
     QVector<Group *> m_groups;
+    QVector<Dataset *> m_datasets;
 };
 }
 #endif
@@ -22,13 +22,15 @@
 
 #include "FrameInfo.h"
 
+#include <chrono>
+
 /**
- * Returns @c true if the given JFI @info structure has a non-empty JSON document and a
- * valid frame number.
+ * Returns @c true if the given JFI @info structure has a frame schema and a valid frame
+ * number.
  */
 bool JFI_Valid(const JFI_Object &info)
 {
-    return info.frameNumber >= 0 && !info.jsonDocument.isEmpty();
+    return info.frameNumber >= 0 && !info.schema.isNull();
 }
 
 /**
@@ -53,13 +55,37 @@ void JFI_SortList(QList<JFI_Object> *list)
 }
 
 /**
- * Creates an empty JFI structure with the current system date/time and frame number @c n
+ * Returns the current time of the monotonic clock in nanoseconds, this is the same clock
+ * used by the @c IO::Reader class to timestamp received data.
+ */
+qint64 JFI_Timestamp()
+{
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * Converts the given monotonic clock @a timestamp to a wall-clock date/time. The offset
+ * between both clocks is measured once, so that converted timestamps keep the same
+ * spacing as the original timestamps even if the system time is adjusted.
+ */
+QDateTime JFI_DateTime(const qint64 timestamp)
+{
+    static const auto steadyRef = JFI_Timestamp();
+    static const auto systemRef = QDateTime::currentMSecsSinceEpoch();
+    return QDateTime::fromMSecsSinceEpoch(systemRef + (timestamp - steadyRef) / 1000000);
+}
+
+/**
+ * Creates an empty JFI structure with the current timestamp and frame number @c n
  */
 JFI_Object JFI_Empty(const quint64 n)
 {
     JFI_Object info;
     info.frameNumber = n;
-    info.rxDateTime = QDateTime::currentDateTime();
+    info.sourceId = 0;
+    info.generation = 0;
+    info.rxTimestamp = JFI_Timestamp();
     return info;
 }
 
@@ -67,14 +93,20 @@ JFI_Object JFI_Empty(const quint64 n)
  * Creates a new JFI structure with the given information
  *
  * @param n frame number
- * @param t date/time
- * @param d JSON document
+ * @param t RX timestamp (monotonic clock, in nanoseconds)
+ * @param schema frame structure
+ * @param values value of each dataset of the @a schema
  */
-JFI_Object JFI_CreateNew(const quint64 n, const QDateTime &t, const QJsonDocument &d)
+JFI_Object JFI_CreateNew(const quint64 n, const qint64 t,
+                         const JSON::FrameSchemaPtr &schema,
+                         const QVector<JSON::FrameValue> &values, const int sourceId)
 {
     JFI_Object info;
-    info.rxDateTime = t;
+    info.rxTimestamp = t;
     info.frameNumber = n;
-    info.jsonDocument = d;
+    info.sourceId = sourceId;
+    info.generation = 0;
+    info.schema = schema;
+    info.values = values;
     return info;
 }
@@ -24,8 +24,10 @@
 #define JSON_FRAME_INFO_H
 
 #include <QList>
+#include <QVector>
 #include <QDateTime>
-#include <QJsonDocument>
+
+#include "FrameSchema.h"
 
 /**
  * Defines a JSON frame information structure. We need to use this in order to be able
@@ -41,27 +43,44 @@
  * To mitigate this, we create this structure, which contains the following information:
  *    - Frame number (assigned by the JSON::Generator class when raw frame data is
  *      received, and before the JSON object is genereated/parsed).
- *    - RX date/time (assigned in the same manner as the frame number).
- *    - JSON document/object (which contains all the frame information + what we should
- *      do with it).
+ *    - RX timestamp (nanoseconds of the monotonic clock, captured by the IO::Reader
+ *      class when the frame data was read from the device, so that queueing delays
+ *      in the GUI thread are not included in the timestamp).
+ *    - Frame schema & values (the structure of the frame is shared between all the
+ *      frames with the same groups & datasets, check the @c JSON::FrameSchema class,
+ *      each frame only carries the value of each dataset).
  *
- * We need to register the frame number because (in some cases), the RX date/time will be
- * the same between two or more frames (e.g. if you have a very high baud rate, there is
- * a chance that frames will be registered with the same rx date/time down to the
- * millisecond, this was the root cause of bug #35).
+ * We need to register the frame number because (in some cases), the RX timestamp will
+ * be the same between two or more frames (e.g. if several frames are read from the
+ * device at once and timestamp interpolation is disabled, this was the root cause of
+ * bug #35 when date/times with millisecond resolution were used).
  *
  * To mitigate this, we simply increment the frame number each time that we receive a raw
  * frame. Frame numbers are registered as a uint64_t for this very reason (it would take
  * about 585 years to overflow this variable, if you had a computer that was able to
  * process a frame every nanosecond).
  *
+ * The source ID identifies the device that sent the frame (zero for the main device of
+ * the IO::Manager class, check the IO::Source class for more information).
+ *
+ * The structure generation is assigned by the JSON::Generator class when the frame is
+ * loaded, it only changes when the structure of the frame changes (e.g. when a new
+ * JSON map is loaded). Modules that consume frames use it to know whether they only
+ * need to update their values, or rebuild their models.
+ *
+ * The RX timestamp is only converted to a wall-clock date/time (with the
+ * @c JFI_DateTime() function) when it needs to be displayed or exported.
+ *
  * Frame number is reset when the device connection state is changed.
  */
 typedef struct
 {
     quint64 frameNumber;
-    QDateTime rxDateTime;
-    QJsonDocument jsonDocument;
+    qint64 rxTimestamp;
+    int sourceId;
+    quint64 generation;
+    JSON::FrameSchemaPtr schema;
+    QVector<JSON::FrameValue> values;
 } JFI_Object;
 
 //----------------------------------------------------------------------------------------
@@ -71,9 +90,14 @@ typedef struct
 extern bool JFI_Valid(const JFI_Object &info);
 extern void JFI_SortList(QList<JFI_Object> *list);
 
+extern qint64 JFI_Timestamp();
+extern QDateTime JFI_DateTime(const qint64 timestamp);
+
 extern JFI_Object JFI_Empty(const quint64 n = 0);
-extern JFI_Object JFI_CreateNew(const quint64 n, const QDateTime &t,
-                                const QJsonDocument &d);
+extern JFI_Object JFI_CreateNew(const quint64 n, const qint64 t,
+                                const JSON::FrameSchemaPtr &schema,
+                                const QVector<JSON::FrameValue> &values,
+                                const int sourceId = 0);
 
 /*
  * Important magic to be able to use JFI structures in Qt signals/slots
@@ -0,0 +1,906 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "FrameParser.h"
+
+#include <QVariant>
+#include <QJsonDocument>
+
+using namespace JSON;
+
+/*
+ * Keys of the frame grammar, the value of each key is also used to tag the structural
+ * tokens in the layout string
+ */
+enum FrameKey
+{
+    kUnknownKey = 0,
+    kTitleKey = 't',
+    kGraphKey = 'g',
+    kDatasetsKey = 'd',
+    kValueKey = 'v',
+    kTickKey = 'x',
+    kUnitsKey = 'u',
+    kWidgetKey = 'w',
+    kMinKey = 'm',
+    kMaxKey = 'M',
+};
+
+/*
+ * Maximum nesting level of the skipped JSON values, deeper frames are handled by the
+ * JSON document parser
+ */
+static const int MAX_DEPTH = 64;
+
+/*
+ * Powers of ten that can be represented exactly by a double
+ */
+static const double POW10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                               1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                               1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+/**
+ * Returns @c true if the given character is a JSON whitespace character
+ */
+static inline bool IS_SPACE(const char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+/**
+ * Returns @c true if the given character is a decimal digit
+ */
+static inline bool IS_DIGIT(const char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+/**
+ * Returns the value of the given hexadecimal digit, or -1 if @a c is not a hex digit
+ */
+static inline int HEX_VALUE(const char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+
+    return -1;
+}
+
+/**
+ * Converts the given JSON number literal to a double. Numbers with up to 15 digits &
+ * a small exponent are converted exactly with a single multiplication or division,
+ * other numbers are converted by Qt.
+ */
+static double TO_DOUBLE(const char *str, const int length)
+{
+    int i = 0;
+    bool negative = false;
+    if (str[i] == '-')
+    {
+        negative = true;
+        ++i;
+    }
+
+    // Read the integer & fractional digits into the mantissa
+    int digits = 0;
+    int exponent = 0;
+    quint64 mantissa = 0;
+    for (; i < length && IS_DIGIT(str[i]); ++i)
+    {
+        mantissa = mantissa * 10 + static_cast<quint64>(str[i] - '0');
+        digits += (mantissa > 0);
+    }
+    if (i < length && str[i] == '.')
+    {
+        for (++i; i < length && IS_DIGIT(str[i]); ++i)
+        {
+            mantissa = mantissa * 10 + static_cast<quint64>(str[i] - '0');
+            digits += (mantissa > 0);
+            --exponent;
+        }
+    }
+
+    // Read the exponent
+    if (i < length && (str[i] == 'e' || str[i] == 'E'))
+    {
+        ++i;
+        int sign = 1;
+        if (str[i] == '-' || str[i] == '+')
+            sign = (str[i++] == '-') ? -1 : 1;
+
+        int value = 0;
+        for (; i < length && IS_DIGIT(str[i]) && value < 10000; ++i)
+            value = value * 10 + (str[i] - '0');
+
+        exponent += sign * value;
+    }
+
+    // Exact conversion
+    if (digits <= 15 && exponent >= -22 && exponent <= 22)
+    {
+        auto value = static_cast<double>(mantissa);
+        if (exponent < 0)
+            value /= POW10[-exponent];
+        else
+            value *= POW10[exponent];
+
+        return negative ? -value : value;
+    }
+
+    // Let Qt deal with long numbers
+    return QByteArray(str, length).toDouble();
+}
+
+/**
+ * Removes line breaks from the given @a string
+ */
+static QString CLEAN_STRING(QString string)
+{
+    string.replace("\n", "");
+    string.replace("\r", "");
+    return string;
+}
+
+/**
+ * Decodes the escape sequences of the given JSON string (without quotes)
+ */
+static QString DECODE_STRING(const char *str, const int length)
+{
+    QString string;
+    int run = 0;
+    for (int i = 0; i < length; ++i)
+    {
+        if (str[i] != '\\')
+            continue;
+
+        string.append(QString::fromUtf8(str + run, i - run));
+        const char c = str[++i];
+        switch (c)
+        {
+            case 'b':
+                string.append(QChar('\b'));
+                break;
+            case 'f':
+                string.append(QChar('\f'));
+                break;
+            case 'n':
+                string.append(QChar('\n'));
+                break;
+            case 'r':
+                string.append(QChar('\r'));
+                break;
+            case 't':
+                string.append(QChar('\t'));
+                break;
+            case 'u':
+            {
+                ushort code = 0;
+                for (int j = 0; j < 4; ++j)
+                    code = static_cast<ushort>(code * 16 + HEX_VALUE(str[++i]));
+
+                string.append(QChar(code));
+                break;
+            }
+            default:
+                string.append(QChar(c));
+                break;
+        }
+
+        run = i + 1;
+    }
+
+    string.append(QString::fromUtf8(str + run, length - run));
+    return string;
+}
+
+/**
+ * Constructor function
+ */
+FrameParser::FrameParser()
+    : m_pos(0)
+    , m_size(0)
+    , m_depth(0)
+    , m_reusable(false)
+    , m_data(nullptr)
+{
+    m_current.reserve(1024);
+}
+
+/**
+ * Discards the layout & the schema of the previous frame
+ */
+void FrameParser::clear()
+{
+    m_layout.clear();
+    m_schema.clear();
+}
+
+/**
+ * Parses the given JSON frame @a data & writes the value of each dataset into the
+ * @a values array.
+ *
+ * @return The schema of the frame, or a null pointer if the frame is not valid
+ */
+FrameSchemaPtr FrameParser::read(const QByteArray &data, QVector<FrameValue> *values)
+{
+    Q_ASSERT(values);
+
+    // Tokenize the frame
+    m_data = data.constData();
+    m_size = data.size();
+    const bool parsed = parseFrame();
+
+    // Same layout as the previous frame, only read the values
+    if (parsed && m_reusable && m_schema && m_current == m_layout)
+    {
+        readValues(values);
+        return m_schema;
+    }
+
+    // Layout changed, parse the whole frame
+    const auto object = QJsonDocument::fromJson(data).object();
+    const auto schema = FrameSchema::read(object, values, m_schema);
+    if (schema)
+        m_schema = schema;
+
+    // Register the new layout if the values of the next frames can be read directly
+    m_reusable = m_reusable && parsed && !schema.isNull();
+    if (m_reusable && schema->datasets().count() == m_slots.count())
+        m_layout = QByteArray(m_current.constData(), m_current.size());
+    else
+        m_layout.clear();
+
+    return schema;
+}
+
+/**
+ * Tokenizes the root object of the frame.
+ *
+ * The layout is only reusable if the frame has a non-empty title, a non-empty groups
+ * array & all the groups & datasets are valid, so that the datasets of the schema
+ * match the datasets of the frame one-to-one.
+ *
+ * @return @c false if the frame is not valid JSON
+ */
+bool FrameParser::parseFrame()
+{
+    m_pos = 0;
+    m_depth = 0;
+    m_reusable = true;
+    m_slots.clear();
+    m_current.resize(0);
+
+    if (!expect('{'))
+        return false;
+
+    quint64 seen = 0;
+    bool hasTitle = false;
+    bool hasGroups = false;
+    if (!expect('}'))
+    {
+        forever
+        {
+            const auto key = readKey(&seen);
+            if (key < 0 || !expect(':'))
+                return false;
+
+            Token token;
+            if (key == kTitleKey)
+            {
+                if (!parseValue(&token))
+                    return false;
+
+                hasTitle = (token.type == kString && token.length > 0);
+                addLayout(kTitleKey, token);
+            }
+
+            else if (key == kGraphKey)
+            {
+                if (!expect('['))
+                {
+                    m_reusable = false;
+                    if (!parseValue(&token))
+                        return false;
+                }
+
+                else if (!parseGroups())
+                    return false;
+
+                hasGroups = true;
+            }
+
+            else if (!parseValue(&token))
+                return false;
+
+            if (expect(','))
+                continue;
+            if (expect('}'))
+                break;
+
+            return false;
+        }
+    }
+
+    // Only whitespace is allowed after the frame
+    while (m_pos < m_size && IS_SPACE(m_data[m_pos]))
+        ++m_pos;
+
+    m_reusable = m_reusable && hasTitle && hasGroups;
+    return m_pos == m_size;
+}
+
+/**
+ * Tokenizes the groups array (the opening bracket is already consumed)
+ */
+bool FrameParser::parseGroups()
+{
+    if (expect(']'))
+    {
+        m_reusable = false;
+        return true;
+    }
+
+    forever
+    {
+        if (expect('{'))
+        {
+            if (!parseGroup())
+                return false;
+        }
+
+        else
+        {
+            Token token;
+            m_reusable = false;
+            if (!parseValue(&token))
+                return false;
+        }
+
+        if (expect(','))
+            continue;
+
+        return expect(']');
+    }
+}
+
+/**
+ * Tokenizes a group object (the opening brace is already consumed)
+ */
+bool FrameParser::parseGroup()
+{
+    quint64 seen = 0;
+    bool hasTitle = false;
+    bool hasDatasets = false;
+
+    m_current.append('G');
+    if (!expect('}'))
+    {
+        forever
+        {
+            const auto key = readKey(&seen);
+            if (key < 0 || !expect(':'))
+                return false;
+
+            Token token;
+            if (key == kTitleKey || key == kWidgetKey)
+            {
+                if (!parseValue(&token))
+                    return false;
+
+                if (token.type != kString)
+                    m_reusable = false;
+                if (key == kTitleKey)
+                    hasTitle = (token.length > 0);
+
+                addLayout(static_cast<char>(key), token);
+            }
+
+            else if (key == kDatasetsKey)
+            {
+                if (!expect('['))
+                {
+                    m_reusable = false;
+                    if (!parseValue(&token))
+                        return false;
+                }
+
+                else if (!parseDatasets())
+                    return false;
+
+                hasDatasets = true;
+            }
+
+            else if (!parseValue(&token))
+                return false;
+
+            if (expect(','))
+                continue;
+            if (expect('}'))
+                break;
+
+            return false;
+        }
+    }
+
+    m_current.append('g');
+    m_reusable = m_reusable && hasTitle && hasDatasets;
+    return true;
+}
+
+/**
+ * Tokenizes the datasets array of a group (the opening bracket is already consumed)
+ */
+bool FrameParser::parseDatasets()
+{
+    if (expect(']'))
+    {
+        m_reusable = false;
+        return true;
+    }
+
+    forever
+    {
+        if (expect('{'))
+        {
+            if (!parseDataset())
+                return false;
+        }
+
+        else
+        {
+            Token token;
+            m_reusable = false;
+            if (!parseValue(&token))
+                return false;
+        }
+
+        if (expect(','))
+            continue;
+
+        return expect(']');
+    }
+}
+
+/**
+ * Tokenizes a dataset object (the opening brace is already consumed) & registers the
+ * location of its value & time value
+ */
+bool FrameParser::parseDataset()
+{
+    Slot slot;
+    slot.value = {kMissing, 0, 0};
+    slot.tick = {kMissing, 0, 0};
+
+    quint64 seen = 0;
+    m_current.append('D');
+    if (expect('}'))
+        m_reusable = false;
+
+    else
+    {
+        forever
+        {
+            const auto key = readKey(&seen);
+            if (key < 0 || !expect(':'))
+                return false;
+
+            Token token;
+            if (!parseValue(&token))
+                return false;
+
+            switch (key)
+            {
+                case kTitleKey:
+                case kUnitsKey:
+                case kWidgetKey:
+                    m_reusable = m_reusable && token.type == kString;
+                    addLayout(static_cast<char>(key), token);
+                    break;
+                case kGraphKey:
+                    m_reusable = m_reusable && (token.type == kTrue || token.type == kFalse);
+                    addLayout(static_cast<char>(key), token);
+                    break;
+                case kMinKey:
+                case kMaxKey:
+                    m_reusable = m_reusable && token.type == kNumber;
+                    addLayout(static_cast<char>(key), token);
+                    break;
+                case kValueKey:
+                    m_reusable = m_reusable && token.type != kOther;
+                    slot.value = token;
+                    break;
+                case kTickKey:
+                    m_reusable = m_reusable && token.type != kOther;
+                    slot.tick = token;
+                    break;
+                default:
+                    break;
+            }
+
+            if (expect(','))
+                continue;
+            if (expect('}'))
+                break;
+
+            return false;
+        }
+    }
+
+    m_current.append('d');
+    m_slots.append(slot);
+    return true;
+}
+
+/**
+ * Reads an object key & the colon that follows it.
+ *
+ * Keys of the frame grammar that are repeated in the same object (or escaped) make
+ * the layout non-reusable, since the JSON document parser may interpret them in a
+ * different way.
+ *
+ * @return The key identifier, or -1 on syntax error
+ */
+int FrameParser::readKey(quint64 *seen)
+{
+    Token token;
+    if (!expect('"') || !parseString(&token))
+        return -1;
+
+    if (token.type == kEscapedString)
+    {
+        m_reusable = false;
+        return kUnknownKey;
+    }
+
+    int key = kUnknownKey;
+    const auto str = m_data + token.start;
+    if (token.length == 1)
+    {
+        switch (str[0])
+        {
+            case 't':
+            case 'g':
+            case 'd':
+            case 'v':
+            case 'x':
+            case 'u':
+            case 'w':
+                key = str[0];
+                break;
+            default:
+                break;
+        }
+    }
+
+    else if (token.length == 3 && str[0] == 'm')
+    {
+        if (str[1] == 'i' && str[2] == 'n')
+            key = kMinKey;
+        else if (str[1] == 'a' && str[2] == 'x')
+            key = kMaxKey;
+    }
+
+    if (key != kUnknownKey)
+    {
+        const quint64 bit = Q_UINT64_C(1) << (key - 'A');
+        if (*seen & bit)
+            m_reusable = false;
+
+        *seen |= bit;
+    }
+
+    return key;
+}
+
+/**
+ * Skips whitespace & consumes the given character @a c if it is the next character
+ */
+bool FrameParser::expect(const char c)
+{
+    while (m_pos < m_size && IS_SPACE(m_data[m_pos]))
+        ++m_pos;
+
+    if (m_pos < m_size && m_data[m_pos] == c)
+    {
+        ++m_pos;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * Parses any JSON value, nested objects & arrays are skipped.
+ */
+bool FrameParser::parseValue(Token *token)
+{
+    Q_ASSERT(token);
+
+    while (m_pos < m_size && IS_SPACE(m_data[m_pos]))
+        ++m_pos;
+    if (m_pos >= m_size)
+        return false;
+
+    token->type = kOther;
+    token->start = m_pos;
+    token->length = 0;
+
+    const char c = m_data[m_pos];
+    if (c == '"')
+    {
+        ++m_pos;
+        return parseString(token);
+    }
+
+    if (c == '-' || IS_DIGIT(c))
+        return parseNumber(token);
+
+    if (c == 't')
+    {
+        token->type = kTrue;
+        token->length = 4;
+        return parseLiteral("true", 4);
+    }
+
+    if (c == 'f')
+    {
+        token->type = kFalse;
+        token->length = 5;
+        return parseLiteral("false", 5);
+    }
+
+    if (c == 'n')
+        return parseLiteral("null", 4);
+
+    if (c == '{')
+        return skipContainer('{', '}');
+
+    if (c == '[')
+        return skipContainer('[', ']');
+
+    return false;
+}
+
+/**
+ * Parses a string (the opening quote is already consumed), the token only references
+ * the characters between the quotes.
+ */
+bool FrameParser::parseString(Token *token)
+{
+    Q_ASSERT(token);
+
+    token->type = kString;
+    token->start = m_pos;
+    while (m_pos < m_size)
+    {
+        const auto c = static_cast<uchar>(m_data[m_pos]);
+        if (c == '"')
+        {
+            token->length = m_pos - token->start;
+            ++m_pos;
+            return true;
+        }
+
+        // Control characters must be escaped
+        if (c < 0x20)
+            return false;
+
+        // Validate escape sequence
+        if (c == '\\')
+        {
+            token->type = kEscapedString;
+            if (++m_pos >= m_size)
+                return false;
+
+            const char e = m_data[m_pos];
+            if (e == 'u')
+            {
+                if (m_pos + 4 >= m_size)
+                    return false;
+
+                for (int i = 1; i <= 4; ++i)
+                {
+                    if (HEX_VALUE(m_data[m_pos + i]) < 0)
+                        return false;
+                }
+
+                m_pos += 4;
+            }
+
+            else if (e != '"' && e != '\\' && e != '/' && e != 'b' && e != 'f' && e != 'n'
+                     && e != 'r' && e != 't')
+                return false;
+        }
+
+        ++m_pos;
+    }
+
+    return false;
+}
+
+/**
+ * Parses a number (with the JSON number grammar)
+ */
+bool FrameParser::parseNumber(Token *token)
+{
+    Q_ASSERT(token);
+
+    token->type = kNumber;
+    token->start = m_pos;
+
+    // Sign & integer part
+    if (m_data[m_pos] == '-')
+        ++m_pos;
+    if (m_pos >= m_size || !IS_DIGIT(m_data[m_pos]))
+        return false;
+    if (m_data[m_pos] == '0')
+        ++m_pos;
+    else
+    {
+        while (m_pos < m_size && IS_DIGIT(m_data[m_pos]))
+            ++m_pos;
+    }
+
+    // Fractional part
+    if (m_pos < m_size && m_data[m_pos] == '.')
+    {
+        if (++m_pos >= m_size || !IS_DIGIT(m_data[m_pos]))
+            return false;
+        while (m_pos < m_size && IS_DIGIT(m_data[m_pos]))
+            ++m_pos;
+    }
+
+    // Exponent
+    if (m_pos < m_size && (m_data[m_pos] == 'e' || m_data[m_pos] == 'E'))
+    {
+        if (++m_pos < m_size && (m_data[m_pos] == '+' || m_data[m_pos] == '-'))
+            ++m_pos;
+        if (m_pos >= m_size || !IS_DIGIT(m_data[m_pos]))
+            return false;
+        while (m_pos < m_size && IS_DIGIT(m_data[m_pos]))
+            ++m_pos;
+    }
+
+    token->length = m_pos - token->start;
+    return true;
+}
+
+/**
+ * Consumes the given @a literal (true, false or null)
+ */
+bool FrameParser::parseLiteral(const char *literal, const int length)
+{
+    if (m_pos + length > m_size || qstrncmp(m_data + m_pos, literal, length) != 0)
+        return false;
+
+    m_pos += length;
+    return true;
+}
+
+/**
+ * Skips a nested object or array (delimited by @a open & @a close), the contents are
+ * validated but not registered.
+ */
+bool FrameParser::skipContainer(const char open, const char close)
+{
+    if (!expect(open) || ++m_depth > MAX_DEPTH)
+        return false;
+
+    if (!expect(close))
+    {
+        forever
+        {
+            Token token;
+            if (open == '{')
+            {
+                if (!expect('"') || !parseString(&token) || !expect(':'))
+                    return false;
+            }
+
+            if (!parseValue(&token))
+                return false;
+
+            if (expect(','))
+                continue;
+            if (expect(close))
+                break;
+
+            return false;
+        }
+    }
+
+    --m_depth;
+    return true;
+}
+
+/**
+ * Appends the given structural @a token (tagged with its @a key & type) to the layout
+ * of the current frame
+ */
+void FrameParser::addLayout(const char key, const Token &token)
+{
+    m_current.append(key);
+    m_current.append(static_cast<char>('0' + token.type));
+    m_current.append(m_data + token.start, token.length);
+    m_current.append('\0');
+}
+
+/**
+ * Returns the text of the given value @a token, with the same format as the text
+ * obtained from a JSON document.
+ */
+QString FrameParser::text(const Token &token) const
+{
+    const auto str = m_data + token.start;
+    switch (token.type)
+    {
+        case kString:
+            return QString::fromUtf8(str, token.length);
+        case kEscapedString:
+            return CLEAN_STRING(DECODE_STRING(str, token.length));
+        case kNumber:
+            return QVariant(TO_DOUBLE(str, token.length)).toString();
+        case kTrue:
+            return QStringLiteral("true");
+        case kFalse:
+            return QStringLiteral("false");
+        default:
+            return QString("");
+    }
+}
+
+/**
+ * Returns the numeric value of the given value @a token
+ */
+double FrameParser::number(const Token &token) const
+{
+    if (token.type == kNumber)
+        return TO_DOUBLE(m_data + token.start, token.length);
+
+    return text(token).toDouble();
+}
+
+/**
+ * Writes the values of the datasets of the current frame into the @a values array
+ */
+void FrameParser::readValues(QVector<FrameValue> *values) const
+{
+    Q_ASSERT(values);
+
+    values->resize(m_slots.count());
+    for (int i = 0; i < m_slots.count(); ++i)
+    {
+        const auto &slot = m_slots.at(i);
+        auto &value = (*values)[i];
+        value.text = text(slot.value);
+        if (slot.value.type == kNumber)
+            value.number = TO_DOUBLE(m_data + slot.value.start, slot.value.length);
+        else
+            value.number = value.text.toDouble();
+
+        value.tick = number(slot.tick);
+    }
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef JSON_FRAME_PARSER_H
+#define JSON_FRAME_PARSER_H
+
+#include <QVector>
+#include <QString>
+#include <QByteArray>
+
+#include "FrameSchema.h"
+
+namespace JSON
+{
+/**
+ * Single-pass parser for the JSON frames received in auto mode.
+ *
+ * The parser only understands the Serial Studio frame grammar (project title, groups,
+ * datasets & their "t", "g", "d", "v", "x", "u", "w", "min" & "max" keys), other keys
+ * are skipped. While tokenizing, the raw text of every key that defines the structure
+ * of the frame is appended to a layout string, and the location of each dataset value
+ * is registered.
+ *
+ * If the layout is the same as the one of the previous frame, the values are written
+ * directly into the value array & the schema of the previous frame is reused, no JSON
+ * objects or schema strings are created. Otherwise (or if the frame uses a construct
+ * that the parser does not handle, such as escaped titles), the frame is parsed with
+ * @c QJsonDocument & the @c FrameSchema class, and the new layout is registered.
+ */
+class FrameParser
+{
+public:
+    FrameParser();
+
+    void clear();
+    FrameSchemaPtr read(const QByteArray &data, QVector<FrameValue> *values);
+
+private:
+    enum TokenType
+    {
+        kMissing,
+        kString,
+        kEscapedString,
+        kNumber,
+        kTrue,
+        kFalse,
+        kOther,
+    };
+
+    struct Token
+    {
+        TokenType type;
+        int start;
+        int length;
+    };
+
+    struct Slot
+    {
+        Token value;
+        Token tick;
+    };
+
+    bool parseFrame();
+    bool parseGroups();
+    bool parseGroup();
+    bool parseDatasets();
+    bool parseDataset();
+
+    int readKey(quint64 *seen);
+    bool expect(const char c);
+    bool parseValue(Token *token);
+    bool parseString(Token *token);
+    bool parseNumber(Token *token);
+    bool parseLiteral(const char *literal, const int length);
+    bool skipContainer(const char open, const char close);
+    void addLayout(const char key, const Token &token);
+
+    QString text(const Token &token) const;
+    double number(const Token &token) const;
+    void readValues(QVector<FrameValue> *values) const;
+
+private:
+    int m_pos;
+    int m_size;
+    int m_depth;
+    bool m_reusable;
+    const char *m_data;
+
+    QByteArray m_layout;
+    QByteArray m_current;
+    QVector<Slot> m_slots;
+    FrameSchemaPtr m_schema;
+};
+}
+
+#endif
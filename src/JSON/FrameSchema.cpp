@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "FrameSchema.h"
+
+#include <QHash>
+
+using namespace JSON;
+
+/**
+ * Removes line breaks from the given @a string
+ */
+static QString CLEAN_STRING(QString string)
+{
+    string.replace("\n", "");
+    string.replace("\r", "");
+    return string;
+}
+
+/**
+ * Converts the given JSON @a value to a number, numeric values are used directly
+ * (without converting them to a string & back)
+ */
+static double TO_NUMBER(const QJsonValue &value, const QString &text)
+{
+    if (value.isDouble())
+        return value.toDouble();
+
+    return text.toDouble();
+}
+
+/**
+ * Constructor function
+ */
+FrameSchema::FrameSchema()
+    : m_hash(0)
+{
+}
+
+/**
+ * Returns the structural fingerprint of the schema (calculated from the titles,
+ * widgets, graph flags & dataset counts). Schemas with different fingerprints always
+ * describe different structures.
+ */
+uint FrameSchema::hash() const
+{
+    return m_hash;
+}
+
+/**
+ * Returns the project title of the frame
+ */
+QString FrameSchema::title() const
+{
+    return m_title;
+}
+
+/**
+ * Returns the groups of the frame, each group references a contiguous range of
+ * datasets
+ */
+const QVector<FrameSchema::Group> &FrameSchema::groups() const
+{
+    return m_groups;
+}
+
+/**
+ * Returns the datasets of the frame (of all groups), the values of each frame are
+ * stored in the same order
+ */
+const QVector<FrameSchema::Dataset> &FrameSchema::datasets() const
+{
+    return m_datasets;
+}
+
+/**
+ * Returns @c true if both schemas describe the same frame structure
+ */
+bool FrameSchema::operator==(const FrameSchema &other) const
+{
+    if (m_hash != other.m_hash || m_title != other.m_title)
+        return false;
+
+    if (m_groups.count() != other.m_groups.count())
+        return false;
+
+    if (m_datasets.count() != other.m_datasets.count())
+        return false;
+
+    for (int i = 0; i < m_groups.count(); ++i)
+    {
+        const auto &a = m_groups.at(i);
+        const auto &b = other.m_groups.at(i);
+        if (a.datasetCount != b.datasetCount || a.title != b.title
+            || a.widget != b.widget)
+            return false;
+    }
+
+    for (int i = 0; i < m_datasets.count(); ++i)
+    {
+        const auto &a = m_datasets.at(i);
+        const auto &b = other.m_datasets.at(i);
+        if (a.graph != b.graph || a.min != b.min || a.max != b.max || a.title != b.title
+            || a.units != b.units || a.widget != b.widget)
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * Reads the structure of the given JSON frame @a object & writes the value of each
+ * dataset into the @a values array.
+ *
+ * If the structure is the same as the one of the @a cache schema, the @a cache is
+ * returned, so that consecutive frames share the same schema object.
+ *
+ * Groups without a title or without datasets are ignored (same rules as the
+ * @c Frame class). Datasets with an empty value are kept in the schema, since their
+ * value may change with the next frame.
+ *
+ * @return The schema of the frame, or a null pointer if the frame is not valid
+ */
+FrameSchemaPtr FrameSchema::read(const QJsonObject &object, QVector<FrameValue> *values,
+                                 const FrameSchemaPtr &cache)
+{
+    Q_ASSERT(values);
+    values->clear();
+
+    // We need to have a project title and at least one group
+    QSharedPointer<FrameSchema> schema(new FrameSchema);
+    schema->m_title = CLEAN_STRING(object.value("t").toString());
+    const auto groups = object.value("g").toArray();
+    if (schema->m_title.isEmpty() || groups.isEmpty())
+        return FrameSchemaPtr();
+
+    // Read groups & datasets
+    for (auto i = 0; i < groups.count(); ++i)
+    {
+        const auto group = groups.at(i).toObject();
+        const auto array = group.value("d").toArray();
+
+        Group info;
+        info.title = CLEAN_STRING(group.value("t").toVariant().toString());
+        info.widget = CLEAN_STRING(group.value("w").toVariant().toString());
+        info.firstDataset = schema->m_datasets.count();
+        info.datasetCount = 0;
+        if (info.title.isEmpty() || array.isEmpty())
+            continue;
+
+        for (auto j = 0; j < array.count(); ++j)
+        {
+            const auto dataset = array.at(j).toObject();
+            if (dataset.isEmpty())
+                continue;
+
+            Dataset item;
+            item.group = schema->m_groups.count();
+            item.graph = dataset.value("g").toVariant().toBool();
+            item.min = dataset.value("min").toDouble();
+            item.max = dataset.value("max").toDouble();
+            item.title = CLEAN_STRING(dataset.value("t").toVariant().toString());
+            item.units = CLEAN_STRING(dataset.value("u").toVariant().toString());
+            item.widget = CLEAN_STRING(dataset.value("w").toVariant().toString());
+            schema->m_datasets.append(item);
+
+            values->append(readValue(dataset.value("v"), dataset.value("x")));
+
+            ++info.datasetCount;
+        }
+
+        if (info.datasetCount > 0)
+            schema->m_groups.append(info);
+    }
+
+    // No valid groups
+    if (schema->m_groups.isEmpty())
+    {
+        values->clear();
+        return FrameSchemaPtr();
+    }
+
+    // Reuse the cached schema if the structure did not change
+    schema->updateHash();
+    if (cache && *cache == *schema)
+        return cache;
+
+    return schema;
+}
+
+/**
+ * Returns the position in the value array of each dataset of the given JSON frame
+ * @a object (indexed by group & dataset position in the JSON arrays), datasets that are
+ * not part of the schema are set to -1. The same rules of the @c read() function are
+ * applied, so that values can be written directly into a cached value array.
+ */
+QVector<QVector<int>> FrameSchema::valueIndexes(const QJsonObject &object)
+{
+    int count = 0;
+    QVector<QVector<int>> indexes;
+    const auto valid = !CLEAN_STRING(object.value("t").toString()).isEmpty();
+    const auto groups = object.value("g").toArray();
+    for (auto i = 0; i < groups.count(); ++i)
+    {
+        const auto group = groups.at(i).toObject();
+        const auto array = group.value("d").toArray();
+        const auto title = CLEAN_STRING(group.value("t").toVariant().toString());
+
+        QVector<int> list(array.count(), -1);
+        if (valid && !title.isEmpty())
+        {
+            for (auto j = 0; j < array.count(); ++j)
+            {
+                if (!array.at(j).toObject().isEmpty())
+                    list[j] = count++;
+            }
+        }
+
+        indexes.append(list);
+    }
+
+    // Frame is not valid, no dataset is part of the schema
+    if (count == 0)
+    {
+        for (auto &list : indexes)
+            list.fill(-1);
+    }
+
+    return indexes;
+}
+
+/**
+ * Converts the given JSON dataset @a value ("v") & @a tick ("x") to a frame value
+ */
+FrameValue FrameSchema::readValue(const QJsonValue &value, const QJsonValue &tick)
+{
+    FrameValue result;
+    result.text = CLEAN_STRING(value.toVariant().toString());
+    result.number = TO_NUMBER(value, result.text);
+    result.tick = TO_NUMBER(tick, CLEAN_STRING(tick.toVariant().toString()));
+    return result;
+}
+
+/**
+ * Joins the given @a schemas into a single schema (the values of the merged frame are
+ * the concatenation of the values of each frame). The project title is taken from the
+ * first schema & the group titles are prefixed with the given @a prefixes (if not
+ * empty).
+ */
+FrameSchemaPtr FrameSchema::merge(const QVector<FrameSchemaPtr> &schemas,
+                                  const QStringList &prefixes)
+{
+    Q_ASSERT(schemas.count() == prefixes.count());
+
+    QSharedPointer<FrameSchema> merged(new FrameSchema);
+    for (int i = 0; i < schemas.count(); ++i)
+    {
+        const auto &schema = schemas.at(i);
+        if (!schema)
+            continue;
+
+        if (merged->m_title.isEmpty())
+            merged->m_title = schema->title();
+
+        const auto groupOffset = merged->m_groups.count();
+        const auto datasetOffset = merged->m_datasets.count();
+        for (auto group : schema->groups())
+        {
+            if (!prefixes.at(i).isEmpty())
+                group.title = QString("%1 - %2").arg(prefixes.at(i), group.title);
+
+            group.firstDataset += datasetOffset;
+            merged->m_groups.append(group);
+        }
+
+        for (auto dataset : schema->datasets())
+        {
+            dataset.group += groupOffset;
+            merged->m_datasets.append(dataset);
+        }
+    }
+
+    if (merged->m_groups.isEmpty())
+        return FrameSchemaPtr();
+
+    merged->updateHash();
+    return merged;
+}
+
+/**
+ * Calculates the hash of the structure, used to quickly tell different schemas apart
+ */
+void FrameSchema::updateHash()
+{
+    m_hash = qHash(m_title);
+    for (const auto &group : m_groups)
+    {
+        m_hash = 31 * m_hash + qHash(group.title);
+        m_hash = 31 * m_hash + qHash(group.widget);
+        m_hash = 31 * m_hash + static_cast<uint>(group.datasetCount);
+    }
+
+    for (const auto &dataset : m_datasets)
+    {
+        m_hash = 31 * m_hash + qHash(dataset.title);
+        m_hash = 31 * m_hash + qHash(dataset.units);
+        m_hash = 31 * m_hash + qHash(dataset.widget);
+        m_hash = 31 * m_hash + (dataset.graph ? 1 : 0);
+    }
+}
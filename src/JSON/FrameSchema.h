@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef JSON_FRAME_SCHEMA_H
+#define JSON_FRAME_SCHEMA_H
+
+#include <QVector>
+#include <QString>
+#include <QStringList>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QSharedPointer>
+
+namespace JSON
+{
+/**
+ * Value of a dataset in a received frame. The text is displayed by the UI & written to
+ * CSV files, the number (and the tick) are used by the graphs. Both are obtained only
+ * once, when the frame is generated.
+ */
+struct FrameValue
+{
+    QString text;
+    double number;
+    double tick;
+};
+
+class FrameSchema;
+typedef QSharedPointer<const FrameSchema> FrameSchemaPtr;
+
+/**
+ * Immutable description of the structure of a frame: the project title, the groups &
+ * the titles, units, widgets & graph flags of the datasets.
+ *
+ * Received frames only carry a pointer to their schema & an array with the value of
+ * each dataset (in the same order as the @c datasets() of the schema). Consecutive
+ * frames with the same structure share the same schema object, so modules that
+ * consume frames can detect structure changes by comparing pointers & read the values
+ * by index instead of walking JSON objects.
+ */
+class FrameSchema
+{
+public:
+    struct Group
+    {
+        QString title;
+        QString widget;
+        int firstDataset;
+        int datasetCount;
+    };
+
+    struct Dataset
+    {
+        int group;
+        bool graph;
+        double min;
+        double max;
+        QString title;
+        QString units;
+        QString widget;
+    };
+
+    FrameSchema();
+
+    uint hash() const;
+    QString title() const;
+    const QVector<Group> &groups() const;
+    const QVector<Dataset> &datasets() const;
+    bool operator==(const FrameSchema &other) const;
+
+    static FrameSchemaPtr read(const QJsonObject &object, QVector<FrameValue> *values,
+                               const FrameSchemaPtr &cache = FrameSchemaPtr());
+    static QVector<QVector<int>> valueIndexes(const QJsonObject &object);
+    static FrameValue readValue(const QJsonValue &value, const QJsonValue &tick);
+    static FrameSchemaPtr merge(const QVector<FrameSchemaPtr> &schemas,
+                                const QStringList &prefixes);
+
+private:
+    void updateHash();
+
+private:
+    uint m_hash;
+    QString m_title;
+    QVector<Group> m_groups;
+    QVector<Dataset> m_datasets;
+};
+}
+
+#endif
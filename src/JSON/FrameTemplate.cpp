@@ -0,0 +1,172 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "FrameTemplate.h"
+
+using namespace JSON;
+
+/**
+ * Constructor function
+ */
+FrameTemplate::FrameTemplate()
+    : m_empty(true)
+{
+}
+
+/**
+ * Returns @c true if no template is loaded
+ */
+bool FrameTemplate::isEmpty() const
+{
+    return m_empty;
+}
+
+/**
+ * Returns the schema of the template, or a null pointer if the template does not
+ * describe a valid frame
+ */
+FrameSchemaPtr FrameTemplate::schema() const
+{
+    return m_schema;
+}
+
+/**
+ * Returns the latest value of each dataset of the template (in the same order as the
+ * datasets of the schema)
+ */
+const QVector<FrameValue> &FrameTemplate::values() const
+{
+    return m_values;
+}
+
+/**
+ * Removes the loaded template
+ */
+void FrameTemplate::clear()
+{
+    m_empty = true;
+    m_title.clear();
+    m_schema.clear();
+    m_values.clear();
+    m_slots.clear();
+    m_index.clear();
+}
+
+/**
+ * Loads the given template @a document (generated by calling the JS script with an
+ * empty string), reads its schema & values & builds the slot index.
+ *
+ * Datasets are mapped to their entry of the value array with the
+ * @c FrameSchema::valueIndexes() function.
+ */
+void FrameTemplate::load(const QJsonDocument &document)
+{
+    clear();
+    if (!document.isObject())
+        return;
+
+    // Read the schema & the initial values
+    const auto root = document.object();
+    m_empty = root.isEmpty();
+    m_title = root.value("t").toString();
+    m_schema = FrameSchema::read(root, &m_values);
+
+    // Register datasets with a title & a value
+    const auto indexes = FrameSchema::valueIndexes(root);
+    const auto groups = root.value("g").toArray();
+    for (int i = 0; i < groups.count(); ++i)
+    {
+        const auto group = groups.at(i).toObject();
+        const auto groupTitle = group.value("t").toString();
+        const auto isValid = groups.at(i).isObject() && group.value("d").isArray();
+        const auto array = group.value("d").toArray();
+        for (int j = 0; j < array.count(); ++j)
+        {
+            const auto index = indexes.at(i).at(j);
+            const auto dataset = array.at(j).toObject();
+            if (index < 0 || !isValid || !array.at(j).isObject() || !dataset.contains("t")
+                || !dataset.contains("v"))
+                continue;
+
+            const auto key = qMakePair(groupTitle, dataset.value("t").toString());
+            m_index[key].append(m_slots.count());
+            m_slots.append({index, dataset.contains("x")});
+        }
+    }
+}
+
+/**
+ * Overlays the values of the given partial frame @a data on the template. Values are
+ * only written to datasets with the same group title & dataset title, and only if the
+ * frame title matches the title of the template.
+ *
+ * The optional "x" (time) parameter is copied if it is a number & the template
+ * dataset also contains it.
+ *
+ * @returns @c true if at least one value was written
+ */
+bool FrameTemplate::apply(const QJsonObject &data)
+{
+    // Make sure top-level data formats are matching
+    if (isEmpty() || data.value("t").toString() != m_title)
+        return false;
+
+    // Find the slot of each dataset & write its value
+    bool changed = false;
+    const auto groups = data.value("g").toArray();
+    for (const auto &g : groups)
+    {
+        const auto group = g.toObject();
+        if (!g.isObject() || !group.value("d").isArray())
+            continue;
+
+        const auto groupTitle = group.value("t").toString();
+        const auto datasets = group.value("d").toArray();
+        for (const auto &d : datasets)
+        {
+            const auto dataset = d.toObject();
+            if (!d.isObject() || !dataset.contains("t") || !dataset.contains("v"))
+                continue;
+
+            const auto key = qMakePair(groupTitle, dataset.value("t").toString());
+            const auto it = m_index.constFind(key);
+            if (it == m_index.constEnd())
+                continue;
+
+            const auto time = dataset.value("x");
+            const auto value = FrameSchema::readValue(dataset.value("v"), time);
+            for (const auto index : it.value())
+            {
+                const auto &slot = m_slots.at(index);
+                auto &target = m_values[slot.value];
+                const auto tick = target.tick;
+                target = value;
+                if (!slot.hasTime || !time.isDouble())
+                    target.tick = tick;
+            }
+
+            changed = true;
+        }
+    }
+
+    return changed;
+}
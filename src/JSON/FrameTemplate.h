@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef JSON_FRAME_TEMPLATE_H
+#define JSON_FRAME_TEMPLATE_H
+
+#include <QHash>
+#include <QPair>
+#include <QVector>
+#include <QString>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+
+#include "FrameSchema.h"
+
+namespace JSON
+{
+/**
+ * Data template used in script mode, which allows JS scripts to output only the
+ * datasets that changed with each frame.
+ *
+ * When the template is loaded, its schema & values are read once (check the
+ * @c FrameSchema class). Each dataset that has a title ("t") & a value ("v") is
+ * registered as a slot that points to its entry in the value array, and a hash table
+ * maps each (group title, dataset title) pair to its slots. Partial frames generated
+ * by the script are overlaid by writing directly into the matching values, so the
+ * cost of an update is proportional to the number of updated values instead of the
+ * size of the template.
+ *
+ * The structure of the frame is fixed by the template, so every frame shares the
+ * same schema object & only the value array is copied.
+ */
+class FrameTemplate
+{
+public:
+    FrameTemplate();
+
+    bool isEmpty() const;
+    FrameSchemaPtr schema() const;
+    const QVector<FrameValue> &values() const;
+
+    void clear();
+    void load(const QJsonDocument &document);
+    bool apply(const QJsonObject &data);
+
+private:
+    struct Slot
+    {
+        int value;
+        bool hasTime;
+    };
+
+private:
+    bool m_empty;
+    QString m_title;
+    FrameSchemaPtr m_schema;
+    QVector<FrameValue> m_values;
+
+    QVector<Slot> m_slots;
+    QHash<QPair<QString, QString>, QVector<int>> m_index;
+};
+}
+
+#endif
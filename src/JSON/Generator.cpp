@@ -39,37 +39,73 @@ using namespace JSON;
 static Generator *INSTANCE = nullptr;
 
 /*
- * Regular expresion used to check if there are still unmatched values
- * on the JSON map file.
+ * Maximum number of frames queued before they are sent to the parser threads (batch
+ * scripts)
  */
-static const QRegExp UNMATCHED_VALUES_REGEX("(%\b([0-9]|[1-9][0-9])\b)");
+static const int MAX_BATCH_SIZE = 256;
 
 
 // Prototypes for local functions
-void modifyJsonValue(QJsonValue& destValue, const QString& path, const QJsonValue& newValue);
-void modifyJsonValue(QJsonDocument* doc, const QString& path, const QJsonValue& newValue);
-void processFrame(const QByteArray &data, const quint64 frame, const QDateTime &time, QJSEngine* engine);
-
-
 /**
  * Initializes the JSON Parser class and connects appropiate SIGNALS/SLOTS
  * @todo implement destructor to delete m_template
  */
 Generator::Generator()
     : m_frameCount(0)
-    , m_jsonTemplateMutex(QMutex::NonRecursive)
     , m_opMode(kAutomatic)
+    , m_generation(0)
+    , m_scriptEngine(nullptr)
+    , m_scriptBatch(false)
+    , m_sequence(0)
+    , m_nextSequence(0)
+    , m_batchFrame(0)
 {
     auto io = IO::Manager::getInstance();
     auto cp = CSV::Player::getInstance();
     connect(cp, SIGNAL(openChanged()), this, SLOT(reset()));
     connect(io, SIGNAL(deviceChanged()), this, SLOT(reset()));
 
-    connect(io, SIGNAL(frameReceived(QByteArray)), this, SLOT(readData(QByteArray)));
+    connect(io, SIGNAL(frameReceived(QByteArray,qint64,int)), this,
+            SLOT(readData(QByteArray,qint64,int)));
+    connect(io, SIGNAL(sourcesChanged()), this, SLOT(reset()));
+    connect(&m_jsonMapWatcher, SIGNAL(fileChanged(QString)), this,
+            SLOT(onJsonMapChanged(QString)));
 
-    m_workerThread.start();
+    // Send batch script frames to the workers once all received frames have been queued
+    m_batchTimer.setInterval(0);
+    m_batchTimer.setSingleShot(true);
+    connect(&m_batchTimer, SIGNAL(timeout()), this, SLOT(flushBatch()));
+
+    // Create the pool of frame parser threads (one per CPU core)
+    const auto count = qMax(1, QThread::idealThreadCount());
+    for (int i = 0; i < count; ++i)
+    {
+        auto thread = new QThread(this);
+        auto worker = new JSONWorker;
+        worker->moveToThread(thread);
+        connect(thread, &QThread::finished, worker, &QObject::deleteLater);
+        connect(worker, &JSONWorker::jsonReady, this, &Generator::onJsonReady,
+                Qt::QueuedConnection);
+        thread->setObjectName(QString("JSON::Worker %1").arg(i + 1));
+        thread->start();
+
+        m_threads.append(thread);
+        m_workers.append(worker);
+    }
 
-    LOG_TRACE() << "Class initialized";
+    LOG_TRACE() << "Class initialized with" << count << "frame parser threads";
+}
+
+/**
+ * Destructor function, stops the frame parser threads
+ */
+Generator::~Generator()
+{
+    for (auto thread : m_threads)
+    {
+        thread->quit();
+        thread->wait();
+    }
 }
 
 /**
@@ -105,21 +141,6 @@ QString Generator::jsonMapFilename() const
     return "";
 }
 
-QJsonDocument* Generator::openJsonTemplate() {
-    m_jsonTemplateMutex.lock();
-    return &m_jsonTemplate;
-}
-
-void Generator::closeJsonTemplate() {
-    m_jsonTemplateMutex.unlock();
-}
-
-void Generator::saveJsonTemplate(QJsonDocument &tmpl) {
-    ///Do Mutex
-    //m_jsonTemplate = tmpl;
-}
-
-
 /**
  * Returns the file path of the loaded JSON map file
  */
@@ -158,25 +179,8 @@ void Generator::loadJsonMap()
                                              tr("JSON or JS files") + " (*.json *.js)");
 
 
-    if (!file.isEmpty()) {
+    if (!file.isEmpty())
         loadJsonMap(file);
-
-        if (operationMode() == kScript) {
-            // If the data template is empty, get the template by passing-in an empty string.
-            // Get the data template by passing-in an empty string
-            QJSEngine engine_tmpl;
-            QJSValue result_tmpl;
-            QJSValue js_tmpl = engine_tmpl.evaluate(Generator::getInstance()->jsonMapData().toUtf8());
-            QJSValueList tmpl_args;
-            tmpl_args << QString::fromUtf8("");
-            result_tmpl = js_tmpl.call(tmpl_args);
-
-            if ((result_tmpl.isError() == false) && (result_tmpl.isObject() == true)) {
-                //m_jsonTemplate = QJsonObject(result_tmpl.toVariant().toJsonObject());
-                m_jsonTemplate = QJsonDocument::fromVariant(result_tmpl.toVariant());
-            }
-        }
-    }
 }
 
 /**
@@ -198,6 +202,10 @@ void Generator::loadJsonMap(const QString &path, const bool silent)
         emit jsonFileMapChanged();
     }
 
+    // Stop watching the previous file
+    if (!m_jsonMapWatcher.files().isEmpty())
+        m_jsonMapWatcher.removePaths(m_jsonMapWatcher.files());
+
     // Try to open the file (read only mode)
     m_jsonMap.setFileName(path);
     if (m_jsonMap.open(QFile::ReadOnly))
@@ -233,6 +241,10 @@ void Generator::loadJsonMap(const QString &path, const bool silent)
 
             writeSettings(path);
             m_jsonMapData = QString::fromUtf8(data);
+            m_jsonMapWatcher.addPath(path);
+            compileScript();
+            configureWorkers();
+
             if (!silent)
                 Misc::Utilities::showMessageBox(
                     tr("JSON map file loaded successfully!"),
@@ -274,6 +286,8 @@ void Generator::loadJsonMap(const QString &path, const bool silent)
 void Generator::setOperationMode(const OperationMode mode)
 {
     m_opMode = mode;
+    compileScript();
+    configureWorkers();
     emit operationModeChanged();
 
     LOG_TRACE() << "Operation mode set to" << mode;
@@ -305,13 +319,21 @@ void Generator::writeSettings(const QString &path)
  */
 void Generator::loadJFI(const JFI_Object &info)
 {
+    auto io = IO::Manager::getInstance();
     bool csvOpen = CSV::Player::getInstance()->isOpen();
-    bool devOpen = IO::Manager::getInstance()->connected();
+    bool devOpen = io->connected() || io->auxiliarySourceCount() > 0;
 
     if (csvOpen || devOpen)
     {
         if (JFI_Valid(info))
-            emit jsonChanged(info);
+        {
+            auto frame = info;
+            if (!csvOpen && io->auxiliarySourceCount() > 0)
+                frame = mergeSources(info);
+
+            updateGeneration(&frame);
+            emit jsonChanged(frame);
+        }
     }
 
     else
@@ -319,669 +341,535 @@ void Generator::loadJFI(const JFI_Object &info)
 }
 
 /**
- * Create a new JFI event with the given @a JSON document and increment the frame count
- * --> This is used only by the replay feature
+ * Reloads the JSON map/JS script when the file is modified by another application, so
+ * that the script is recompiled without having to select the file again.
  */
-void Generator::loadJSON(const QJsonDocument &json)
+void Generator::onJsonMapChanged(const QString &path)
 {
-    auto jfi = JFI_CreateNew(m_frameCount, QDateTime::currentDateTime(), json);
-    m_frameCount++;
-    loadJFI(jfi);
-}
-
-/**
- * Resets all the statistics related to the current device and the JSON map file
- * If there's a JSON template, then we reload it.
- */
-void Generator::reset()
-{
-    m_frameCount = 0;
-
-    emit jsonChanged(JFI_Empty());
+    if (QFileInfo::exists(path))
+        loadJsonMap(path, true);
 }
 
 /**
- * Tries to parse the given data as a JSON document according to the selected
- * operation mode.
+ * Compiles the loaded JS script (in script mode) & obtains the data template by calling
+ * the parser function with an empty string.
  *
- * Possible operation modes:
- * - Auto:   serial data contains the JSON data frame
- * - Manual: serial data only contains the comma-separated values, and we need
- *           to use a JSON map file (given by the user) to know what each value
- *           means
+ * Creating a new engine & evaluating the script for every received frame takes several
+ * milliseconds, so the script is only compiled when it is loaded or modified (each
+ * frame parser thread compiles its own copy, check @c configureWorkers()).
  *
- * If JSON parsing is successfull, then the class shall notify the rest of the
- * application in order to process packet data.
+ * Frames are only queued in batches if the parser function has a callable @c batch
+ * property, otherwise each frame is sent to the parser threads as soon as it is
+ * received.
  */
-void Generator::readData(const QByteArray &data)
+void Generator::compileScript()
 {
-    // CSV-replay active, abort
-    if (CSV::Player::getInstance()->isOpen())
+    // Discard previous template
+    m_scriptBatch = false;
+    m_jsonTemplate.clear();
+
+    // Nothing to compile
+    if (operationMode() != kScript || m_jsonMapData.isEmpty())
         return;
 
-    // Data empty, abort
-    if (data.isEmpty()) {
+    // Create the JS engine (only once)
+    if (!m_scriptEngine)
+        m_scriptEngine = new QJSEngine(this);
+
+    // Compile the script, the result is the parser function
+    auto function = m_scriptEngine->evaluate(m_jsonMapData, jsonMapFilepath());
+    if (function.isError() || !function.isCallable())
+    {
+        LOG_TRACE() << "JS script error" << function.toString();
         return;
     }
 
-    // Increment received frames
-    m_frameCount++;
-    //LOG_INFO() << "Frame Count:" << m_frameCount;
+    // Check if the script can parse several frames at once
+    m_scriptBatch = function.property("batch").isCallable();
 
-    QJSEngine* engine = nullptr;
-    processFrame(data, m_frameCount, QDateTime::currentDateTime(), engine);
-
-    /// This uses a separate thread to process the input.
-    /// The idea is to take load out of the UI thread, but doing so can create
-    /// out-of-order problems.  A better idea is to put the data reception
-    /// in a different thread than the UI.
-    ///@todo implement that data reception thread.
-    /*
-    // Create new worker thread to read JSON data
-    QThread *thread = new QThread;
-    JSONWorker *worker = new JSONWorker(data, m_frameCount, QDateTime::currentDateTime());
-    worker->moveToThread(thread);
-
-    connect(thread, SIGNAL(started()), worker, SLOT(process()));
-    connect(worker, SIGNAL(finished()), thread, SLOT(quit()));
-    connect(worker, SIGNAL(finished()), worker, SLOT(deleteLater()));
-    connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
-    connect(worker, &JSONWorker::jsonReady, this, &Generator::loadJFI);
-    thread->start();
-    */
-}
+    // Get the data template by passing-in an empty string
+    QJSValueList args;
+    args << QString::fromUtf8("");
+    auto result = function.call(args);
+    if (!result.isError() && result.isObject())
+        m_jsonTemplate.load(QJsonDocument::fromVariant(result.toVariant()));
 
-//----------------------------------------------------------------------------------------
-// JSON worker object (executed for each frame on a new thread)
-//----------------------------------------------------------------------------------------
+    LOG_TRACE() << "JS script compiled successfully";
+}
 
 /**
- * Constructor function, stores received frame data & the date/time that the frame data
- * was received.
- */
-JSONWorker::JSONWorker(const QByteArray &data, const quint64 frame, const QDateTime &time)
-    : m_time(time)
-    , m_data(data)
-    , m_frame(frame)
-    , m_engine(nullptr)
+ * Sends the current operation mode & JSON map data to the frame parser threads. Frames
+ * that are already queued are parsed with the previous configuration.
+ */
+void Generator::configureWorkers()
 {
+    flushBatch();
+
+    const auto mode = m_opMode;
+    const auto data = m_jsonMapData;
+    for (auto worker : m_workers)
+    {
+        QMetaObject::invokeMethod(
+            worker, [=] { worker->configure(mode, data); }, Qt::QueuedConnection);
+    }
 }
 
 /**
- * Reads the frame & inserts its values on the JSON map, and/or extracts the JSON frame
- * directly from the serial data.
+ * Called when a frame parser thread has processed the frame with the given
+ * @a sequence number. Results are buffered until all the previous frames have been
+ * processed, so that frames are loaded strictly in the order in which they were
+ * received, regardless of the thread that parsed them.
+ *
+ * If the @a partial document is not empty, the frame was generated by a JS script &
+ * its values are overlaid on the data template before building the frame schema &
+ * values.
  */
-void JSONWorker::process()
+void Generator::onJsonReady(const JFI_Object &info, const quint64 sequence,
+                            const QJsonDocument &partial)
 {
-    // Init variables
-    QJsonParseError error;
-    QJsonDocument document;
+    // Frame was received before the last reset, discard it
+    if (sequence < m_nextSequence)
+        return;
 
-    // Serial device sends JSON (auto mode)
-    if (Generator::getInstance()->operationMode() == Generator::kAutomatic)
-        document = QJsonDocument::fromJson(m_data, &error);
+    // Wait until all previous frames have been processed
+    m_pendingFrames.insert(sequence, qMakePair(info, partial));
 
-    // We need to use a map file, check if its loaded & replace values into map
-    else if (Generator::getInstance()->operationMode() == Generator::kManual)
+    // Release processed frames in order
+    while (!m_pendingFrames.isEmpty() && m_pendingFrames.firstKey() == m_nextSequence)
     {
-        // Initialize javscript engine
-        m_engine = new QJSEngine(this);
+        auto result = m_pendingFrames.take(m_nextSequence);
+        ++m_nextSequence;
 
-        // Empty JSON map data
-        if (Generator::getInstance()->jsonMapData().isEmpty())
-            return;
+        auto frame = result.first;
+        if (!result.second.isEmpty())
+            applyTemplate(result.second, &frame);
 
-        // Init conversion status boolean
-        bool ok = true;
-
-        // Separate incoming data & add it to the JSON map
-        auto json = Generator::getInstance()->jsonMapData();
-        auto list = QString::fromUtf8(m_data).split(',');
-        for (int i = 0; i < list.count(); ++i)
+        // Frames that could not be parsed have no schema
+        if (JFI_Valid(frame))
         {
-            // Get value at i & insert it into json
-            auto str = list.at(i);
-            auto mod = json.arg(str);
-
-            // If JSON after insertion is different we're good to go
-            if (json != mod)
-                json = mod;
-
-            // JSON is the same after insertion -> format error
-            else
-            {
-                ok = false;
-                break;
-            }
+            shareSchema(&frame);
+            loadJFI(frame);
         }
+    }
+}
 
-        // Test that JSON does not contain unmatched values
-        if (ok)
-            ok = !(json.contains(UNMATCHED_VALUES_REGEX));
+/**
+ * Overlays the values of the partial frame generated by the JS script (@a document) on
+ * the data template & writes the resulting schema & values to the given @a frame, so
+ * that the script does not need to output the whole dataset on every frame. If there
+ * is no template, the schema & values are read from the @a document.
+ *
+ * This is done in the GUI thread (in the same order in which frames were received),
+ * because the template holds the latest value of each dataset. The template schema is
+ * shared by all frames, so only the value array is copied. Check the
+ * @c FrameTemplate class for more information.
+ */
+void Generator::applyTemplate(const QJsonDocument &document, JFI_Object *frame)
+{
+    Q_ASSERT(frame);
 
-        // There was an error & the JSON map is incomplete (or misses received
-        // info from the microcontroller).
-        if (!ok)
-            return;
+    // No template, output the document generated by the script
+    if (m_jsonTemplate.isEmpty())
+    {
+        const auto cache = m_schemas.value(frame->sourceId);
+        frame->schema = FrameSchema::read(document.object(), &frame->values, cache);
+    }
 
-        // Create json document
-        auto jsonDocument = QJsonDocument::fromJson(json.toUtf8(), &error);
+    // Overlay new values into the template, output the updated template if there is
+    // any match
+    else if (m_jsonTemplate.apply(document.object()))
+    {
+        frame->schema = m_jsonTemplate.schema();
+        frame->values = m_jsonTemplate.values();
+    }
+}
 
-        // Calculate dynamically generated values
-        auto root = jsonDocument.object();
-        auto groups = root.value("g").toArray();
-        for (int i = 0; i < groups.count(); ++i)
-        {
-            // Get group
-            auto group = groups.at(i).toObject();
-
-            // Evaluate each dataset of the current group
-            auto datasets = group.value("d").toArray();
-            for (int j = 0; j < datasets.count(); ++j)
-            {
-                // Get dataset object & value
-                auto dataset = datasets.at(j).toObject();
-                auto value = dataset.value("v").toString();
-
-                // Evaluate code in dataset value (if any)
-                auto jsValue = m_engine->evaluate(value);
-
-                // Code execution correct, replace value in JSON
-                if (!jsValue.isError())
-                {
-                    dataset.remove("v");
-                    dataset.insert("v", jsValue.toString());
-                    datasets.replace(j, dataset);
-                }
-            }
-
-            // Replace group datasets
-            group.remove("d");
-            group.insert("d", datasets);
-            groups.replace(i, group);
-        }
+/**
+ * Combines the latest frame received from each data source into a single frame, so
+ * that the groups of all the devices are displayed in the same dashboard.
+ *
+ * The title of the frame is taken from the main device (or from the first source that
+ * sent a frame), and the titles of the groups of additional sources are prefixed with
+ * the name of the source in order to tell them apart.
+ */
+JFI_Object Generator::mergeSources(const JFI_Object &info)
+{
+    // Register latest frame of the source
+    m_sourceFrames.insert(info.sourceId, info);
 
-        // Replace root document group objects
-        root.remove("g");
-        root.insert("g", groups);
+    // Join the values of all sources (in order of source ID)
+    QVector<FrameValue> values;
+    QVector<FrameSchemaPtr> schemas;
+    for (auto i = m_sourceFrames.constBegin(); i != m_sourceFrames.constEnd(); ++i)
+    {
+        values += i.value().values;
+        schemas.append(i.value().schema);
+    }
 
-        // Create JSON document
-        document = QJsonDocument(root);
+    // Rebuild the merged schema only if the structure of any source changed
+    if (schemas != m_mergedSources)
+    {
+        QStringList prefixes;
+        auto io = IO::Manager::getInstance();
+        for (auto i = m_sourceFrames.constBegin(); i != m_sourceFrames.constEnd(); ++i)
+            prefixes.append(i.key() != 0 ? io->sourceName(i.key()) : QString());
 
-        // Delete javacript engine
-        m_engine->deleteLater();
+        m_mergedSources = schemas;
+        m_mergedSchema = FrameSchema::merge(schemas, prefixes);
     }
 
-    // We need to use a custom script to parse the input
-    // Generator::getInstance()->operationMode() == Generator::kScript
-    ///@todo It would be nice to only uptake and compile the script once,
-    ///      then reuse the jsfn object on new input data.
-    else {
-        //LOG_INFO() << "Data ingested:" << m_data;
-        // Exit on Empty JS script
-        if (Generator::getInstance()->jsonMapData().isEmpty())
-            return;
-
-        // Call the script again on real data
-        m_engine = new QJSEngine(this);
+    // Build merged frame
+    return JFI_CreateNew(info.frameNumber, info.rxTimestamp, m_mergedSchema, values,
+                         info.sourceId);
+}
 
-        // "jsfn" is a function created when the QJSEngine compiles the script text.
-        QJSValue jsfn = m_engine->evaluate(Generator::getInstance()->jsonMapData().toUtf8());
-        QJSValue result;
+/**
+ * Replaces the schema of the given frame @a info with the schema of the previous frame
+ * of the same source if both describe the same structure. Each parser thread keeps its
+ * own schema, this ensures that modules that consume frames only see a new schema
+ * object when the structure of the frame actually changes.
+ */
+void Generator::shareSchema(JFI_Object *info)
+{
+    Q_ASSERT(info);
 
-        QJSValueList args;
-        args << QString::fromUtf8(m_data);
-        result = jsfn.call(args);
+    auto &schema = m_schemas[info->sourceId];
+    if (schema && schema != info->schema && *schema == *info->schema)
+        info->schema = schema;
+    else
+        schema = info->schema;
+}
 
-        if (result.isError()) {
-            //LOG_INFO() << "Script failed";
-            error.error = QJsonParseError::MissingObject;
-        }
-        else {
-            // Default error if no matching data: missing object
-            error.error = QJsonParseError::MissingObject;
-
-            // There are two options
-            // 1. use the template, which accepts input as partial dataset
-            // 2. don't use a template, thus input must contain the entire dataset
-            //LOG_INFO() << document.toJson().simplified();
-
-            // Overlay new values into the template.
-            // This is a deep loop that matches the input data hierachy against the template data hierarchy.
-            // Where there is overlay, the data values are written to the template.
-            // If there is any success, the updated template is converted to output document.
-            QJsonDocument* tmpl = Generator::getInstance()->openJsonTemplate();
-            //LOG_INFO() << "tmpl" << tmpl;
-
-            if (!tmpl->isEmpty()) {
-                bool change_made = false;
-                QJsonObject data = QJsonObject(result.toVariant().toJsonObject());
-
-                // Make sure top-level data formats are matching
-                if (QString::compare(data["t"].toString(), (*tmpl)["t"].toString()) == 0) {
-                    //LOG_INFO() << "data[t]" << data["t"].toString();
-
-                    if (data["g"].isArray() && (*tmpl)["g"].isArray()) {
-                        QJsonArray t_groups = (*tmpl)["g"].toArray();
-                        QJsonArray d_groups = data["g"].toArray();
-                        int tg, dg;
-                        for (tg = 0; tg < t_groups.count(); ++tg) {
-                            if (!t_groups[tg].isObject()) continue;
-                            if (!t_groups[tg].toObject().contains("d")) continue;
-                            if (!t_groups[tg].toObject()["d"].isArray()) continue;
-
-                            for (dg = 0; dg < d_groups.count(); ++dg) {
-                                if (!d_groups[dg].isObject()) continue;
-                                if (!d_groups[dg].toObject().contains("d")) continue;
-                                if (!d_groups[dg].toObject()["d"].isArray()) continue;
-
-                                // Make sure group types are matching
-                                if (QString::compare(d_groups[dg].toObject()["t"].toString(), t_groups[tg].toObject()["t"].toString()) != 0)
-                                    continue;
-
-                                QJsonArray tg_data = t_groups[tg].toObject()["d"].toArray();
-                                QJsonArray dg_data = d_groups[dg].toObject()["d"].toArray();
-                                int tgd, dgd;
-                                for (tgd = 0; tgd < tg_data.count(); ++tgd ) {
-                                    if (!tg_data[tgd].isObject()) continue;
-                                    if (!(tg_data[tgd].toObject().contains("t") && tg_data[tgd].toObject().contains("v"))) continue;
-
-                                    for (dgd = 0; dgd != dg_data.count(); ++dgd ) {
-                                        if (!dg_data[dgd].isObject()) continue;
-                                        if (!(dg_data[dgd].toObject().contains("t") && dg_data[dgd].toObject().contains("v"))) continue;
-
-                                        // Make sure data item types are matching
-                                        if (QString::compare(dg_data[dgd].toObject()["t"].toString(), tg_data[tgd].toObject()["t"].toString()) != 0)
-                                            continue;
-
-                                        // Finally! Copy data from input to template
-                                        modifyJsonValue(tmpl, QString("g[%1].d[%2].v").arg(tg).arg(tgd), dg_data[dgd].toObject()["v"]);
-
-                                        // If data contains the optional x (time) parameter, copy that too
-                                        if (tg_data[tgd].toObject().contains("x") && dg_data[dgd].toObject().contains("x")) {
-                                            if (dg_data[dgd].toObject()["x"].isDouble()) {
-                                                modifyJsonValue(tmpl, QString("g[%1].d[%2].x").arg(tg).arg(tgd), dg_data[dgd].toObject()["x"]);
-                                            }
-                                        }
-
-                                        ///@todo need to copy this back into tmpl itself
-
-                                        // Need to flag that a change was made in order for document to be outputted
-                                        change_made = true;
-                                    }
-                                }
-                            }
-                        }
-                    }
-                    if (change_made) {
-                        document = *tmpl;
-                    }
-                }
-                // Give Mutex
-            }
-
-            // Do not use a template, just package the object generated by the script
-            else {
-                document = QJsonDocument::fromVariant(result.toVariant());
-            }
-
-            if (!document.isEmpty()) {
-                //LOG_INFO() << document.toJson().simplified();
-                error.error = QJsonParseError::NoError;
-            }
-
-            Generator::getInstance()->closeJsonTemplate();
-        }
+/**
+ * Assigns the structure generation number to the given frame @a info. The generation
+ * is incremented when the fingerprint & the contents of the frame schema are
+ * different from the schema of the previous frame, so that other modules only need
+ * to rebuild their models when the generation changes.
+ */
+void Generator::updateGeneration(JFI_Object *info)
+{
+    Q_ASSERT(info);
 
-        m_engine->deleteLater();
-    }
+    if (info->schema != m_schema)
+    {
+        const auto &schema = info->schema;
+        if (m_schema && m_schema->hash() == schema->hash() && *m_schema == *schema)
+            info->schema = m_schema;
 
-    // No parse error, update UI & reset error counter
-    if (error.error == QJsonParseError::NoError) {
-        emit jsonReady(JFI_CreateNew(m_frame, m_time, document));
+        else
+        {
+            m_schema = schema;
+            ++m_generation;
+        }
     }
 
-    // Delete object in 500 ms
-    QTimer::singleShot(500, this, SIGNAL(finished()));
+    info->generation = m_generation;
 }
 
+/**
+ * Create a new JFI event with the given @a JSON document and increment the frame count
+ * --> This is used only by the replay feature
+ */
+void Generator::loadJSON(const QJsonDocument &json)
+{
+    QVector<FrameValue> values;
+    auto schema = FrameSchema::read(json.object(), &values, m_schemas.value(0));
+    auto jfi = JFI_CreateNew(m_frameCount, JFI_Timestamp(), schema, values);
+    m_frameCount++;
 
+    if (JFI_Valid(jfi))
+    {
+        shareSchema(&jfi);
+        loadJFI(jfi);
+    }
+}
 
-void processFrame(const QByteArray &data, const quint64 frame, const QDateTime &time, QJSEngine *engine) {
-    // Init variables
-    QJsonParseError error;
-    QJsonDocument document;
+/**
+ * Resets all the statistics related to the current device and the JSON map file
+ * If there's a JSON template, then we reload it.
+ */
+void Generator::reset()
+{
+    m_frameCount = 0;
+    m_schema.clear();
+    m_schemas.clear();
+    m_sourceFrames.clear();
+    m_mergedSources.clear();
+    m_mergedSchema.clear();
+
+    // Discard frames that are being processed
+    m_batch.clear();
+    m_batchTimer.stop();
+    m_pendingFrames.clear();
+    m_nextSequence = m_sequence;
 
-    // Serial device sends JSON (auto mode)
-    if (Generator::getInstance()->operationMode() == Generator::kAutomatic)
-        document = QJsonDocument::fromJson(data, &error);
+    emit jsonChanged(JFI_Empty());
+}
 
-    // We need to use a map file, check if its loaded & replace values into map
-    else if (Generator::getInstance()->operationMode() == Generator::kManual)
-    {
-        // Empty JSON map data
-        if (Generator::getInstance()->jsonMapData().isEmpty())
-            return;
+/**
+ * Splits the queued script frames into contiguous chunks (one per parser thread), so
+ * that the @c batch function of the JS script processes several frames per call in
+ * every thread of the pool (check the @c JSONWorker::processBatch() function).
+ *
+ * Each frame keeps its own frame number & sequence number, so results are still
+ * released in order by the @c onJsonReady() function.
+ */
+void Generator::flushBatch()
+{
+    // Nothing to send
+    m_batchTimer.stop();
+    if (m_batch.isEmpty())
+        return;
 
-        // Initialize javscript engine
-        engine = new QJSEngine();
+    // Get chunk size, so that all the parser threads get work
+    const auto count = m_batch.count();
+    const auto workers = m_workers.count();
+    const auto size = (count + workers - 1) / workers;
 
-        // Init conversion status boolean
-        bool ok = true;
+    // Send each chunk to a parser thread, reserving one sequence number per frame
+    for (int i = 0, index = 0; index < count; ++i, index += size)
+    {
+        const auto frames = m_batch.mid(index, size);
+        const auto first = m_batchFrame + static_cast<quint64>(index);
+        const auto sequence = m_sequence;
+        m_sequence += static_cast<quint64>(frames.count());
+
+        auto worker = m_workers.at(i);
+        QMetaObject::invokeMethod(
+            worker, [=] { worker->processBatch(frames, first, sequence); },
+            Qt::QueuedConnection);
+    }
 
-        // Separate incoming data & add it to the JSON map
-        auto json = Generator::getInstance()->jsonMapData();
-        auto list = QString::fromUtf8(data).split(',');
-        for (int i = 0; i < list.count(); ++i)
-        {
-            // Get value at i & insert it into json
-            auto str = list.at(i);
-            auto mod = json.arg(str);
-
-            // If JSON after insertion is different we're good to go
-            if (json != mod)
-                json = mod;
-
-            // JSON is the same after insertion -> format error
-            else
-            {
-                ok = false;
-                break;
-            }
-        }
+    m_batch.clear();
+}
 
-        // Test that JSON does not contain unmatched values
-        if (ok)
-            ok = !(json.contains(UNMATCHED_VALUES_REGEX));
+/**
+ * Tries to parse the given data as a JSON document according to the selected
+ * operation mode.
+ *
+ * Possible operation modes:
+ * - Auto:   serial data contains the JSON data frame
+ * - Manual: serial data only contains the comma-separated values, and we need
+ *           to use a JSON map file (given by the user) to know what each value
+ *           means
+ *
+ * Frames are parsed by a pool of threads, if JSON parsing is successfull, then the
+ * class shall notify the rest of the application in order to process packet data
+ * (check the @c onJsonReady() function). If the JS script defines a @c batch
+ * function, the frames received in the same read cycle are sent to the parser threads
+ * in batches.
+ *
+ * The @a timestamp is the monotonic clock time (in nanoseconds) at which the frame was
+ * read from the device, it is stored in the generated JFI structure together with the
+ * @a sourceId of the device that sent the frame.
+ */
+void Generator::readData(const QByteArray &data, const qint64 timestamp,
+                         const int sourceId)
+{
+    // CSV-replay active, abort
+    if (CSV::Player::getInstance()->isOpen())
+        return;
 
-        // There was an error & the JSON map is incomplete (or misses received
-        // info from the microcontroller).
-        if (!ok)
-            return;
+    // Data empty, abort
+    if (data.isEmpty()) {
+        return;
+    }
 
-        // Create json document
-        auto jsonDocument = QJsonDocument::fromJson(json.toUtf8(), &error);
+    // Increment received frames
+    m_frameCount++;
+    //LOG_INFO() << "Frame Count:" << m_frameCount;
 
-        // Calculate dynamically generated values
-        auto root = jsonDocument.object();
-        auto groups = root.value("g").toArray();
-        for (int i = 0; i < groups.count(); ++i)
+    // Batch script, queue the frame & send it to a parser thread with the next batch
+    if (m_opMode == kScript && m_scriptBatch)
+    {
+        if (m_batch.isEmpty())
         {
-            // Get group
-            auto group = groups.at(i).toObject();
-
-            // Evaluate each dataset of the current group
-            auto datasets = group.value("d").toArray();
-            for (int j = 0; j < datasets.count(); ++j)
-            {
-                // Get dataset object & value
-                auto dataset = datasets.at(j).toObject();
-                auto value = dataset.value("v").toString();
-
-                // Evaluate code in dataset value (if any)
-                auto jsValue = engine->evaluate(value);
-
-                // Code execution correct, replace value in JSON
-                if (!jsValue.isError())
-                {
-                    dataset.remove("v");
-                    dataset.insert("v", jsValue.toString());
-                    datasets.replace(j, dataset);
-                }
-            }
-
-            // Replace group datasets
-            group.remove("d");
-            group.insert("d", datasets);
-            groups.replace(i, group);
+            m_batchFrame = m_frameCount;
+            m_batchTimer.start();
         }
 
-        // Replace root document group objects
-        root.remove("g");
-        root.insert("g", groups);
-
-        // Create JSON document
-        document = QJsonDocument(root);
-
-        // Delete javacript engine
-        engine->deleteLater();
-    }
-
-    // We need to use a custom script to parse the input
-    // Generator::getInstance()->operationMode() == Generator::kScript
-    ///@todo It would be nice to only uptake and compile the script once,
-    ///      then reuse the jsfn object on new input data.
-    else {
-        //LOG_INFO() << "Data ingested:" << m_data;
-        // Exit on Empty JS script
-        if (Generator::getInstance()->jsonMapData().isEmpty())
-            return;
-
-        // Call the script again on real data
-        engine = new QJSEngine();
-
-        // "jsfn" is a function created when the QJSEngine compiles the script text.
-        QJSValue jsfn = engine->evaluate(Generator::getInstance()->jsonMapData().toUtf8());
-        QJSValue result;
-
-        QJSValueList args;
-        args << QString::fromUtf8(data);
-        result = jsfn.call(args);
-
-        if (result.isError()) {
-            //LOG_INFO() << "Script failed";
-            error.error = QJsonParseError::MissingObject;
-        }
-        else {
-            // Default error if no matching data: missing object
-            error.error = QJsonParseError::MissingObject;
-
-            // There are two options
-            // 1. use the template, which accepts input as partial dataset
-            // 2. don't use a template, thus input must contain the entire dataset
-            //LOG_INFO() << document.toJson().simplified();
-
-            // Overlay new values into the template.
-            // This is a deep loop that matches the input data hierachy against the template data hierarchy.
-            // Where there is overlay, the data values are written to the template.
-            // If there is any success, the updated template is converted to output document.
-            QJsonDocument* tmpl = Generator::getInstance()->openJsonTemplate();
-            //LOG_INFO() << "tmpl" << tmpl;
-
-            if (!tmpl->isEmpty()) {
-                bool change_made = false;
-                QJsonObject data = QJsonObject(result.toVariant().toJsonObject());
-
-                // Make sure top-level data formats are matching
-                if (QString::compare(data["t"].toString(), (*tmpl)["t"].toString()) == 0) {
-                    //LOG_INFO() << "data[t]" << data["t"].toString();
-
-                    if (data["g"].isArray() && (*tmpl)["g"].isArray()) {
-                        QJsonArray t_groups = (*tmpl)["g"].toArray();
-                        QJsonArray d_groups = data["g"].toArray();
-                        int tg, dg;
-                        for (tg = 0; tg < t_groups.count(); ++tg) {
-                            if (!t_groups[tg].isObject()) continue;
-                            if (!t_groups[tg].toObject().contains("d")) continue;
-                            if (!t_groups[tg].toObject()["d"].isArray()) continue;
-
-                            for (dg = 0; dg < d_groups.count(); ++dg) {
-                                if (!d_groups[dg].isObject()) continue;
-                                if (!d_groups[dg].toObject().contains("d")) continue;
-                                if (!d_groups[dg].toObject()["d"].isArray()) continue;
-
-                                // Make sure group types are matching
-                                if (QString::compare(d_groups[dg].toObject()["t"].toString(), t_groups[tg].toObject()["t"].toString()) != 0)
-                                    continue;
-
-                                QJsonArray tg_data = t_groups[tg].toObject()["d"].toArray();
-                                QJsonArray dg_data = d_groups[dg].toObject()["d"].toArray();
-                                int tgd, dgd;
-                                for (tgd = 0; tgd < tg_data.count(); ++tgd ) {
-                                    if (!tg_data[tgd].isObject()) continue;
-                                    if (!(tg_data[tgd].toObject().contains("t") && tg_data[tgd].toObject().contains("v"))) continue;
-
-                                    for (dgd = 0; dgd != dg_data.count(); ++dgd ) {
-                                        if (!dg_data[dgd].isObject()) continue;
-                                        if (!(dg_data[dgd].toObject().contains("t") && dg_data[dgd].toObject().contains("v"))) continue;
-
-                                        // Make sure data item types are matching
-                                        if (QString::compare(dg_data[dgd].toObject()["t"].toString(), tg_data[tgd].toObject()["t"].toString()) != 0)
-                                            continue;
-
-                                        // Finally! Copy data from input to template
-                                        modifyJsonValue(tmpl, QString("g[%1].d[%2].v").arg(tg).arg(tgd), dg_data[dgd].toObject()["v"]);
-
-                                        // If data contains the optional x (time) parameter, copy that too
-                                        if (tg_data[tgd].toObject().contains("x") && dg_data[dgd].toObject().contains("x")) {
-                                            if (dg_data[dgd].toObject()["x"].isDouble()) {
-                                                modifyJsonValue(tmpl, QString("g[%1].d[%2].x").arg(tg).arg(tgd), dg_data[dgd].toObject()["x"]);
-                                            }
-                                        }
-
-                                        ///@todo need to copy this back into tmpl itself
-
-                                        // Need to flag that a change was made in order for document to be outputted
-                                        change_made = true;
-                                    }
-                                }
-                            }
-                        }
-                    }
-                    if (change_made) {
-                        document = *tmpl;
-                    }
-                }
-                // Give Mutex
-            }
-
-            // Do not use a template, just package the object generated by the script
-            else {
-                document = QJsonDocument::fromVariant(result.toVariant());
-            }
-
-            if (!document.isEmpty()) {
-                //LOG_INFO() << document.toJson().simplified();
-                error.error = QJsonParseError::NoError;
-            }
-
-            Generator::getInstance()->closeJsonTemplate();
-        }
+        m_batch.append({data, timestamp, sourceId});
+        if (m_batch.count() >= MAX_BATCH_SIZE)
+            flushBatch();
 
-        engine->deleteLater();
+        return;
     }
 
-    // No parse error, update UI & reset error counter
-    if (error.error == QJsonParseError::NoError) {
-        Generator::getInstance()->loadJFI(JFI_CreateNew(frame, time, document));
-    }
+    // Send frame to the parser threads (round-robin)
+    const auto frame = m_frameCount;
+    const auto sequence = m_sequence++;
+    auto worker = m_workers.at(static_cast<int>(sequence % m_workers.count()));
+    QMetaObject::invokeMethod(
+        worker, [=] { worker->process(data, frame, timestamp, sourceId, sequence); },
+        Qt::QueuedConnection);
 }
 
+//----------------------------------------------------------------------------------------
+// JSON worker object (executed in the thread pool of the generator)
+//----------------------------------------------------------------------------------------
 
-
-// Local functions outside a class
-
-void modifyJsonValue(QJsonValue& destValue, const QString& path, const QJsonValue& newValue)
+/**
+ * Constructor function
+ */
+JSONWorker::JSONWorker()
+    : m_engine(nullptr)
+    , m_opMode(Generator::kAutomatic)
 {
-    const int indexOfDot = path.indexOf('.');
-    const QString dotPropertyName = path.left(indexOfDot);
-    const QString dotSubPath = indexOfDot > 0 ? path.mid(indexOfDot + 1) : QString();
+}
 
-    const int indexOfSquareBracketOpen = path.indexOf('[');
-    const int indexOfSquareBracketClose = path.indexOf(']');
+/**
+ * Changes the operation mode & the JSON map data (or JS script) used to parse frames,
+ * the JS script is compiled here, so that it is only compiled once per worker.
+ */
+void JSONWorker::configure(const Generator::OperationMode mode, const QString &jsonMapData)
+{
+    m_opMode = mode;
+    m_jsonMapData = jsonMapData;
+    m_batch = QJSValue();
+    m_function = QJSValue();
+    m_parser.clear();
 
-    const int arrayIndex = path.mid(indexOfSquareBracketOpen + 1, indexOfSquareBracketClose - indexOfSquareBracketOpen - 1).toInt();
+    // Create the JS engine in the thread of the worker
+    if (!m_engine)
+        m_engine = new QJSEngine(this);
 
-    const QString squareBracketPropertyName = path.left(indexOfSquareBracketOpen);
-    const QString squareBracketSubPath = indexOfSquareBracketClose > 0 ? (path.mid(indexOfSquareBracketClose + 1)[0] == '.' ? path.mid(indexOfSquareBracketClose + 2) : path.mid(indexOfSquareBracketClose + 1)) : QString();
+    // Compile the JSON map into a decoding plan
+    m_plan.clear();
+    if (m_opMode == Generator::kManual && !m_jsonMapData.isEmpty())
+        m_plan.load(m_jsonMapData);
 
-    // determine what is first in path. dot or bracket
-    bool useDot = true;
-    if (indexOfDot >= 0) // there is a dot in path
+    // Compile the JS script into the parser function
+    if (m_opMode == Generator::kScript && !m_jsonMapData.isEmpty())
     {
-        if (indexOfSquareBracketOpen >= 0) // there is squarebracket in path
+        auto function = m_engine->evaluate(m_jsonMapData);
+        if (!function.isError() && function.isCallable())
         {
-            if (indexOfDot > indexOfSquareBracketOpen)
-                useDot = false;
-            else
-                useDot = true;
+            m_function = function;
+            m_batch = function.property("batch");
         }
-        else
-            useDot = true;
     }
-    else
+}
+
+/**
+ * Reads the frame & inserts its values on the JSON map, and/or extracts the JSON frame
+ * directly from the serial data.
+ *
+ * The frame is converted to a schema & a value array here, so that this work is done
+ * in parallel. Partial frames generated by JS scripts are sent as a JSON document,
+ * since they need to be overlaid on the data template first.
+ *
+ * The result is always reported to the generator (with an empty frame if it could not
+ * be parsed), so that the generator does not wait for it when releasing frames in
+ * order.
+ */
+void JSONWorker::process(const QByteArray &data, const quint64 frame, const qint64 time,
+                         const int sourceId, const quint64 sequence)
+{
+    FrameSchemaPtr schema;
+    QVector<FrameValue> values;
+
+    // Partial frame generated by a JS script, report it to the generator
+    if (m_opMode == Generator::kScript)
     {
-        if (indexOfSquareBracketOpen >= 0)
-            useDot = false;
-        else
-            useDot = true; // acutally, id doesn't matter, both dot and square bracket don't exist
+        auto info = JFI_CreateNew(frame, time, schema, values, sourceId);
+        emit jsonReady(info, sequence, readScriptFrame(data));
+        return;
     }
 
-    QString usedPropertyName = useDot ? dotPropertyName : squareBracketPropertyName;
-    QString usedSubPath = useDot ? dotSubPath : squareBracketSubPath;
+    // Serial device sends JSON (auto mode), values are read directly by the parser
+    if (m_opMode == Generator::kAutomatic)
+        schema = m_parser.read(data, &values);
 
-    QJsonValue subValue;
-    if (destValue.isArray())
-        subValue = destValue.toArray()[usedPropertyName.toInt()];
-    else if (destValue.isObject())
-        subValue = destValue.toObject()[usedPropertyName];
+    // We need to use a map file, decode the values with the map's plan
     else
-        qDebug() << "oh, what should i do now with the following value?! " << destValue;
+        schema = readManualFrame(data, &values);
 
-    if(usedSubPath.isEmpty())
-    {
-        subValue = newValue;
-    }
-    else
-    {
-        if (subValue.isArray())
-        {
-            QJsonArray arr = subValue.toArray();
-            QJsonValue arrEntry = arr[arrayIndex];
-            modifyJsonValue(arrEntry,usedSubPath,newValue);
-            arr[arrayIndex] = arrEntry;
-            subValue = arr;
-        }
-        else if (subValue.isObject())
-            modifyJsonValue(subValue,usedSubPath,newValue);
-        else
-            subValue = newValue;
-    }
+    // Report result to the generator
+    emit jsonReady(JFI_CreateNew(frame, time, schema, values, sourceId), sequence,
+                   QJsonDocument());
+}
 
-    if (destValue.isArray())
-    {
-        QJsonArray arr = destValue.toArray();
-        if (subValue.isNull())
-            arr.removeAt(arrayIndex);
-        else
-            arr[arrayIndex] = subValue;
-        destValue = arr;
-    }
-    else if (destValue.isObject())
+/**
+ * Decodes the comma-separated values of the given frame @a data into the given
+ * @a values & evaluates the JS code of each dataset value (if any). The JSON map is
+ * compiled into a decoding plan when the worker is configured, check the
+ * @c DecodingPlan class.
+ *
+ * @returns the frame schema, or a null pointer if the frame is not valid
+ */
+FrameSchemaPtr JSONWorker::readManualFrame(const QByteArray &data,
+                                           QVector<FrameValue> *values)
+{
+    FrameSchemaPtr schema;
+    if (!m_plan.decode(data, m_engine, &schema, values))
     {
-        QJsonObject obj = destValue.toObject();
-        if (subValue.isNull())
-            obj.remove(usedPropertyName);
-        else
-            obj[usedPropertyName] = subValue;
-        destValue = obj;
+        values->clear();
+        return FrameSchemaPtr();
     }
-    else
-        destValue = newValue;
+
+    return schema;
 }
 
-void modifyJsonValue(QJsonDocument* doc, const QString& path, const QJsonValue& newValue)
+/**
+ * Calls the compiled JS script with the given frame @a data. The returned object may
+ * only contain a part of the dataset, it is overlaid on the data template by the
+ * generator.
+ */
+QJsonDocument JSONWorker::readScriptFrame(const QByteArray &data)
 {
-    QJsonValue val;
-    if (doc->isArray())
-        val = doc->array();
-    else
-        val = doc->object();
+    // Exit on empty/invalid JS script
+    if (!m_function.isCallable())
+        return QJsonDocument();
+
+    // Call the script on real data
+    QJSValueList args;
+    args << QString::fromUtf8(data);
+    auto result = m_function.call(args);
+    if (result.isError())
+        return QJsonDocument();
+
+    // Package the object generated by the script
+    return QJsonDocument::fromVariant(result.toVariant());
+}
+
+/**
+ * Parses a batch of script @a frames, the first frame of the batch has the frame
+ * number @a firstFrame & the sequence number @a firstSequence.
+ *
+ * If the script defines a @c batch function (as a property of the parser function),
+ * it is called once with an array of lines and must return an array with the
+ * (partial) frame generated for each line. Otherwise, or if the result is not valid,
+ * the parser function is called for each line.
+ */
+void JSONWorker::processBatch(const QVector<IO::RawFrame> &frames,
+                              const quint64 firstFrame, const quint64 firstSequence)
+{
+    const auto count = frames.count();
 
-    modifyJsonValue(val,path,newValue);
+    // Call the batch function with all lines at once
+    QVariantList results;
+    if (m_batch.isCallable() && m_engine)
+    {
+        auto lines = m_engine->newArray(static_cast<uint>(count));
+        for (int i = 0; i < count; ++i)
+            lines.setProperty(static_cast<quint32>(i), QString::fromUtf8(frames[i].data));
 
-    if (val.isArray())
-        *doc = QJsonDocument(val.toArray());
-    else
-        *doc = QJsonDocument(val.toObject());
+        auto result = m_batch.callWithInstance(m_function, QJSValueList { lines });
+        if (!result.isError() && result.isArray())
+            results = result.toVariant().toList();
+    }
+
+    // Report each frame to the generator, call the parser for each line if needed
+    const auto batched = results.count() == count;
+    for (int i = 0; i < count; ++i)
+    {
+        const auto &frame = frames[i];
+        const auto document = batched ? QJsonDocument::fromVariant(results[i])
+                                      : readScriptFrame(frame.data);
+
+        auto info = JFI_CreateNew(firstFrame + static_cast<quint64>(i), frame.timestamp,
+                                  FrameSchemaPtr(), QVector<FrameValue>(),
+                                  frame.sourceId);
+        emit jsonReady(info, firstSequence + static_cast<quint64>(i), document);
+    }
 }
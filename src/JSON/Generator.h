@@ -23,8 +23,10 @@
 #ifndef JSON_GENERATOR_H
 #define JSON_GENERATOR_H
 
+#include <QMap>
 #include <QPair>
 #include <QFile>
+#include <QFileSystemWatcher>
 #include <QTimer>
 #include <QObject>
 #include <QThread>
@@ -36,39 +38,20 @@
 #include <QJsonValue>
 #include <QJsonObject>
 #include <QJsonDocument>
-#include <QMutex>
+#include <QVector>
 
 #include "Frame.h"
+#include "DecodingPlan.h"
 #include "FrameInfo.h"
+#include "FrameParser.h"
+#include "FrameSchema.h"
+#include "FrameTemplate.h"
+
+#include <IO/Reader.h>
 
 namespace JSON
 {
-class JSONWorker : public QObject
-{
-    Q_OBJECT
-
-signals:
-    void finished();
-    void jsonReady(const JFI_Object &info);
-
-public:
-    JSONWorker(const QByteArray &data, const quint64 frame, const QDateTime &time);
-
-//private:
-    // New, used to modify the Json Template when new data arrives
-    //void modifyJsonValue(QJsonValue& destValue, const QString& path, const QJsonValue& newValue);
-    //void modifyJsonValue(QJsonDocument* doc, const QString& path, const QJsonValue& newValue);
-
-public slots:
-    void process();
-
-private:
-    QDateTime m_time;
-    QByteArray m_data;
-    quint64 m_frame;
-    QJSEngine *m_engine;
-};
-
+class JSONWorker;
 class Generator : public QObject
 {
     // clang-format off
@@ -102,11 +85,6 @@ public:
 public:
     static Generator *getInstance();
 
-    // New
-    QJsonDocument* openJsonTemplate();
-    void closeJsonTemplate();
-    void saveJsonTemplate(QJsonDocument &tmpl);
-
     QString jsonMapData() const;
     QString jsonMapFilename() const;
     QString jsonMapFilepath() const;
@@ -119,6 +97,13 @@ public slots:
 
 private:
     Generator();
+    ~Generator();
+    void compileScript();
+    void configureWorkers();
+    void applyTemplate(const QJsonDocument &document, JFI_Object *frame);
+    JFI_Object mergeSources(const JFI_Object &info);
+    void shareSchema(JFI_Object *info);
+    void updateGeneration(JFI_Object *info);
 
 public slots:
     void readSettings();
@@ -128,20 +113,88 @@ public slots:
 
 private slots:
     void reset();
-    void readData(const QByteArray &data);
+    void flushBatch();
+    void onJsonMapChanged(const QString &path);
+    void onJsonReady(const JFI_Object &info, const quint64 sequence,
+                     const QJsonDocument &partial);
+    void readData(const QByteArray &data, const qint64 timestamp, const int sourceId);
 
 private:
     QFile m_jsonMap;
     quint64 m_frameCount;
     QSettings m_settings;
     QString m_jsonMapData;
-    //QJsonObject m_jsonTemplate;
-    QJsonDocument m_jsonTemplate;
-    QMutex m_jsonTemplateMutex;
+    FrameTemplate m_jsonTemplate;
     OperationMode m_opMode;
+    QMap<int, JFI_Object> m_sourceFrames;
+    QMap<int, FrameSchemaPtr> m_schemas;
+    FrameSchemaPtr m_schema;
+    quint64 m_generation;
+    FrameSchemaPtr m_mergedSchema;
+    QVector<FrameSchemaPtr> m_mergedSources;
+
+    QJSEngine *m_scriptEngine;
+    bool m_scriptBatch;
+    QFileSystemWatcher m_jsonMapWatcher;
+
+    quint64 m_sequence;
+    quint64 m_nextSequence;
+    QVector<QThread *> m_threads;
+    QVector<JSONWorker *> m_workers;
+    QMap<quint64, QPair<JFI_Object, QJsonDocument>> m_pendingFrames;
+
+    QTimer m_batchTimer;
+    quint64 m_batchFrame;
+    QVector<IO::RawFrame> m_batch;
+};
 
-    QThread m_workerThread;
-    JSONWorker *m_jsonWorker;
+/**
+ * Parses received frames in a thread of the pool owned by the @c Generator class.
+ *
+ * Each worker keeps a copy of the operation mode & JSON map data, and its own JS
+ * engine (with the parser script compiled once), so that several frames can be
+ * processed in parallel. Results are tagged with the sequence number assigned by the
+ * generator, which releases them in the same order in which frames were received.
+ *
+ * Frames are converted to a schema & a value array (check the @c FrameSchema class)
+ * in the worker thread, except for the partial frames generated by JS scripts, which
+ * are first overlaid on the data template by the generator.
+ *
+ * If the parser function of a JS script has a callable @c batch property, frames are
+ * sent to the workers in batches & the batch function is called once with an array of
+ * lines, it must return an array with one (partial) frame per line. Otherwise, each
+ * frame is sent to a worker as soon as it is received.
+ */
+class JSONWorker : public QObject
+{
+    Q_OBJECT
+
+signals:
+    void jsonReady(const JFI_Object &info, const quint64 sequence,
+                   const QJsonDocument &partial);
+
+public:
+    JSONWorker();
+
+public slots:
+    void configure(const Generator::OperationMode mode, const QString &jsonMapData);
+    void process(const QByteArray &data, const quint64 frame, const qint64 time,
+                 const int sourceId, const quint64 sequence);
+    void processBatch(const QVector<IO::RawFrame> &frames, const quint64 firstFrame,
+                      const quint64 firstSequence);
+
+private:
+    FrameSchemaPtr readManualFrame(const QByteArray &data, QVector<FrameValue> *values);
+    QJsonDocument readScriptFrame(const QByteArray &data);
+
+private:
+    QJSEngine *m_engine;
+    QJSValue m_batch;
+    QJSValue m_function;
+    DecodingPlan m_plan;
+    FrameParser m_parser;
+    QString m_jsonMapData;
+    Generator::OperationMode m_opMode;
 };
 }
 
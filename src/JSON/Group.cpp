@@ -32,17 +32,6 @@ Group::Group(QObject *parent)
 {
 }
 
-/**
- * Destructor function
- */
-Group::~Group()
-{
-    for (int i = 0; i < datasetCount(); ++i)
-        m_datasets.at(i)->deleteLater();
-
-    m_datasets.clear();
-}
-
 /**
  * @return The title/description of this group
  */
@@ -87,46 +76,32 @@ Dataset *Group::getDataset(const int index)
 }
 
 /**
- * Reads the group information and all its asociated datasets from the given
- * JSON @c object.
+ * Reads the group at the given @a index of the frame @a schema & updates its datasets
+ * with the given frame @a values. Existing dataset objects are reused.
  *
- * @return @c true on success, @c false on failure
+ * @return @c true on success, @c false on failure (all dataset values are empty)
  */
-bool Group::read(const QJsonObject &object)
+bool Group::read(const FrameSchema &schema, const int index,
+                 const QVector<FrameValue> &values)
 {
-    if (!object.isEmpty())
-    {
-        auto array = object.value("d").toArray();
-        auto title = object.value("t").toVariant().toString();
-        auto widget = object.value("w").toVariant().toString();
-
-        title = title.replace("\n", "");
-        title = title.replace("\r", "");
-        widget = widget.replace("\n", "");
-        widget = widget.replace("\r", "");
-
-        if (!title.isEmpty() && !array.isEmpty())
-        {
-            m_title = title;
-            m_widget = widget;
-            m_datasets.clear();
+    const auto &info = schema.groups().at(index);
+    m_title = info.title;
+    m_widget = info.widget;
+    m_datasets.clear();
 
-            for (auto i = 0; i < array.count(); ++i)
-            {
-                auto object = array.at(i).toObject();
-                if (!object.isEmpty())
-                {
-                    Dataset *dataset = new Dataset(this);
-                    if (dataset->read(object))
-                        m_datasets.append(dataset);
-                    else
-                        dataset->deleteLater();
-                }
-            }
+    // Dataset objects are taken from the pool (they are children of the group, so they
+    // are deleted together with the group)
+    const auto last = info.firstDataset + info.datasetCount;
+    for (auto i = info.firstDataset; i < last; ++i)
+    {
+        if (m_datasets.count() == m_pool.count())
+            m_pool.append(new Dataset(this));
 
-            return datasetCount() > 0;
-        }
+        auto dataset = m_pool.at(m_datasets.count());
+        if (dataset->read(schema.datasets().at(i), values.at(i)))
+            m_datasets.append(dataset);
     }
 
-    return false;
+    emit infoChanged();
+    return datasetCount() > 0;
 }
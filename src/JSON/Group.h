@@ -26,8 +26,6 @@
 #include <QVector>
 #include <QObject>
 #include <QVariant>
-#include <QJsonArray>
-#include <QJsonObject>
 
 #include "Dataset.h"
 
@@ -39,33 +37,37 @@ class Group : public QObject
     Q_OBJECT
     Q_PROPERTY(QString title
                READ title
-               CONSTANT)
+               NOTIFY infoChanged)
     Q_PROPERTY(QString widget
                READ widget
-               CONSTANT)
+               NOTIFY infoChanged)
     Q_PROPERTY(int datasetCount
                READ datasetCount
-               CONSTANT)
+               NOTIFY infoChanged)
     Q_PROPERTY(QVector<Dataset*> datasets
                READ datasets
-               CONSTANT)
+               NOTIFY infoChanged)
     // clang-format on
 
+signals:
+    void infoChanged();
+
 public:
     Group(QObject *parent = nullptr);
-    ~Group();
 
     QString title() const;
     QString widget() const;
     int datasetCount() const;
     QVector<Dataset *> datasets() const;
-    bool read(const QJsonObject &object);
+    bool read(const FrameSchema &schema, const int index,
+              const QVector<FrameValue> &values);
 
     Q_INVOKABLE Dataset *getDataset(const int index);
 
 private:
     QString m_title;
     QString m_widget;
+    QVector<Dataset *> m_pool;
     QVector<Dataset *> m_datasets;
 };
 }
@@ -41,6 +41,7 @@ static DataProvider *INSTANCE = nullptr;
  * Constructor of the class
  */
 DataProvider::DataProvider()
+    : m_displayedFrame(0)
 {
     m_latestJsonFrame = JFI_Empty();
     auto cp = CSV::Player::getInstance();
@@ -127,12 +128,31 @@ void DataProvider::resetData()
 }
 
 /**
- * Interprets the most recent JSON frame & signals the UI to regenerate itself.
+ * Interprets the most recent JSON frame & signals the UI to update itself.
+ *
+ * If the structure generation of the frame did not change, the values of the existing
+ * groups & datasets are updated in place. Otherwise, the groups & datasets are created
+ * again & the UI is signaled to regenerate its models.
  */
 void DataProvider::updateData()
 {
-    if (m_latestFrame.read(m_latestJsonFrame.jsonDocument.object()))
+    // Nothing new since the last update
+    const auto &info = m_latestJsonFrame;
+    if (info.frameNumber == m_displayedFrame
+        && info.generation == m_latestFrame.generation())
+        return;
+
+    // Same structure, update values
+    m_displayedFrame = info.frameNumber;
+    if (m_latestFrame.update(info))
         emit updated();
+
+    // Structure changed, re-create groups & datasets
+    else if (m_latestFrame.read(info))
+    {
+        emit structureChanged();
+        emit updated();
+    }
 }
 
 /**
@@ -44,6 +44,7 @@ class DataProvider : public QObject
 signals:
     void updated();
     void dataReset();
+    void structureChanged();
 
 public:
     static DataProvider *getInstance();
@@ -67,6 +68,7 @@ private slots:
 private:
     JSON::Frame m_latestFrame;
     JFI_Object m_latestJsonFrame;
+    quint64 m_displayedFrame;
 };
 }
 
@@ -24,6 +24,7 @@
 #include "GraphProvider.h"
 
 #include <QtMath>
+#include <QChart>
 #include <QXYSeries>
 #include <QMetaType>
 
@@ -42,6 +43,48 @@ using namespace UI;
  */
 static GraphProvider *INSTANCE = nullptr;
 
+/*
+ * Fraction of the distance to the extremes of the displayed samples that the range of
+ * a graph shrinks on each update (decaying envelope mode)
+ */
+static const double ENVELOPE_DECAY = 0.02;
+
+/*
+ * Returns a point object with the recommended (min, max) values of the vertical axis
+ * of a graph that displays values between @a minV & @a maxV
+ */
+static QPointF GRAPH_RANGE(const double minV, const double maxV)
+{
+    // Get central value
+    double medianValue = qMax<double>(1, (maxV + minV)) / 2;
+    if (maxV == minV)
+        medianValue = maxV;
+
+    // Center graph verticaly
+    double mostDiff = qMax<double>(qAbs<double>(minV), qAbs<double>(maxV));
+    double min = medianValue * (1 - 0.5) - qAbs<double>(medianValue - mostDiff);
+    double max = medianValue * (1 + 0.5) + qAbs<double>(medianValue - mostDiff);
+    if (minV < 0)
+        min = max * -1;
+
+    // Fix issues when min & max are equal
+    if (min == max)
+    {
+        max = qAbs<double>(max);
+        min = max * -1;
+    }
+
+    // Fix issues on min = max = (0,0)
+    if (min == 0 && max == 0)
+    {
+        max = 1;
+        min = -1;
+    }
+
+    // Return point as (min, max)
+    return QPointF(min, max);
+}
+
 //
 // Magic
 //
@@ -58,8 +101,11 @@ GraphProvider::GraphProvider()
     // clang-format off
 
     // Start with 10 points
+    m_generation = 0;
     m_prevFramePos = 0;
     m_displayedPoints = 10;
+    m_decayingEnvelope = false;
+    m_latestFrame = JFI_Empty();
 
     // Register data types
     qRegisterMetaType<QAbstractAxis *>();
@@ -110,6 +156,16 @@ int GraphProvider::displayedPoints() const
     return m_displayedPoints;
 }
 
+/**
+ * Returns @c true if the range of the graphs grows immediately to fit new extreme
+ * values, but shrinks gradually when extreme values leave the displayed window.
+ * Otherwise, the range of the graphs always fits the displayed values.
+ */
+bool GraphProvider::decayingEnvelope() const
+{
+    return m_decayingEnvelope;
+}
+
 /**
  * Returns a list with the @a Dataset objects that act as data sources for the
  * graph views
@@ -124,16 +180,19 @@ QVector<JSON::Dataset *> GraphProvider::datasets() const
  */
 double GraphProvider::getValue(const int index) const
 {
-    if (index < graphCount() && index >= 0)
-        return getDataset(index)->value().toDouble();
+    if (index < m_graphs.count() && index >= 0)
+        return m_latestFrame.values.at(m_graphs.at(index)).number;
 
     return 0;
 }
 
+/**
+ * Returns the latest time value of the dataset at the given @a index
+ */
 double GraphProvider::getTick(const int index) const
 {
-    if (index < graphCount() && index >= 0)
-        return getDataset(index)->tick().toDouble();
+    if (index < m_graphs.count() && index >= 0)
+        return m_latestFrame.values.at(m_graphs.at(index)).tick;
 
     return 0;
 }
@@ -144,42 +203,37 @@ double GraphProvider::getTick(const int index) const
  */
 QPointF GraphProvider::graphRange(const int index) const
 {
-    // Update maximum value (if required)
-    double maxV = maximumValue(index);
-    double minV = minimumValue(index);
-
-    // Get central value
-    double medianValue = qMax<double>(1, (maxV + minV)) / 2;
-    if (maxV == minV)
-        medianValue = maxV;
+    return GRAPH_RANGE(minimumValue(index), maximumValue(index));
+}
 
-    // Center graph verticaly
-    double mostDiff = qMax<double>(qAbs<double>(minV), qAbs<double>(maxV));
-    double min = medianValue * (1 - 0.5) - qAbs<double>(medianValue - mostDiff);
-    double max = medianValue * (1 + 0.5) + qAbs<double>(medianValue - mostDiff);
-    if (minV < 0)
-        min = max * -1;
+/**
+ * Returns a point object with the (min, max) values of the X axis of the graph at the
+ * given @a index. The X coordinate of each point is the absolute index of its sample,
+ * so the axis follows the displayed points.
+ */
+QPointF GraphProvider::timeRange(const int index) const
+{
+    double min = 0;
+    if (index < m_points.count() && index >= 0)
+        min = m_decimators.at(index).total() - m_points.at(index).size();
 
-    // Fix issues when min & max are equal
-    if (min == max)
-    {
-        max = qAbs<double>(max);
-        min = max * -1;
-    }
+    return QPointF(min, min + displayedPoints());
+}
 
-    // Fix issues on min = max = (0,0)
-    if (min == 0 && max == 0)
-    {
-        max = 1;
-        min = -1;
-    }
+/**
+ * Returns the number of samples stored in the history of the graph at the given
+ * @a index since the device was connected, check the @c updateHistory() function.
+ */
+double GraphProvider::historyLength(const int index) const
+{
+    if (index < m_history.count() && index >= 0)
+        return m_history.at(index).total();
 
-    // Return point as (min, max)
-    return QPointF(min, max);
+    return 0;
 }
 
 /**
- * Returns the smallest value registered with the dataset at the given @a index
+ * Returns the smallest value displayed by the graph at the given @a index
  */
 double GraphProvider::minimumValue(const int index) const
 {
@@ -195,7 +249,7 @@ double GraphProvider::minimumValue(const int index) const
 }
 
 /**
- * Returns the greatest value registered with the dataset at the given @a index
+ * Returns the greatest value displayed by the graph at the given @a index
  */
 double GraphProvider::maximumValue(const int index) const
 {
@@ -223,28 +277,53 @@ JSON::Dataset *GraphProvider::getDataset(const int index) const
 
 /**
  * Changes the maximum number of points that should be displayed in the graph
- * views.
+ * views, the most recent points of each graph are kept.
  */
 void GraphProvider::setDisplayedPoints(const int points)
 {
     if (points != displayedPoints() && points > 0)
     {
         m_displayedPoints = points;
-        m_points.clear();
+        for (int i = 0; i < m_points.count(); ++i)
+        {
+            m_points[i].setCapacity(points);
+            m_decimators[i].reset(m_points.at(i), m_decimators.at(i).columns());
+            m_extrema[i].reset(m_points.at(i));
+            updateRange(i);
+        }
 
         emit displayedPointsUpdated();
         emit dataUpdated();
     }
 }
 
+/**
+ * Enables or disables the decaying envelope mode for the range of the graphs
+ */
+void GraphProvider::setDecayingEnvelope(const bool enabled)
+{
+    if (m_decayingEnvelope != enabled)
+    {
+        m_decayingEnvelope = enabled;
+        emit decayingEnvelopeChanged();
+    }
+}
+
 /**
  * Deletes all stored information
  */
 void GraphProvider::resetData()
 {
     m_points.clear();
+    m_decimators.clear();
+    m_updaters.clear();
+    m_extrema.clear();
+    m_history.clear();
     m_currentTime.clear();
     m_datasets.clear();
+    m_graphs.clear();
+    m_generation = 0;
+    m_latestFrame = JFI_Empty();
     m_maximumValues.clear();
     m_minimumValues.clear();
     emit dataUpdated();
@@ -261,75 +340,64 @@ void GraphProvider::drawGraphs()
     // Graph each frame
     for (int f = 0; f < m_jsonList.count(); ++f)
     {
-        // Clear dataset & latest values list
-        m_datasets.clear();
-
         // Get frame, abort if frame is invalid
-        JSON::Frame frame;
-        if (!frame.read(m_jsonList.at(f).jsonDocument.object()))
+        const auto &frame = m_jsonList.at(f);
+        if (frame.values.count() != frame.schema->datasets().count())
             continue;
 
-        // Create list with datasets that need to be graphed
-        for (int i = 0; i < frame.groupCount(); ++i)
-        {
-            auto group = frame.groups().at(i);
-            for (int j = 0; j < group->datasetCount(); ++j)
-            {
-                auto dataset = group->datasets().at(j);
-                if (dataset->graph()) {
-                    m_datasets.append(dataset);
-                    //LOG_INFO() << dataset->jsonData();
-                    //LOG_INFO() << "t:" << dataset->title() << "v:" << dataset->value() << "x" << dataset->tick();
-                }
-            }
-        }
-
-        // Create list with dataset values (converted to double)
-        for (int i = 0; i < graphCount(); ++i) {
+        // Update list with datasets that need to be graphed
+        m_latestFrame = frame;
+        if (frame.generation != m_generation)
+            updateDatasets();
 
+        // Append the values of each graphed dataset
+        for (int i = 0; i < m_graphs.count(); ++i)
+        {
             // Register dataset for this graph
-            if (m_points.count() < (i + 1)) {
-                auto vector = new QVector<double>;
-                m_points.append(vector);
+            if (m_points.count() < (i + 1))
+            {
+                m_points.append(SampleBuffer(displayedPoints()));
+                m_decimators.append(SampleDecimator());
+                m_updaters.append(SeriesUpdater());
+                m_extrema.append(SlidingExtrema());
+                m_extrema.last().reset(m_points.last());
+                m_history.append(HistoryPyramid());
             }
-            if (m_currentTime.count() < (i+1)) {
+            if (m_currentTime.count() < (i + 1))
                 m_currentTime.append(0.0);
-            }
+
+            // Datasets without value in this frame are not graphed
+            const auto &value = frame.values.at(m_graphs.at(i));
+            if (value.text.isEmpty())
+                continue;
 
             // Only handle the new point data if it is ahead in time from the last data.
             // The exception is if Time < 0, which indicates explicit timing is not used.
-            double tick = getTick(i);
-            //LOG_INFO() << "tick:" << tick << "currentTime:" << m_currentTime.at(i) ;
-
-            if ((m_currentTime.at(i) < tick) || (tick == 0.0) ) {
+            const double tick = value.tick;
+            if ((m_currentTime.at(i) < tick) || (tick == 0.0))
+            {
                 m_currentTime.replace(i, tick);
 
-                // Register min. values list
-                if (m_minimumValues.count() < (i + 1))
-                    m_minimumValues.append(getValue(i));
-
-                // Register max. values list
-                if (m_maximumValues.count() < (i + 1))
-                    m_maximumValues.append(getValue(i));
-
-                // Update minimum value
-                if (minimumValue(i) > getValue(i))
-                    m_minimumValues.replace(i, getValue(i));
-
-                // Update minimum value
-                if (maximumValue(i) < getValue(i))
-                    m_maximumValues.replace(i, getValue(i));
-
-                // Remove older items
-                if (m_points.at(i)->count() >= displayedPoints())
-                    m_points.at(i)->remove(0, m_points.at(i)->count() - displayedPoints());
-
-                // Add values
-                m_points.at(i)->append(getValue(i));
+                // Add values (the oldest point is overwritten if the buffer is full)
+                m_points[i].append(value.number, tick);
+                m_decimators[i].append(value.number);
+                m_extrema[i].append(value.number);
+                m_history[i].append(value.number);
             }
         }
     }
 
+    // Update the min/max values of each graph
+    for (int i = 0; i < m_extrema.count(); ++i)
+        updateRange(i);
+
+    // Update the values of the dataset objects used by the graph views
+    if (!m_jsonList.isEmpty())
+    {
+        for (int i = 0; i < m_datasets.count(); ++i)
+            m_datasets.at(i)->update(m_latestFrame.values.at(m_graphs.at(i)));
+    }
+
     // Clear frame list
     m_jsonList.clear();
 
@@ -339,7 +407,8 @@ void GraphProvider::drawGraphs()
 
 /**
  * Removes graph points that are ahead of current data frame that is being
- * displayed/processed by the CSV Player.
+ * displayed/processed by the CSV Player. The history of each graph is discarded,
+ * since it contains the frames that come after the current frame.
  */
 void GraphProvider::csvPlayerFixes()
 {
@@ -348,13 +417,13 @@ void GraphProvider::csvPlayerFixes()
     if (m_prevFramePos > currentFrame)
     {
         auto diff = m_prevFramePos - currentFrame;
-        for (int i = 0; i < graphCount(); ++i)
+        for (int i = 0; i < m_points.count(); ++i)
         {
-            for (int j = 0; j < diff; ++j)
-            {
-                if (!m_points.at(i)->isEmpty())
-                    m_points.at(i)->removeLast();
-            }
+            m_points[i].removeLast(diff);
+            m_decimators[i].reset(m_points.at(i), m_decimators.at(i).columns());
+            m_extrema[i].reset(m_points.at(i));
+            m_history[i].clear();
+            updateRange(i);
         }
 
         emit dataUpdated();
@@ -368,6 +437,11 @@ void GraphProvider::csvPlayerFixes()
  * Updates the graph for the given data @a series prorivder, the @a index is
  * used to know which dataset object should be used to pull the latest data
  * point.
+ *
+ * The number of plotted points is bounded by the width (in pixels) of the plot area
+ * of the chart, check the @c SampleDecimator class for more information. Only the
+ * points that changed since the last call are updated (check the @c SeriesUpdater
+ * class), and series that did not receive new data are not modified.
  */
 void GraphProvider::updateGraph(QAbstractSeries *series, const int index)
 {
@@ -379,13 +453,142 @@ void GraphProvider::updateGraph(QAbstractSeries *series, const int index)
     {
         if (m_points.count() > index && index >= 0)
         {
-            QVector<QPointF> data;
-            for (int i = 0; i < m_points.at(index)->count(); ++i)
-                data.append(QPointF(i, m_points.at(index)->at(i)));
+            // Re-calculate decimation buckets if the width of the chart changed
+            int columns = 0;
+            if (series->chart())
+                columns = qCeil(series->chart()->plotArea().width());
+            if (columns != m_decimators.at(index).columns())
+                m_decimators[index].reset(m_points.at(index), columns);
+
+            // Plot the new decimated points
+            m_updaters[index].update(static_cast<QXYSeries *>(series),
+                                     m_points.at(index), m_decimators.at(index));
+        }
+    }
+}
 
-            static_cast<QXYSeries *>(series)->replace(data);
+/**
+ * Plots the samples of the graph at the given @a index whose absolute index (since the
+ * device was connected) is in the [@a from, @a to) range, used to zoom & scroll
+ * through the whole history of the session. The samples are read from the level of
+ * the @c HistoryPyramid that matches the width (in pixels) of the chart.
+ *
+ * Returns a point object with the recommended (min, max) values of the vertical axis
+ * for the plotted samples.
+ */
+QPointF GraphProvider::updateHistory(QAbstractSeries *series, const int index,
+                                     const double from, const double to)
+{
+    // Validation
+    assert(series != Q_NULLPTR);
+
+    // Plot the history & get the min/max plotted values
+    double minV = -1;
+    double maxV = 1;
+    if (m_history.count() > index && index >= 0)
+    {
+        int columns = 0;
+        if (series->chart())
+            columns = qCeil(series->chart()->plotArea().width());
+
+        QVector<QPointF> data;
+        const auto begin = static_cast<quint64>(qMax<double>(0, from));
+        const auto end = static_cast<quint64>(qMax<double>(0, to));
+        m_history.at(index).points(begin, end, columns, &data);
+        static_cast<QXYSeries *>(series)->replace(data);
+
+        // The live points must be plotted again by updateGraph()
+        m_updaters[index] = SeriesUpdater();
+
+        if (!data.isEmpty())
+        {
+            minV = data.first().y();
+            maxV = minV;
+            for (const auto &point : data)
+            {
+                minV = qMin(minV, point.y());
+                maxV = qMax(maxV, point.y());
+            }
         }
     }
+
+    return GRAPH_RANGE(minV, maxV);
+}
+
+/**
+ * Re-creates the list of graphed datasets (and updates the dataset objects used by the
+ * graph views) from the schema of the latest frame. This is only done when the
+ * structure generation of the frame changes.
+ *
+ * Dataset objects are kept in a pool & reused, new objects are only created when the
+ * frame has more graphed datasets than any previous frame.
+ */
+void GraphProvider::updateDatasets()
+{
+    m_datasets.clear();
+    m_graphs.clear();
+
+    m_generation = m_latestFrame.generation;
+    const auto &datasets = m_latestFrame.schema->datasets();
+    for (int i = 0; i < datasets.count(); ++i)
+    {
+        if (datasets.at(i).graph)
+        {
+            if (m_datasets.count() == m_pool.count())
+                m_pool.append(new JSON::Dataset(this));
+
+            auto dataset = m_pool.at(m_datasets.count());
+            dataset->read(datasets.at(i), m_latestFrame.values.at(i));
+            m_datasets.append(dataset);
+            m_graphs.append(i);
+        }
+    }
+}
+
+/**
+ * Updates the min/max values of the graph at the given @a index from the extremes of
+ * the displayed samples (check the @c SlidingExtrema class).
+ *
+ * In decaying envelope mode, the range still grows immediately to fit new extreme
+ * values, but it only shrinks by a fraction of the difference on each update, which
+ * avoids sudden jumps of the vertical axis when a spike leaves the displayed window.
+ */
+void GraphProvider::updateRange(const int index)
+{
+    // Register min/max values for this graph
+    while (m_minimumValues.count() <= index)
+    {
+        m_minimumValues.append(INT_MAX);
+        m_maximumValues.append(INT_MIN);
+    }
+
+    // No displayed samples
+    const auto &extrema = m_extrema.at(index);
+    if (extrema.isEmpty())
+    {
+        m_minimumValues.replace(index, INT_MAX);
+        m_maximumValues.replace(index, INT_MIN);
+        return;
+    }
+
+    // Get extremes of the displayed samples
+    auto min = extrema.minimum();
+    auto max = extrema.maximum();
+
+    // Shrink the previous range gradually
+    if (m_decayingEnvelope && m_minimumValues.at(index) != INT_MAX)
+    {
+        const auto prevMin = m_minimumValues.at(index);
+        const auto prevMax = m_maximumValues.at(index);
+        if (prevMin < min)
+            min = prevMin + (min - prevMin) * ENVELOPE_DECAY;
+        if (prevMax > max)
+            max = prevMax - (prevMax - max) * ENVELOPE_DECAY;
+    }
+
+    // Update min/max values
+    m_minimumValues.replace(index, min);
+    m_maximumValues.replace(index, max);
 }
 
 /**
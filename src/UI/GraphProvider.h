@@ -33,6 +33,12 @@
 #include <JSON/Dataset.h>
 #include <JSON/FrameInfo.h>
 
+#include "HistoryPyramid.h"
+#include "SampleBuffer.h"
+#include "SampleDecimator.h"
+#include "SeriesUpdater.h"
+#include "SlidingExtrema.h"
+
 QT_CHARTS_USE_NAMESPACE
 
 namespace UI
@@ -51,32 +57,45 @@ class GraphProvider : public QObject
                READ displayedPoints
                WRITE setDisplayedPoints
                NOTIFY displayedPointsUpdated)
+    Q_PROPERTY(bool decayingEnvelope
+               READ decayingEnvelope
+               WRITE setDecayingEnvelope
+               NOTIFY decayingEnvelopeChanged)
     // clang-format on
 
 signals:
     void dataUpdated();
     void displayedPointsUpdated();
+    void decayingEnvelopeChanged();
 
 public:
     static GraphProvider *getInstance();
 
     int graphCount() const;
     int displayedPoints() const;
+    bool decayingEnvelope() const;
     QVector<JSON::Dataset *> datasets() const;
 
     Q_INVOKABLE double getTick(const int index) const;
     Q_INVOKABLE double getValue(const int index) const;
     Q_INVOKABLE QPointF graphRange(const int index) const;
+    Q_INVOKABLE QPointF timeRange(const int index) const;
+    Q_INVOKABLE double historyLength(const int index) const;
     Q_INVOKABLE double minimumValue(const int index) const;
     Q_INVOKABLE double maximumValue(const int index) const;
     Q_INVOKABLE JSON::Dataset *getDataset(const int index) const;
 
 public slots:
     void setDisplayedPoints(const int points);
+    void setDecayingEnvelope(const bool enabled);
     void updateGraph(QAbstractSeries *series, const int index);
+    QPointF updateHistory(QAbstractSeries *series, const int index, const double from,
+                          const double to);
 
 private:
     GraphProvider();
+    void updateDatasets();
+    void updateRange(const int index);
 
 private slots:
     void resetData();
@@ -87,12 +106,22 @@ private slots:
 private:
     int m_prevFramePos;
     int m_displayedPoints;
+    bool m_decayingEnvelope;
     QVector<double> m_maximumValues;
     QVector<double> m_minimumValues;
-    QVector<QVector<double> *> m_points;
+    QVector<SampleBuffer> m_points;
+    QVector<SampleDecimator> m_decimators;
+    QVector<SeriesUpdater> m_updaters;
+    QVector<SlidingExtrema> m_extrema;
+    QVector<HistoryPyramid> m_history;
     QVector<double> m_currentTime;
     QVector<JSON::Dataset *> m_datasets;
     QList<JFI_Object> m_jsonList;
+
+    quint64 m_generation;
+    QVector<int> m_graphs;
+    JFI_Object m_latestFrame;
+    QVector<JSON::Dataset *> m_pool;
 };
 }
 
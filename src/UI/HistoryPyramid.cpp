@@ -0,0 +1,249 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "HistoryPyramid.h"
+
+using namespace UI;
+
+/*
+ * Number of entries of the previous level that are summarized by each entry of a level
+ */
+static const int HISTORY_FACTOR = 4;
+
+/*
+ * Number of entries stored by each level (including the level of raw samples)
+ */
+static const int HISTORY_CAPACITY = 4096;
+
+/*
+ * Maximum number of summary levels, with the values above, the coarsest level covers
+ * the last ~6.9e10 samples & the pyramid uses less than 1.2 MB per dataset
+ */
+static const int HISTORY_LEVELS = 12;
+
+/**
+ * Constructor function
+ */
+HistoryPyramid::HistoryPyramid()
+    : m_head(0)
+    , m_count(0)
+    , m_total(0)
+{
+}
+
+/**
+ * Returns the number of samples registered since the pyramid was cleared, which is
+ * also the absolute index of the next sample.
+ */
+quint64 HistoryPyramid::total() const
+{
+    return m_total;
+}
+
+/**
+ * Removes all the samples & summaries, releasing the memory used by the pyramid
+ */
+void HistoryPyramid::clear()
+{
+    m_head = 0;
+    m_count = 0;
+    m_total = 0;
+    m_samples.clear();
+    m_levels.clear();
+}
+
+/**
+ * Appends a sample with the given @a value & updates the summaries of each level
+ */
+void HistoryPyramid::append(const double value)
+{
+    // Store the raw sample, overwriting the oldest sample if needed
+    if (m_samples.isEmpty())
+        m_samples.resize(HISTORY_CAPACITY);
+
+    auto pos = m_head + m_count;
+    if (pos >= HISTORY_CAPACITY)
+        pos -= HISTORY_CAPACITY;
+
+    m_samples[pos] = value;
+    if (m_count < HISTORY_CAPACITY)
+        ++m_count;
+    else
+        m_head = (m_head + 1 == HISTORY_CAPACITY) ? 0 : m_head + 1;
+
+    ++m_total;
+
+    // Add the sample to the summary of each level, until a summary is not completed
+    Summary summary = {value, value, value};
+    for (int i = 0; i < HISTORY_LEVELS; ++i)
+    {
+        // Register level
+        if (m_levels.count() == i)
+        {
+            const Level level = {0, 0, 0, QVector<Summary>(), 0, 0, summary};
+            m_levels.append(level);
+        }
+
+        // Add the entry of the previous level to the pending summary
+        auto &level = m_levels[i];
+        if (level.pending == 0)
+            level.summary = summary;
+        else
+        {
+            level.summary.min = qMin(level.summary.min, summary.min);
+            level.summary.max = qMax(level.summary.max, summary.max);
+        }
+
+        level.sum += summary.mean;
+        if (++level.pending < HISTORY_FACTOR)
+            break;
+
+        // Summary completed, store it & add it to the next level
+        summary = level.summary;
+        summary.mean = level.sum / HISTORY_FACTOR;
+        level.sum = 0;
+        level.pending = 0;
+
+        if (level.entries.isEmpty())
+            level.entries.resize(HISTORY_CAPACITY);
+
+        pos = level.head + level.count;
+        if (pos >= HISTORY_CAPACITY)
+            pos -= HISTORY_CAPACITY;
+
+        level.entries[pos] = summary;
+        if (level.count < HISTORY_CAPACITY)
+            ++level.count;
+        else
+            level.head = (level.head + 1 == HISTORY_CAPACITY) ? 0 : level.head + 1;
+
+        ++level.total;
+    }
+}
+
+/**
+ * Generates the @a points used to plot the samples with absolute index in the
+ * [@a from, @a to) range on a graph with the given number of pixel @a columns.
+ *
+ * The coarsest level whose entries do not span more than one pixel column is used,
+ * unless the beginning of the range is only stored in a coarser level. Summaries are
+ * plotted as a vertical segment from the minimum to the maximum value, at the center
+ * of the period covered by the summary. The most recent part of the range, which is
+ * not summarized yet, is read from the finer levels.
+ */
+void HistoryPyramid::points(const quint64 from, const quint64 to, const int columns,
+                            QVector<QPointF> *points) const
+{
+    Q_ASSERT(points);
+    points->clear();
+
+    // Nothing to plot
+    const auto end = qMin(to, m_total);
+    if (from >= end)
+        return;
+
+    // Find the level that matches the resolution of the graph
+    int level = 0;
+    const auto perColumn = (end - from) / static_cast<quint64>(qMax(1, columns));
+    while (level < m_levels.count() && span(level) < perColumn)
+        ++level;
+
+    // Use a coarser level if the beginning of the range is not stored anymore
+    while (level < m_levels.count() && start(level) > from)
+        ++level;
+
+    // Add the points of each level, from the coarsest to the finest level
+    auto pos = from;
+    for (int l = level; l >= 0 && pos < end; --l)
+    {
+        // Add raw samples
+        if (l == 0)
+        {
+            const auto oldest = start(0);
+            for (auto i = qMax(pos, oldest); i < end; ++i)
+            {
+                auto index = m_head + static_cast<int>(i - oldest);
+                if (index >= HISTORY_CAPACITY)
+                    index -= HISTORY_CAPACITY;
+
+                points->append(QPointF(static_cast<qreal>(i), m_samples.at(index)));
+            }
+
+            break;
+        }
+
+        // Get the range of stored entries that cover the samples
+        const auto &data = m_levels.at(l - 1);
+        const auto size = span(l);
+        const auto oldest = data.total - static_cast<quint64>(data.count);
+        const auto first = qMax(pos / size, oldest);
+        const auto last = qMin((end + size - 1) / size, data.total);
+
+        // Add summaries
+        for (auto e = first; e < last; ++e)
+        {
+            auto index = data.head + static_cast<int>(e - oldest);
+            if (index >= HISTORY_CAPACITY)
+                index -= HISTORY_CAPACITY;
+
+            const auto &summary = data.entries.at(index);
+            const auto x = static_cast<qreal>(e * size + size / 2);
+            if (summary.min == summary.max)
+                points->append(QPointF(x, summary.mean));
+            else
+            {
+                points->append(QPointF(x, summary.min));
+                points->append(QPointF(x, summary.max));
+            }
+        }
+
+        // Continue with the samples that are not summarized by this level
+        pos = qMax(pos, last * size);
+    }
+}
+
+/**
+ * Returns the absolute index of the oldest sample covered by the given @a level
+ */
+quint64 HistoryPyramid::start(const int level) const
+{
+    if (level == 0)
+        return m_total - static_cast<quint64>(m_count);
+
+    if (level > m_levels.count())
+        return m_total;
+
+    const auto &data = m_levels.at(level - 1);
+    return (data.total - static_cast<quint64>(data.count)) * span(level);
+}
+
+/**
+ * Returns the number of samples covered by each entry of the given @a level
+ */
+quint64 HistoryPyramid::span(const int level) const
+{
+    quint64 size = 1;
+    for (int i = 0; i < level; ++i)
+        size *= HISTORY_FACTOR;
+
+    return size;
+}
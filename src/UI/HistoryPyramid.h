@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef UI_HISTORY_PYRAMID_H
+#define UI_HISTORY_PYRAMID_H
+
+#include <QPointF>
+#include <QVector>
+
+namespace UI
+{
+/**
+ * Stores the complete history of a graphed dataset with a bounded amount of memory,
+ * using a multi-resolution (level of detail) pyramid.
+ *
+ * The most recent samples are stored as-is (level 0). Each of the following levels
+ * stores summaries (minimum, maximum & mean values) of a fixed number of entries of
+ * the previous level, so each level covers a period of time several times longer than
+ * the previous one. Every level is a circular buffer with a fixed number of entries,
+ * and levels are only allocated once enough samples have been received, so the memory
+ * used by the pyramid is bounded regardless of the duration of the session.
+ *
+ * Summaries are calculated incrementally as samples are appended (O(1) amortized).
+ * When plotting a range of the history, only the level that matches the number of
+ * samples per pixel column is read (see @c points()).
+ */
+class HistoryPyramid
+{
+public:
+    struct Summary
+    {
+        double min;
+        double max;
+        double mean;
+    };
+
+    HistoryPyramid();
+
+    quint64 total() const;
+
+    void clear();
+    void append(const double value);
+    void points(const quint64 from, const quint64 to, const int columns,
+                QVector<QPointF> *points) const;
+
+private:
+    struct Level
+    {
+        int head;
+        int count;
+        quint64 total;
+        QVector<Summary> entries;
+
+        int pending;
+        double sum;
+        Summary summary;
+    };
+
+    quint64 start(const int level) const;
+    quint64 span(const int level) const;
+
+private:
+    int m_head;
+    int m_count;
+    quint64 m_total;
+    QVector<double> m_samples;
+    QVector<Level> m_levels;
+};
+}
+
+#endif
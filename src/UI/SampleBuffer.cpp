@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "SampleBuffer.h"
+
+using namespace UI;
+
+/**
+ * Creates a buffer that can store up to @a capacity samples
+ */
+SampleBuffer::SampleBuffer(const int capacity)
+    : m_head(0)
+    , m_size(0)
+    , m_capacity(0)
+{
+    setCapacity(capacity);
+}
+
+/**
+ * Returns the number of samples stored in the buffer
+ */
+int SampleBuffer::size() const
+{
+    return m_size;
+}
+
+/**
+ * Returns the maximum number of samples that can be stored in the buffer
+ */
+int SampleBuffer::capacity() const
+{
+    return m_capacity;
+}
+
+/**
+ * Returns @c true if the buffer does not contain any sample
+ */
+bool SampleBuffer::isEmpty() const
+{
+    return m_size == 0;
+}
+
+/**
+ * Returns the value of the sample at the given @a index, where @c 0 is the oldest
+ * stored sample & @c size() - 1 is the most recent one.
+ */
+double SampleBuffer::value(const int index) const
+{
+    return m_values.at(position(index));
+}
+
+/**
+ * Returns the tick of the sample at the given @a index, where @c 0 is the oldest
+ * stored sample & @c size() - 1 is the most recent one.
+ */
+double SampleBuffer::tick(const int index) const
+{
+    return m_ticks.at(position(index));
+}
+
+/**
+ * Returns the span that contains the oldest stored samples, which goes from the oldest
+ * sample to the end of the underlying arrays (or to the most recent sample).
+ *
+ * @note The span is invalidated when the buffer is modified.
+ */
+SampleBuffer::Span SampleBuffer::first() const
+{
+    const auto count = qMin(m_size, m_capacity - m_head);
+    return {m_values.constData() + m_head, m_ticks.constData() + m_head, count};
+}
+
+/**
+ * Returns the span that contains the samples that wrapped around the end of the
+ * underlying arrays, it follows the span returned by @c first() and may be empty.
+ *
+ * @note The span is invalidated when the buffer is modified.
+ */
+SampleBuffer::Span SampleBuffer::second() const
+{
+    const auto count = m_size - qMin(m_size, m_capacity - m_head);
+    return {m_values.constData(), m_ticks.constData(), count};
+}
+
+/**
+ * Removes all the samples from the buffer, the memory is kept allocated
+ */
+void SampleBuffer::clear()
+{
+    m_head = 0;
+    m_size = 0;
+}
+
+/**
+ * Removes the @a count most recent samples from the buffer
+ */
+void SampleBuffer::removeLast(const int count)
+{
+    m_size -= qBound(0, count, m_size);
+    if (m_size == 0)
+        m_head = 0;
+}
+
+/**
+ * Changes the maximum number of samples that can be stored in the buffer. The most
+ * recent samples are kept (as long as they fit in the new buffer).
+ */
+void SampleBuffer::setCapacity(const int capacity)
+{
+    // Nothing to do
+    const auto newCapacity = qMax(1, capacity);
+    if (newCapacity == m_capacity)
+        return;
+
+    // Copy the most recent samples to the new arrays, starting at position 0
+    const auto keep = qMin(m_size, newCapacity);
+    QVector<double> ticks(newCapacity);
+    QVector<double> values(newCapacity);
+    for (int i = 0; i < keep; ++i)
+    {
+        const auto pos = position(m_size - keep + i);
+        ticks[i] = m_ticks.at(pos);
+        values[i] = m_values.at(pos);
+    }
+
+    // Replace the buffer contents
+    m_head = 0;
+    m_size = keep;
+    m_ticks = ticks;
+    m_values = values;
+    m_capacity = newCapacity;
+}
+
+/**
+ * Appends a sample with the given @a value & @a tick, overwriting the oldest sample
+ * if the buffer is full.
+ */
+void SampleBuffer::append(const double value, const double tick)
+{
+    int pos;
+    if (m_size < m_capacity)
+    {
+        pos = position(m_size);
+        ++m_size;
+    }
+
+    else
+    {
+        pos = m_head;
+        m_head = (m_head + 1 == m_capacity) ? 0 : m_head + 1;
+    }
+
+    m_ticks[pos] = tick;
+    m_values[pos] = value;
+}
+
+/**
+ * Returns the position in the underlying arrays of the sample at the given logical
+ * @a index (where @c 0 is the oldest sample).
+ */
+int SampleBuffer::position(const int index) const
+{
+    const auto pos = m_head + index;
+    return (pos >= m_capacity) ? pos - m_capacity : pos;
+}
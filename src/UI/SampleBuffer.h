@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef UI_SAMPLE_BUFFER_H
+#define UI_SAMPLE_BUFFER_H
+
+#include <QVector>
+
+namespace UI
+{
+/**
+ * Fixed-capacity circular buffer that stores the most recent samples (value & tick)
+ * of a graphed dataset.
+ *
+ * Values & ticks are stored in two separate arrays (struct-of-arrays), appending a
+ * sample is O(1) and never moves the buffer contents. Once the buffer is full, each
+ * new sample overwrites the oldest one.
+ *
+ * The stored samples can be read as (at most) two contiguous spans, ordered from the
+ * oldest to the most recent sample (see @c first() & @c second()).
+ */
+class SampleBuffer
+{
+public:
+    struct Span
+    {
+        const double *values;
+        const double *ticks;
+        int count;
+    };
+
+    explicit SampleBuffer(const int capacity = 10);
+
+    int size() const;
+    int capacity() const;
+    bool isEmpty() const;
+
+    double value(const int index) const;
+    double tick(const int index) const;
+
+    Span first() const;
+    Span second() const;
+
+    void clear();
+    void removeLast(const int count);
+    void setCapacity(const int capacity);
+    void append(const double value, const double tick);
+
+private:
+    int position(const int index) const;
+
+private:
+    int m_head;
+    int m_size;
+    int m_capacity;
+    QVector<double> m_ticks;
+    QVector<double> m_values;
+};
+}
+
+#endif
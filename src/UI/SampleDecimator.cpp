@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "SampleDecimator.h"
+
+#include <QtMath>
+
+using namespace UI;
+
+/**
+ * Constructor function, samples are not decimated until the number of pixel columns
+ * of the graph is known (see @c reset()).
+ */
+SampleDecimator::SampleDecimator()
+    : m_columns(0)
+    , m_bucketSize(1)
+    , m_total(0)
+    , m_revision(0)
+    , m_current({0, 0, 0, 0, 0, 0, 0, 0})
+{
+}
+
+/**
+ * Returns the number of pixel columns used to calculate the bucket size
+ */
+int SampleDecimator::columns() const
+{
+    return m_columns;
+}
+
+/**
+ * Returns the number of samples that are summarized by each bucket, a value of @c 1
+ * means that samples are not decimated.
+ */
+int SampleDecimator::bucketSize() const
+{
+    return m_bucketSize;
+}
+
+/**
+ * Returns the number of samples registered since the last reset, which is also the
+ * absolute index of the next sample.
+ */
+quint64 SampleDecimator::total() const
+{
+    return m_total;
+}
+
+/**
+ * Returns a number that changes every time that the buckets are re-calculated, which
+ * invalidates the points generated before.
+ */
+quint64 SampleDecimator::revision() const
+{
+    return m_revision;
+}
+
+/**
+ * Registers a new sample with the given @a value, this function must be called after
+ * appending the sample to the buffer.
+ */
+void SampleDecimator::append(const double value)
+{
+    const auto index = m_total++;
+    if (m_bucketSize <= 1)
+        return;
+
+    add(&m_current, index, value);
+    if (m_current.count == m_bucketSize)
+    {
+        const auto bucket = index / static_cast<quint64>(m_bucketSize);
+        m_buckets[static_cast<int>(bucket % static_cast<quint64>(m_buckets.count()))]
+            = m_current;
+        m_current.count = 0;
+    }
+}
+
+/**
+ * Re-calculates all the buckets from the samples of the given @a buffer, the bucket
+ * size is chosen so that the capacity of the buffer fits in the given number of pixel
+ * @a columns.
+ *
+ * This function must be called when the capacity of the buffer changes, or when
+ * samples are removed from the buffer.
+ */
+void SampleDecimator::reset(const SampleBuffer &buffer, const int columns)
+{
+    // Calculate bucket size
+    m_columns = qMax(0, columns);
+    m_bucketSize = 1;
+    if (m_columns > 0)
+        m_bucketSize = qMax(1, qCeil(buffer.capacity() / static_cast<double>(m_columns)));
+
+    // Allocate buckets (including partially evicted & incomplete buckets)
+    m_buckets.clear();
+    if (m_bucketSize > 1)
+        m_buckets.resize(qCeil(buffer.capacity() / static_cast<double>(m_bucketSize)) + 2);
+
+    // Register the samples stored in the buffer
+    m_total = 0;
+    m_revision++;
+    m_current.count = 0;
+    for (int i = 0; i < buffer.size(); ++i)
+        append(buffer.value(i));
+}
+
+/**
+ * Appends the @a points used to plot the samples of the given @a buffer whose absolute
+ * index is in the [@a from, @a to) range. The X coordinate of each point is the
+ * absolute index of the sample.
+ *
+ * Buckets that are fully contained in the range are read from the stored buckets,
+ * buckets that are only partially contained are calculated from the buffer.
+ */
+void SampleDecimator::points(const SampleBuffer &buffer, const quint64 from,
+                             const quint64 to, QVector<QPointF> *points) const
+{
+    Q_ASSERT(points);
+
+    // Limit the range to the samples stored in the buffer
+    const auto oldest = m_total - static_cast<quint64>(buffer.size());
+    const auto begin = qMax(from, oldest);
+    const auto end = qMin(to, m_total);
+    if (begin >= end)
+        return;
+
+    // No decimation, plot all samples
+    if (m_bucketSize <= 1)
+    {
+        const auto first = buffer.first();
+        const auto second = buffer.second();
+        for (auto i = begin; i < end; ++i)
+        {
+            const auto k = static_cast<int>(i - oldest);
+            const auto value = k < first.count ? first.values[k]
+                                               : second.values[k - first.count];
+            points->append(QPointF(static_cast<qreal>(i), value));
+        }
+
+        return;
+    }
+
+    // Generate the points of each bucket in the range
+    const auto size = static_cast<quint64>(m_bucketSize);
+    const auto current = (m_total / size) * size;
+    for (auto b = begin / size; b * size < end; ++b)
+    {
+        const auto lo = qMax(begin, b * size);
+        const auto hi = qMin(end, (b + 1) * size);
+
+        // Completed bucket
+        if (lo == b * size && hi == lo + size && hi <= current)
+        {
+            const auto count = static_cast<quint64>(m_buckets.count());
+            write(m_buckets.at(static_cast<int>(b % count)), points);
+        }
+
+        // Incomplete bucket
+        else if (lo == current && hi == m_total)
+            write(m_current, points);
+
+        // Part of a bucket, calculate it from the buffer
+        else
+        {
+            Bucket bucket = {0, 0, 0, 0, 0, 0, 0, 0};
+            for (auto i = lo; i < hi; ++i)
+                add(&bucket, i, buffer.value(static_cast<int>(i - oldest)));
+
+            write(bucket, points);
+        }
+    }
+}
+
+/**
+ * Adds the sample with the given absolute @a index & @a value to the @a bucket
+ */
+void SampleDecimator::add(Bucket *bucket, const quint64 index, const double value)
+{
+    if (bucket->count == 0)
+    {
+        bucket->first = value;
+        bucket->min = value;
+        bucket->max = value;
+        bucket->firstIndex = index;
+        bucket->minIndex = index;
+        bucket->maxIndex = index;
+    }
+
+    else if (value < bucket->min)
+    {
+        bucket->min = value;
+        bucket->minIndex = index;
+    }
+
+    else if (value > bucket->max)
+    {
+        bucket->max = value;
+        bucket->maxIndex = index;
+    }
+
+    bucket->last = value;
+    bucket->count++;
+}
+
+/**
+ * Appends the first, minimum, maximum & last samples of the @a bucket to the
+ * @a points (in chronological order, without duplicates). The X coordinate of each
+ * point is the absolute index of the sample.
+ */
+void SampleDecimator::write(const Bucket &bucket, QVector<QPointF> *points)
+{
+    // Empty bucket
+    if (bucket.count == 0)
+        return;
+
+    // Sort the min/max samples by index
+    const auto lastIndex = bucket.firstIndex + static_cast<quint64>(bucket.count) - 1;
+    auto aIndex = bucket.minIndex;
+    auto bIndex = bucket.maxIndex;
+    auto aValue = bucket.min;
+    auto bValue = bucket.max;
+    if (aIndex > bIndex)
+    {
+        qSwap(aIndex, bIndex);
+        qSwap(aValue, bValue);
+    }
+
+    // Add the points (skipping samples that were already added)
+    const auto x = [](const quint64 index) { return static_cast<qreal>(index); };
+    points->append(QPointF(x(bucket.firstIndex), bucket.first));
+    if (aIndex != bucket.firstIndex)
+        points->append(QPointF(x(aIndex), aValue));
+    if (bIndex != aIndex && bIndex != bucket.firstIndex)
+        points->append(QPointF(x(bIndex), bValue));
+    if (lastIndex != bIndex && lastIndex != aIndex && lastIndex != bucket.firstIndex)
+        points->append(QPointF(x(lastIndex), bucket.last));
+}
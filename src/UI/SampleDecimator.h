@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef UI_SAMPLE_DECIMATOR_H
+#define UI_SAMPLE_DECIMATOR_H
+
+#include <QPointF>
+#include <QVector>
+
+#include "SampleBuffer.h"
+
+namespace UI
+{
+/**
+ * Reduces the samples of a @c SampleBuffer to a set of points that is bounded by the
+ * pixel width of the graph, using the M4 algorithm.
+ *
+ * Samples are grouped in buckets of consecutive samples, so that each pixel column of
+ * the graph contains (at least) one bucket. Only the first, last, minimum & maximum
+ * samples of each bucket are plotted, which draws exactly the same pixels as plotting
+ * all the samples of the bucket.
+ *
+ * Buckets are aligned to the absolute index of each sample, and are computed
+ * incrementally as new samples are appended (see @c append()). Completed buckets are
+ * stored in a small circular array, so generating the plotted points is O(width),
+ * regardless of the number of samples stored in the buffer. Points can also be
+ * generated for a part of the buffer, which allows updating a series incrementally
+ * (see the @c SeriesUpdater class).
+ */
+class SampleDecimator
+{
+public:
+    SampleDecimator();
+
+    int columns() const;
+    int bucketSize() const;
+    quint64 total() const;
+    quint64 revision() const;
+
+    void append(const double value);
+    void reset(const SampleBuffer &buffer, const int columns);
+    void points(const SampleBuffer &buffer, const quint64 from, const quint64 to,
+                QVector<QPointF> *points) const;
+
+private:
+    struct Bucket
+    {
+        int count;
+        double first;
+        double last;
+        double min;
+        double max;
+        quint64 firstIndex;
+        quint64 minIndex;
+        quint64 maxIndex;
+    };
+
+    static void add(Bucket *bucket, const quint64 index, const double value);
+    static void write(const Bucket &bucket, QVector<QPointF> *points);
+
+private:
+    int m_columns;
+    int m_bucketSize;
+    quint64 m_total;
+    quint64 m_revision;
+    Bucket m_current;
+    QVector<Bucket> m_buckets;
+};
+}
+
+#endif
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "SeriesUpdater.h"
+
+using namespace UI;
+
+/**
+ * Constructor function
+ */
+SeriesUpdater::SeriesUpdater()
+    : m_series(nullptr)
+    , m_total(0)
+    , m_revision(0)
+    , m_bodyStart(0)
+    , m_tailStart(0)
+    , m_headCount(0)
+    , m_tailCount(0)
+{
+}
+
+/**
+ * Updates the points of the given @a series with the samples of the @a buffer,
+ * decimated by the given @a decimator. Nothing is done if no samples were added since
+ * the last update.
+ */
+void SeriesUpdater::update(QXYSeries *series, const SampleBuffer &buffer,
+                           const SampleDecimator &decimator)
+{
+    Q_ASSERT(series);
+
+    // Get the absolute indexes of the head, body & tail of the plotted points
+    const auto size = static_cast<quint64>(decimator.bucketSize());
+    const auto total = decimator.total();
+    const auto oldest = total - static_cast<quint64>(buffer.size());
+    const auto tailStart = (total / size) * size;
+    const auto bodyStart = qMin(((oldest + size - 1) / size) * size, tailStart);
+
+    // Check if the plotted points are still valid
+    const auto valid = series == m_series && decimator.revision() == m_revision
+                       && series->count() == m_points.count() && total >= m_total;
+
+    // No new samples, nothing to do
+    if (valid && total == m_total)
+        return;
+
+    // Generate the new head
+    m_buffer.clear();
+    decimator.points(buffer, oldest, bodyStart, &m_buffer);
+    const auto headCount = m_buffer.count();
+
+    // Copy the body points that were not evicted from the previous update
+    auto from = bodyStart;
+    if (valid && bodyStart >= m_bodyStart && bodyStart <= m_tailStart)
+    {
+        const auto end = m_points.count() - m_tailCount;
+
+        int first = m_headCount;
+        while (first < end && m_points.at(first).x() < bodyStart)
+            ++first;
+
+        for (int i = first; i < end; ++i)
+            m_buffer.append(m_points.at(i));
+
+        from = m_tailStart;
+    }
+
+    // Generate the new body points & the new tail
+    decimator.points(buffer, from, tailStart, &m_buffer);
+    const auto tailIndex = m_buffer.count();
+    decimator.points(buffer, tailStart, total, &m_buffer);
+
+    // Plot the new points
+    m_points.swap(m_buffer);
+    series->replace(m_points);
+
+    // Save the state of the plotted points
+    m_total = total;
+    m_series = series;
+    m_bodyStart = bodyStart;
+    m_tailStart = tailStart;
+    m_headCount = headCount;
+    m_tailCount = m_points.count() - tailIndex;
+    m_revision = decimator.revision();
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef UI_SERIES_UPDATER_H
+#define UI_SERIES_UPDATER_H
+
+#include <QVector>
+#include <QPointF>
+#include <QXYSeries>
+
+#include "SampleBuffer.h"
+#include "SampleDecimator.h"
+
+QT_CHARTS_USE_NAMESPACE
+
+namespace UI
+{
+/**
+ * Keeps the points of a @c QXYSeries in sync with the samples of a @c SampleBuffer,
+ * only re-generating the points that changed since the last update.
+ *
+ * The X coordinate of each point is the absolute index of its sample, so the points
+ * that are already plotted never move. The plotted points are divided in three parts:
+ *
+ * - Head: points of the oldest bucket, which may be partially evicted.
+ * - Body: points of completed buckets, which never change.
+ * - Tail: points of the incomplete bucket that receives new samples.
+ *
+ * On each update, the head & tail are re-generated, evicted body points are dropped &
+ * the buckets completed since the last update are added, the rest of the body is
+ * copied from the previous update. The body is only re-generated completely if the
+ * decimation buckets were re-calculated, or if all the plotted points were evicted.
+ *
+ * The result is sent to the series with a single call to @c QXYSeries::replace(),
+ * since Qt Charts re-calculates the geometry of the whole series for every change
+ * signal. The work done per update is bounded by the width of the graph. Two point
+ * buffers are swapped on each update, so that the buffer that is filled is never
+ * shared with the series & no memory is allocated once the buffers have grown.
+ */
+class SeriesUpdater
+{
+public:
+    SeriesUpdater();
+
+    void update(QXYSeries *series, const SampleBuffer &buffer,
+                const SampleDecimator &decimator);
+
+private:
+    QXYSeries *m_series;
+    quint64 m_total;
+    quint64 m_revision;
+    quint64 m_bodyStart;
+    quint64 m_tailStart;
+    int m_headCount;
+    int m_tailCount;
+    QVector<QPointF> m_points;
+    QVector<QPointF> m_buffer;
+};
+}
+
+#endif
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include "SlidingExtrema.h"
+
+using namespace UI;
+
+/**
+ * Constructor function
+ */
+SlidingExtrema::SlidingExtrema()
+    : m_capacity(0)
+    , m_total(0)
+    , m_minimum({0, 0, QVector<Entry>()})
+    , m_maximum({0, 0, QVector<Entry>()})
+{
+}
+
+/**
+ * Returns @c true if the window does not contain any sample
+ */
+bool SlidingExtrema::isEmpty() const
+{
+    return m_minimum.count == 0;
+}
+
+/**
+ * Returns the smallest value of the samples in the window
+ */
+double SlidingExtrema::minimum() const
+{
+    Q_ASSERT(!isEmpty());
+    return m_minimum.entries.at(m_minimum.head).value;
+}
+
+/**
+ * Returns the greatest value of the samples in the window
+ */
+double SlidingExtrema::maximum() const
+{
+    Q_ASSERT(!isEmpty());
+    return m_maximum.entries.at(m_maximum.head).value;
+}
+
+/**
+ * Registers a new sample with the given @a value, the oldest sample of the window is
+ * evicted if the window is full. This function must be called after appending the
+ * sample to the buffer.
+ */
+void SlidingExtrema::append(const double value)
+{
+    if (m_capacity <= 0)
+        return;
+
+    const Entry entry = {m_total++, value};
+    push(&m_minimum, entry, true);
+    push(&m_maximum, entry, false);
+}
+
+/**
+ * Re-calculates the extremes from the samples of the given @a buffer, this function
+ * must be called when the capacity of the buffer changes, or when samples are removed
+ * from the buffer.
+ */
+void SlidingExtrema::reset(const SampleBuffer &buffer)
+{
+    m_total = 0;
+    m_capacity = buffer.capacity();
+    clear(&m_minimum);
+    clear(&m_maximum);
+
+    for (int i = 0; i < buffer.size(); ++i)
+        append(buffer.value(i));
+}
+
+/**
+ * Removes all the entries of the @a queue & allocates space for the capacity of the
+ * window.
+ */
+void SlidingExtrema::clear(Queue *queue)
+{
+    queue->head = 0;
+    queue->count = 0;
+    queue->entries.resize(m_capacity);
+}
+
+/**
+ * Appends the given @a entry to the @a queue, removing the entries that are out of the
+ * window & the entries that can no longer be the minimum (or maximum) value of the
+ * window.
+ */
+void SlidingExtrema::push(Queue *queue, const Entry &entry, const bool minimum)
+{
+    // Remove the oldest entry if it was evicted from the window
+    const auto capacity = static_cast<quint64>(m_capacity);
+    if (queue->count > 0 && queue->entries.at(queue->head).index + capacity <= entry.index)
+    {
+        queue->head = (queue->head + 1 == m_capacity) ? 0 : queue->head + 1;
+        queue->count--;
+    }
+
+    // Remove the newest entries that are dominated by the new entry
+    while (queue->count > 0)
+    {
+        auto back = queue->head + queue->count - 1;
+        if (back >= m_capacity)
+            back -= m_capacity;
+
+        const auto value = queue->entries.at(back).value;
+        if (minimum ? value < entry.value : value > entry.value)
+            break;
+
+        queue->count--;
+    }
+
+    // Append the new entry
+    auto pos = queue->head + queue->count;
+    if (pos >= m_capacity)
+        pos -= m_capacity;
+
+    queue->entries[pos] = entry;
+    queue->count++;
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2020-2021 Alex Spataru <https://github.com/alex-spataru>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef UI_SLIDING_EXTREMA_H
+#define UI_SLIDING_EXTREMA_H
+
+#include <QVector>
+
+#include "SampleBuffer.h"
+
+namespace UI
+{
+/**
+ * Keeps track of the minimum & maximum values of the samples stored in a
+ * @c SampleBuffer (the sliding window of displayed samples).
+ *
+ * Two monotonic queues are used: the minimum queue stores the samples that may become
+ * the minimum value of the window once older samples are evicted (in increasing order
+ * of value), and the maximum queue does the same for the maximum value. Appending a
+ * sample is O(1) amortized, and querying the extremes is O(1).
+ */
+class SlidingExtrema
+{
+public:
+    SlidingExtrema();
+
+    bool isEmpty() const;
+    double minimum() const;
+    double maximum() const;
+
+    void append(const double value);
+    void reset(const SampleBuffer &buffer);
+
+private:
+    struct Entry
+    {
+        quint64 index;
+        double value;
+    };
+
+    struct Queue
+    {
+        int head;
+        int count;
+        QVector<Entry> entries;
+    };
+
+    void clear(Queue *queue);
+    void push(Queue *queue, const Entry &entry, const bool minimum);
+
+private:
+    int m_capacity;
+    quint64 m_total;
+    Queue m_minimum;
+    Queue m_maximum;
+};
+}
+
+#endif
@@ -49,7 +49,8 @@ WidgetProvider::WidgetProvider()
     auto cp = CSV::Player::getInstance();
     auto io = IO::Manager::getInstance();
     auto dp = DataProvider::getInstance();
-    connect(dp, SIGNAL(updated()), this, SLOT(updateModels()));
+    connect(dp, SIGNAL(updated()), this, SIGNAL(dataChanged()));
+    connect(dp, SIGNAL(structureChanged()), this, SLOT(updateModels()));
     connect(cp, SIGNAL(openChanged()), this, SLOT(resetData()));
     connect(io, SIGNAL(connectedChanged()), this, SLOT(resetData()));
     LOG_TRACE() << "Class initialized";
@@ -205,7 +206,7 @@ double WidgetProvider::gyroYaw(const int index)
         {
             auto widget = dataset->widget();
             if (widget.toLower() == "yaw")
-                return dataset->value().toDouble();
+                return dataset->number();
         }
     }
 
@@ -225,7 +226,7 @@ double WidgetProvider::gyroRoll(const int index)
         {
             auto widget = dataset->widget();
             if (widget.toLower() == "roll")
-                return dataset->value().toDouble();
+                return dataset->number();
         }
     }
 
@@ -245,7 +246,7 @@ double WidgetProvider::gyroPitch(const int index)
         {
             auto widget = dataset->widget();
             if (widget.toLower() == "pitch")
-                return dataset->value().toDouble();
+                return dataset->number();
         }
     }
 
@@ -266,7 +267,7 @@ double WidgetProvider::accelerometerX(const int index)
         {
             auto widget = dataset->widget();
             if (widget.toLower() == "x")
-                return dataset->value().toDouble();
+                return dataset->number();
         }
     }
 
@@ -287,7 +288,7 @@ double WidgetProvider::accelerometerY(const int index)
         {
             auto widget = dataset->widget();
             if (widget.toLower() == "y")
-                return dataset->value().toDouble();
+                return dataset->number();
         }
     }
 
@@ -308,7 +309,7 @@ double WidgetProvider::accelerometerZ(const int index)
         {
             auto widget = dataset->widget();
             if (widget.toLower() == "z")
-                return dataset->value().toDouble();
+                return dataset->number();
         }
     }
 
@@ -322,7 +323,7 @@ double WidgetProvider::bar(const int index)
 {
     auto bar = barDatasetAt(index);
     if (bar)
-        return bar->value().toDouble();
+        return bar->number();
 
     return DBL_MAX;
 }
@@ -334,7 +335,7 @@ double WidgetProvider::barMin(const int index)
 {
     auto bar = barDatasetAt(index);
     if (bar)
-        return bar->jsonData().value("min").toDouble();
+        return bar->min();
 
     return DBL_MAX;
 }
@@ -346,7 +347,7 @@ double WidgetProvider::barMax(const int index)
 {
     auto bar = barDatasetAt(index);
     if (bar)
-        return bar->jsonData().value("max").toDouble();
+        return bar->max();
 
     return DBL_MAX;
 }
@@ -364,7 +365,7 @@ double WidgetProvider::mapLatitude(const int index)
         {
             auto widget = dataset->widget();
             if (widget.toLower() == "lat")
-                return dataset->value().toDouble();
+                return dataset->number();
         }
     }
 
@@ -384,7 +385,7 @@ double WidgetProvider::mapLongitude(const int index)
         {
             auto widget = dataset->widget();
             if (widget.toLower() == "lon")
-                return dataset->value().toDouble();
+                return dataset->number();
         }
     }
 
@@ -407,7 +408,9 @@ void WidgetProvider::resetData()
 }
 
 /**
- * Regenerates the widget groups with the latest JSON-generated frame
+ * Regenerates the widget groups with the latest JSON-generated frame, this is only
+ * done when the structure of the frame changes (the values of the groups & datasets
+ * are updated in place by the @c DataProvider class).
  */
 void WidgetProvider::updateModels()
 {